@@ -0,0 +1,125 @@
+/**
+ * @file backlight.cpp
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <math.h>
+#include <stdio.h>
+#include <syslog.h>
+
+#include "backlight.h"
+
+/*********************
+ * GLOBAL FUNCTIONS
+ *********************/
+
+static float to_perceived(int level)
+{
+    return powf((float) level / BACKLIGHT_MAX, 1.0 / BACKLIGHT_GAMMA);
+}
+
+static int from_perceived(float perceived)
+{
+    return (int) (powf(perceived, BACKLIGHT_GAMMA) * BACKLIGHT_MAX + 0.5);
+}
+
+/*********************
+ * MEMBER FUNCTIONS
+ *********************/
+
+Backlight::Backlight() {
+    _scheduler = NULL;
+    _writeCallback = NULL;
+    _job = -1;
+    _level = 0;
+    _target = 0;
+    _start_perceived = 0.0;
+    _target_perceived = 0.0;
+    _fade_ticks = 0;
+    _fade_tick = 0;
+    _requests = 0;
+    _writes = 0;
+}
+
+Backlight::~Backlight() {
+    if (_requests > 0) {
+        syslog(LOG_INFO, "backlight: %lu level changes, %lu writes, %lu writes saved",
+            _requests, _writes, _requests - _writes);
+    }
+}
+
+void Backlight::init(Scheduler *scheduler, void (*writeCallback) (int), int level) {
+    _scheduler = scheduler;
+    _writeCallback = writeCallback;
+    _level = level;
+    _target = level;
+}
+
+void Backlight::setLevel(int level, uint32_t fade_ms) {
+    if (level < 0) level = 0;
+    if (level > BACKLIGHT_MAX) level = BACKLIGHT_MAX;
+    if (fade_ms == 0) {
+        _requests++;    // fade steps are counted when processed
+    }
+    _target = level;
+    // a new fade starts at the level written last
+    _start_perceived = to_perceived(_level);
+    _target_perceived = to_perceived(level);
+    _fade_ticks = fade_ms / BACKLIGHT_TICK_MS;
+    _fade_tick = 0;
+    if ((_job < 0) && (_scheduler != NULL)) {
+        _job = _scheduler->addJob("backlight", &tick, this, BACKLIGHT_TICK_MS, false);
+        if (_job < 0) {
+            write(level);   // no scheduler job available, write immediately
+        }
+    }
+}
+
+int Backlight::getLevel(void) {
+    return _level;
+}
+
+bool Backlight::isBusy(void) {
+    return _job >= 0;
+}
+
+/*********************
+ * PRIVATE FUNCTIONS
+ *********************/
+
+void Backlight::tick(void *arg) {
+    ((Backlight*) arg)->process();
+}
+
+/**
+ * Write the level for the current tick, stop the job at the fade end
+ */
+void Backlight::process(void) {
+    int level = _target;
+    if (_fade_tick < _fade_ticks) {
+        _fade_tick++;
+        _requests++;
+        if (_fade_tick < _fade_ticks) {     // the last step is the exact target
+            float t = (float) _fade_tick / _fade_ticks;
+            level = from_perceived(_start_perceived + (_target_perceived - _start_perceived) * t);
+        }
+    }
+    if (level != _level) {
+        write(level);
+    }
+    if ((_fade_tick >= _fade_ticks) && (_level == _target)) {
+        _scheduler->removeJob(_job);
+        _job = -1;
+    }
+}
+
+void Backlight::write(int level) {
+    _level = level;
+    _writes++;
+    if (_writeCallback != NULL) {
+        (*_writeCallback) (level);
+    }
+}
@@ -0,0 +1,82 @@
+/**
+ * @file backlight.h
+ *
+ -----------------------------------------------------------------------------
+ The Backlight class controls the display backlight level.
+
+ A new level is never written directly. A scheduler job running at a fixed
+ cadence (BACKLIGHT_TICK_MS) writes at most one level per tick, so fast
+ slider movements are coalesced. Fades are interpolated in perceived
+ brightness (gamma corrected), the job only runs while a change is pending.
+
+ The level is written through a callback which must not block, e.g. a
+ function posting the write to the worker pool.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef BACKLIGHT_H
+#define BACKLIGHT_H
+
+#include <stdint.h>
+
+#include "scheduler.h"
+
+#define BACKLIGHT_TICK_MS SCHEDULER_TICK_MS     // write cadence
+#define BACKLIGHT_MAX 255           // maximum backlight level
+#define BACKLIGHT_GAMMA 2.2         // perceived brightness = level ^ (1 / gamma)
+#define BACKLIGHT_FADE_OUT 1500     // ms, screen saver fade
+#define BACKLIGHT_FADE_IN 300       // ms, wake up fade
+
+class Backlight {
+public:
+    // Constructor
+    Backlight();
+
+    // Destructor
+    ~Backlight();
+
+    /**
+     * Initialise the controller
+     * @param scheduler: scheduler running the fade job
+     * @param writeCallback: writes a level to the hardware (must not block)
+     * @param level: the current backlight level
+     */
+    void init(Scheduler *scheduler, void (*writeCallback) (int), int level);
+
+    /**
+     * Set a new backlight level
+     * @param level: new level 0 - BACKLIGHT_MAX
+     * @param fade_ms: fade time, 0 = next tick
+     */
+    void setLevel(int level, uint32_t fade_ms = 0);
+
+    /**
+     * Get the last level written
+     */
+    int getLevel(void);
+
+    /**
+     * Check if a change is pending
+     */
+    bool isBusy(void);
+
+private:
+    static void tick(void *arg);
+    void process(void);
+    void write(int level);
+
+    Scheduler *_scheduler;
+    void (*_writeCallback) (int);
+    int _job;                       // scheduler job ID, -1 = not running
+    int _level;                     // last level written
+    int _target;                    // level at the end of the fade
+    float _start_perceived;         // perceived brightness at the fade start
+    float _target_perceived;        // perceived brightness at the fade end
+    uint32_t _fade_ticks;           // fade length in ticks
+    uint32_t _fade_tick;            // current tick of the fade
+    // statistics, reported on exit
+    unsigned long _requests;        // level changes requested (incl. fade steps)
+    unsigned long _writes;          // levels written
+};
+
+#endif /* BACKLIGHT_H */
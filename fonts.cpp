@@ -0,0 +1,137 @@
+/**
+ * @file fonts.cpp
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <syslog.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "fonts.h"
+
+using namespace std;
+
+/*********************
+ * MEMBER FUNCTIONS
+ *********************/
+
+FontSet::FontSet() {
+}
+
+FontSet::~FontSet() {
+    close();
+}
+
+bool FontSet::load(const char *configFile) {
+    FILE *fp = fopen(configFile, "r");
+    if (fp == NULL) {
+        fprintf(stderr, "%s: failed to open font configuration %s, using the built-in fonts\n", __func__, configFile);
+        syslog(LOG_WARNING, "failed to open font configuration %s", configFile);
+        return false;
+    }
+    string config = configFile;
+    size_t slash = config.rfind('/');
+    string dir = (slash == string::npos) ? "" : config.substr(0, slash + 1);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    lv_mem_monitor_t mem_start, mem_end;
+    lv_mem_monitor(&mem_start);
+
+    char line[256];
+    int line_no = 0;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        char file[200];
+        int size;
+        line_no++;
+        char *p = line + strspn(line, " \t");
+        if ((*p == '#') || (*p == '\n') || (*p == 0)) continue;
+        if (sscanf(p, "%d %199s", &size, file) != 2) {
+            fprintf(stderr, "%s: %s:%d invalid font, expected <size> <file>\n", __func__, configFile, line_no);
+            continue;
+        }
+        loadFile(size, (file[0] == '/') ? string(file) : dir + file);
+    }
+    fclose(fp);
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    lv_mem_monitor(&mem_end);
+    size_t mapped = 0;
+    for (size_t i = 0; i < _fonts.size(); i++) mapped += _fonts[i].map_size;
+    syslog(LOG_INFO, "Fonts: %zu loaded from %s", _fonts.size(), configFile);
+    syslog(LOG_DEBUG, "Fonts: loaded in %.3fms, %zukB mapped, %u bytes of descriptors",
+        ((end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9) * 1000, mapped / 1024,
+        (unsigned) (mem_start.free_size - mem_end.free_size));
+    return true;
+}
+
+const lv_font_t *FontSet::get(int size, const lv_font_t *builtin) {
+    for (size_t i = 0; i < _fonts.size(); i++) {
+        if (_fonts[i].size == size) return _fonts[i].font;
+    }
+    return builtin;
+}
+
+void FontSet::close(void) {
+    for (size_t i = 0; i < _fonts.size(); i++) {
+        lv_font_free_bin(_fonts[i].font);
+        munmap(_fonts[i].map, _fonts[i].map_size);
+    }
+    _fonts.clear();
+}
+
+/*********************
+ * PRIVATE FUNCTIONS
+ *********************/
+
+/**
+ * Map a binary font file and create the font of a text size, replaces a font loaded before for the size
+ */
+bool FontSet::loadFile(int size, const string &path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "%s: failed to open font %s\n", __func__, path.c_str());
+        syslog(LOG_WARNING, "failed to open font %s", path.c_str());
+        return false;
+    }
+    struct stat st;
+    void *map = MAP_FAILED;
+    if ((fstat(fd, &st) == 0) && (st.st_size > 0) && ((uint64_t) st.st_size <= UINT32_MAX)) {
+        // shared read only mapping, the pages are read on demand and can be dropped under memory pressure
+        map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "%s: failed to map font %s\n", __func__, path.c_str());
+        return false;
+    }
+
+    lv_font_t *font = lv_font_load_bin(map, st.st_size);
+    if (font == NULL) {
+        fprintf(stderr, "%s: invalid font %s\n", __func__, path.c_str());
+        syslog(LOG_WARNING, "invalid font %s", path.c_str());
+        munmap(map, st.st_size);
+        return false;
+    }
+
+    font_file_t f = {size, font, map, (size_t) st.st_size};
+    for (size_t i = 0; i < _fonts.size(); i++) {
+        if (_fonts[i].size == size) {
+            lv_font_free_bin(_fonts[i].font);
+            munmap(_fonts[i].map, _fonts[i].map_size);
+            _fonts[i] = f;
+            return true;
+        }
+    }
+    _fonts.push_back(f);
+    return true;
+}
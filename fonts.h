@@ -0,0 +1,77 @@
+/**
+ * @file fonts.h
+ *
+ -----------------------------------------------------------------------------
+ Fonts loaded at startup from LVGL binary font files (lv_font_conv
+ --format bin) instead of the fonts compiled into the program.
+
+ The files are memory mapped read only and the pages are shared with other
+ processes. Only the glyph descriptors are decoded into the LVGL heap, but
+ their headers are spread over the glyph table so loading reads almost all
+ pages of a file once. The pages are clean and can be dropped under memory
+ pressure, the bitmaps are read again when drawn. Compressed bitmaps are
+ checked against their glyph when drawn.
+
+ The configuration file selects the font of a text size, one per line:
+   <size> <file>            e.g. 24 /usr/local/share/homescr1/montserrat-24.bin
+ The sizes are the ones of the screen styles, 16 is the theme font.
+ A font converted with a subset of the characters (lv_font_conv -r or
+ --symbols) only needs the letters shown on the screen. Relative file names
+ are relative to the directory of the configuration file. Empty lines and
+ lines starting with '#' are ignored.
+ Sizes without a loadable file use the built-in fonts.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef FONTS_H
+#define FONTS_H
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+#include "lvgl.h"
+
+class FontSet {
+public:
+    // Constructor
+    FontSet();
+
+    // Destructor
+    ~FontSet();
+
+    /**
+     * Load the fonts of a configuration file, LVGL must be initialised
+     * @param configFile: configuration file
+     * @returns true if the configuration was read, fonts which can't be loaded are skipped
+     */
+    bool load(const char *configFile);
+
+    /**
+     * Get the font of a text size
+     * @param size: text size of the configuration file
+     * @param builtin: font to use if no font file is loaded for the size
+     * @returns the loaded font or builtin
+     */
+    const lv_font_t *get(int size, const lv_font_t *builtin);
+
+    /**
+     * Free the fonts and unmap the files, the fonts must not be drawn anymore
+     */
+    void close(void);
+
+private:
+    typedef struct {
+        int size;
+        lv_font_t *font;
+        void *map;
+        size_t map_size;
+    } font_file_t;
+
+    bool loadFile(int size, const std::string &path);
+
+    std::vector<font_file_t> _fonts;
+};
+
+#endif /* FONTS_H */
@@ -7,7 +7,13 @@
  *      INCLUDES
  *********************/
 #include <sys/utsname.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stddef.h>
@@ -16,6 +22,7 @@
 #include <string.h>
 #include <time.h>
 #include <unistd.h>
+#include <syslog.h>
 
 #include "hardware.h"
 #include "datatag.h"
@@ -27,53 +34,110 @@
 #define CPU_TEMP "/sys/class/thermal/thermal_zone0/temp"
 #define OS_NAME_PATH "/etc/os-release"
 #define MODEL_NAME_PATH "/proc/device-tree/model"
-#define TOUCH_INPUT_PATH "/dev/input/event0"
 #define SCREEN_SAVER_TIME 30      // in s
+#define NETLINK_DUMP_TIMEOUT 500    // in ms, initial address list
 
-int touch_fd = -1;
 time_t screen_timout;
 bool screen_saver_active = false;
 
+/**
+ * Parse a decimal integer (e.g. sysfs attribute) without sscanf
+ * leading white space and a trailing newline are accepted
+ * returns true on success
+ */
+static bool parse_int(const char *buf, int length, long *value)
+{
+    int i = 0;
+    bool negative = false;
+    long result = 0;
+    while ((i < length) && ((buf[i] == ' ') || (buf[i] == '\t'))) i++;
+    if ((i < length) && ((buf[i] == '-') || (buf[i] == '+'))) {
+        negative = (buf[i] == '-');
+        i++;
+    }
+    int start = i;
+    while ((i < length) && (buf[i] >= '0') && (buf[i] <= '9')) {
+        result = result * 10 + (buf[i] - '0');
+        i++;
+    }
+    if (i == start) return false;     // no digits
+    *value = negative ? -result : result;
+    return true;
+}
+
+/**
+ * Format a non negative integer, returns the string length
+ */
+static int format_int(char *buf, int value)
+{
+    char tmp[12];
+    int length = 0;
+    if (value < 0) value = 0;
+    do {
+        tmp[length++] = '0' + value % 10;
+        value /= 10;
+    } while (value > 0);
+    for (int i = 0; i < length; i++) {
+        buf[i] = tmp[length - 1 - i];
+    }
+    return length;
+}
+
 Hardware::Hardware()
 {
     //fprintf(stderr, "%s: Constructor called\n", __func__);
-    touch_fd = -1;
     screen_saver_active = false;
+    last_brightness = -1;
+    sysfs_calls = 0;
+    sysfs_syscalls = 0;
+    brightness_skipped = 0;
+    netlink_fd = -1;
+    net_dump_pending = false;
+    net_resync = false;
+    // open sysfs attributes for the lifetime of this object
+    brightness_fd = -1;
+    cpu_temp_fd = -1;
+    open_sysfs(&brightness_fd, BRIGTHNESS_CONTROL, O_RDWR);
+    open_sysfs(&cpu_temp_fd, CPU_TEMP, O_RDONLY);
     // preset screen saver timeout
     time_t now = time(NULL);
     screen_timout = now + SCREEN_SAVER_TIME;
-
-    // open touch screen input for screen saver
-    touch_fd = open(TOUCH_INPUT_PATH, O_RDONLY | O_NONBLOCK);
-    if (touch_fd == -1) {
-        printf("Failed to open Touch Input\n");
-    }
 }
 
 Hardware::~Hardware() {
   //fprintf(stderr, "%s: Destructor called\n", __func__);
+    if (brightness_fd >= 0) close(brightness_fd);
+    if (cpu_temp_fd >= 0) close(cpu_temp_fd);
+    if (netlink_fd >= 0) close(netlink_fd);
+    if (sysfs_calls > 0) {
+        syslog(LOG_INFO, "sysfs: %lu calls, %.2f syscalls per call, %lu brightness writes skipped",
+            (unsigned long) sysfs_calls, (double) sysfs_syscalls / sysfs_calls, (unsigned long) brightness_skipped);
+    }
 }
 
-void Hardware::process_screen_saver(int brightness)
+bool Hardware::process_screen_saver(bool touched)
 {
-    char buffer[256];
-    if (touch_fd <= 0) return;
-    int length = read(touch_fd, buffer, sizeof(buffer));
     time_t now = time(NULL);
-    if (length > 0) {   // Touch detected
+    if (touched) {   // Touch detected
         screen_timout = now + SCREEN_SAVER_TIME;
         if (screen_saver_active) {      // disable screen saver
-            set_brightness(brightness);
             screen_saver_active = false;
+            return true;
         }
     } else {    // No Touch
         if (!screen_saver_active) {
             if (now > screen_timout) {
-                set_brightness(0);
                 screen_saver_active = true;
+                return true;
             }
         }
     }
+    return false;
+}
+
+bool Hardware::is_screen_saver_active(void)
+{
+    return screen_saver_active;
 }
 
 int Hardware::shutdown(bool reboot)
@@ -90,28 +154,175 @@ int Hardware::shutdown(bool reboot)
 
 int Hardware::get_ip_address(char *buffer, int maxlen)
 {
-    char buf[40];
-    char data[128];
-    FILE *pf;
-    int length = -1;
+    // same format as "hostname -I" (IPV4 + IPV6)
+    std::string data;
+    for (size_t i = 0; i < net_addresses.size(); i++) {
+        if (i > 0) data += " ";
+        data += net_addresses[i].address;
+    }
+    int length = data.length();
+    if (length < maxlen) {
+        strcpy(buffer, data.c_str());
+    } else {
+        strncpy(buffer, data.c_str(), maxlen);
+        buffer[maxlen-1] = 0;
+        length = maxlen;
+    }
+    return length;
+}
+
+bool Hardware::open_network(void)
+{
+    struct sockaddr_nl addr;
+
+    netlink_fd = socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (netlink_fd < 0) {
+        syslog(LOG_ERR, "Failed to open netlink socket");
+        return false;
+    }
+    // subscribe to address change notifications
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR;
+    if (bind(netlink_fd, (struct sockaddr *) &addr, sizeof(addr)) < 0) {
+        syslog(LOG_ERR, "Failed to bind netlink socket");
+        close(netlink_fd);
+        netlink_fd = -1;
+        return false;
+    }
+    // request the current address list
+    if (!request_addresses()) {
+        syslog(LOG_ERR, "Failed to request address list");
+        close(netlink_fd);
+        netlink_fd = -1;
+        return false;
+    }
+    // the kernel answers the dump immediately, wait for it to complete
+    bool done = false;
+    struct pollfd pfd;
+    pfd.fd = netlink_fd;
+    pfd.events = POLLIN;
+    while (!done && (poll(&pfd, 1, NETLINK_DUMP_TIMEOUT) > 0)) {
+        read_netlink(&done);
+    }
+    return done;
+}
+
+bool Hardware::process_network(void)
+{
+    if (netlink_fd < 0) return false;
+    bool changed = read_netlink(NULL);
+    // the kernel refuses a new dump while one is running, retry on the next call
+    if (net_resync && !net_dump_pending && request_addresses()) {
+        net_resync = false;
+    }
+    return changed;
+}
+
+/**
+ * Request a dump of all addresses, net_addresses is replaced when it is complete
+ * returns true if the request was sent
+ */
+bool Hardware::request_addresses(void)
+{
+    struct {
+        struct nlmsghdr nlh;
+        struct ifaddrmsg ifa;
+    } req;
 
-    // Read IP address (IPV4 + IPV6)
-    sprintf(buf, "hostname -I");
-    pf = popen(buf,"r");
-    if (pf != NULL) {
-        fgets(data, sizeof(data) , pf);
-        pclose(pf);
-        length = strlen(data);
-        data[length-1] = 0;
-        if (strlen(data) <= (unsigned)maxlen) {
-            strcpy(buffer, data);
-        } else {
-            strncpy(buffer, data, maxlen);
-            buffer[maxlen-1] = 0;
-            length = maxlen;
+    memset(&req, 0, sizeof(req));
+    req.nlh.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifaddrmsg));
+    req.nlh.nlmsg_type = RTM_GETADDR;
+    req.nlh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    req.ifa.ifa_family = AF_UNSPEC;
+    if (send(netlink_fd, &req, req.nlh.nlmsg_len, 0) < 0) return false;
+    net_dump.clear();
+    net_dump_pending = true;
+    return true;
+}
+
+/**
+ * Read and process all pending netlink messages
+ * done: set to true when the end of a dump has been received (can be NULL)
+ * returns true if the address list has changed
+ */
+bool Hardware::read_netlink(bool *done)
+{
+    char buffer[8192] __attribute__ ((aligned(__alignof__(struct nlmsghdr))));
+    char text[INET6_ADDRSTRLEN];
+    bool changed = false;
+    ssize_t length;
+
+    while ((length = recv(netlink_fd, buffer, sizeof(buffer), 0)) > 0) {
+        struct nlmsghdr *nlh = (struct nlmsghdr *) buffer;
+        for (; NLMSG_OK(nlh, (size_t) length); nlh = NLMSG_NEXT(nlh, length)) {
+            if (nlh->nlmsg_type == NLMSG_ERROR) {
+                // error 0 is an acknowledgement, anything else ends the dump without the addresses
+                struct nlmsgerr *err = (struct nlmsgerr *) NLMSG_DATA(nlh);
+                if ((nlh->nlmsg_len >= NLMSG_LENGTH(sizeof(struct nlmsgerr))) && (err->error != 0)) {
+                    fprintf(stderr, "%s: netlink request failed: %s\n", __func__, strerror(-err->error));
+                    syslog(LOG_ERR, "netlink request failed: %s", strerror(-err->error));
+                }
+                net_dump_pending = false;
+                if (done != NULL) *done = true;
+                continue;
+            }
+            if (nlh->nlmsg_type == NLMSG_DONE) {
+                if (net_dump_pending) {
+                    net_dump_pending = false;
+                    bool same = (net_dump.size() == net_addresses.size());
+                    for (size_t i = 0; same && (i < net_dump.size()); i++) {
+                        same = (net_dump[i].ifindex == net_addresses[i].ifindex) &&
+                            (net_dump[i].address == net_addresses[i].address);
+                    }
+                    if (!same) {
+                        net_addresses.swap(net_dump);
+                        changed = true;
+                    }
+                }
+                if (done != NULL) *done = true;
+                continue;
+            }
+            if ((nlh->nlmsg_type != RTM_NEWADDR) && (nlh->nlmsg_type != RTM_DELADDR)) continue;
+            struct ifaddrmsg *ifa = (struct ifaddrmsg *) NLMSG_DATA(nlh);
+            // like "hostname -I" omit loopback and link local addresses
+            if ((ifa->ifa_scope == RT_SCOPE_HOST) || (ifa->ifa_scope == RT_SCOPE_LINK)) continue;
+            // IFA_LOCAL is the local address on point to point links
+            void *ifa_addr = NULL;
+            struct rtattr *rta = IFA_RTA(ifa);
+            int rta_len = IFA_PAYLOAD(nlh);
+            for (; RTA_OK(rta, rta_len); rta = RTA_NEXT(rta, rta_len)) {
+                if ((rta->rta_type == IFA_LOCAL) || ((rta->rta_type == IFA_ADDRESS) && (ifa_addr == NULL))) {
+                    ifa_addr = RTA_DATA(rta);
+                }
+            }
+            if (ifa_addr == NULL) continue;
+            if (inet_ntop(ifa->ifa_family, ifa_addr, text, sizeof(text)) == NULL) continue;
+
+            // while a dump is pending notifications go to its list too, it replaces the current one
+            std::vector<net_address_t> &list = net_dump_pending ? net_dump : net_addresses;
+            size_t i;
+            for (i = 0; i < list.size(); i++) {
+                if ((list[i].ifindex == (int) ifa->ifa_index) && (list[i].address == text)) break;
+            }
+            if (nlh->nlmsg_type == RTM_NEWADDR) {
+                if (i == list.size()) {
+                    list.push_back({ (int) ifa->ifa_index, text });
+                    changed |= !net_dump_pending;
+                }
+            } else if (i < list.size()) {
+                list.erase(list.begin() + i);
+                changed |= !net_dump_pending;
+            }
         }
     }
-    return length;
+    if ((length < 0) && (errno == ENOBUFS)) {
+        // the socket overran and notifications were lost, read the whole list again
+        syslog(LOG_WARNING, "netlink socket overrun, requesting the address list again");
+        net_resync = true;
+        net_dump_pending = false;
+    }
+    return changed;
 }
 
 int Hardware::get_model_name(char *buffer, int maxlen)
@@ -166,18 +377,25 @@ int Hardware::get_kernel_name(char *buffer, int maxlen)
 
 /**
  * Set screen brightness
+ * writes of an unchanged value are skipped
  */
 bool Hardware::set_brightness(int new_brightness)
 {
-    char buffer[80];
-    int brightness_fd;
+    char buffer[16];
 
-    brightness_fd = open(BRIGTHNESS_CONTROL, O_RDWR);
-    if (brightness_fd != -1) {
-        sprintf(buffer,"%d", new_brightness);
-        write(brightness_fd, buffer, strlen(buffer));
-        close(brightness_fd);
-    } else {
+    sysfs_calls++;
+    if (last_brightness.exchange(new_brightness) == new_brightness) {
+        brightness_skipped++;
+        return true;
+    }
+    if (open_sysfs(&brightness_fd, BRIGTHNESS_CONTROL, O_RDWR) < 0) {
+        last_brightness = -1;
+        return false;
+    }
+    int length = format_int(buffer, new_brightness);
+    sysfs_syscalls++;
+    if (pwrite(brightness_fd, buffer, length, 0) != length) {
+        last_brightness = -1;       // unknown state, write again next time
         return false;
     }
     //printf("Brightness: %d\n", new_brightness);
@@ -190,17 +408,12 @@ bool Hardware::set_brightness(int new_brightness)
  */
 int Hardware::get_brightness(void)
 {
-    char buffer[80];
-    int fd;
-    int length;
-    int value = -1;
-    fd = open(BRIGTHNESS_CONTROL, O_RDONLY | O_NONBLOCK);
-    if (fd != -1) {
-        length = read(fd, buffer, sizeof(buffer));
-        buffer[length] = 0;
-        sscanf(buffer, "%d", &value);
-        close(fd);
+    long value;
+    sysfs_calls++;
+    if (read_sysfs_int(&brightness_fd, BRIGTHNESS_CONTROL, O_RDWR, &value) < 0) {
+        return -1;
     }
+    last_brightness = value;
     return value;
 }
 
@@ -209,16 +422,41 @@ int Hardware::get_brightness(void)
  */
 float Hardware::read_cpu_temp(void)
 {
-    char buffer[80];
-    float retval = 0.0;
-    int fd = open(CPU_TEMP, O_RDONLY | O_NONBLOCK);
-    if (fd != -1) {
-        int length = read(fd, buffer, sizeof(buffer));
-        buffer[length] = 0;
-        sscanf(buffer, "%f", &retval);
-        retval = retval / 1000.0;
-        close(fd);
+    long value;
+    sysfs_calls++;
+    if (read_sysfs_int(&cpu_temp_fd, CPU_TEMP, O_RDONLY, &value) < 0) {
+        return 0.0;
     }
+    return value / 1000.0;      // value is in milli DegC
+}
 
-    return retval;
+/**
+ * Open a sysfs attribute if it is not open yet
+ * returns the file descriptor or -1 on failure
+ */
+int Hardware::open_sysfs(int *fd, const char *path, int flags)
+{
+    if (*fd < 0) {
+        sysfs_syscalls++;
+        *fd = open(path, flags | O_CLOEXEC);
+    }
+    return *fd;
+}
+
+/**
+ * Read an integer sysfs attribute from offset 0
+ * returns 0 on success, -1 on failure
+ */
+int Hardware::read_sysfs_int(int *fd, const char *path, int flags, long *value)
+{
+    char buffer[32];
+    if (open_sysfs(fd, path, flags) < 0) {
+        return -1;
+    }
+    sysfs_syscalls++;
+    int length = pread(*fd, buffer, sizeof(buffer), 0);
+    if (length <= 0) {
+        return -1;
+    }
+    return parse_int(buffer, length, value) ? 0 : -1;
 }
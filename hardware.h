@@ -4,6 +4,7 @@
  -----------------------------------------------------------------------------
  This class provides access to various hardware and OS related information.
  It also handles the screen saver and system shutdown functions.
+ Touch input for the screen saver is provided by the TouchInput class.
  -----------------------------------------------------------------------------
  */
 
@@ -12,6 +13,10 @@
 
 #include <time.h>
 
+#include <atomic>
+#include <string>
+#include <vector>
+
 class Hardware {
 public:
     // Constructor
@@ -22,9 +27,17 @@ public:
 
     /**
      * Process the screen saver
-     * @param brightness: The current brightness setting when there screen saver is not active
+     * The backlight is controlled by the caller (see Backlight)
+     * @param touched: true if the screen has been touched since the last call
+     * @returns true if the screen saver has been activated or deactivated
+     */
+    bool process_screen_saver(bool touched);
+
+    /**
+     * Check if the screen saver has blanked the display
+     * @returns true if the screen saver is active
      */
-    void process_screen_saver(int brightness);
+    bool is_screen_saver_active(void);
 
     /**
      * Shutdown and Reboot the system
@@ -71,15 +84,51 @@ public:
 
     /**
      * Read active IP address
+     * The addresses are maintained by process_network, no process is spawned
      * @param buffer: text storage buffer
      * @param maxlen: length of text storage buffer
      */
     int get_ip_address(char *buffer, int maxlen);
 
+    /**
+     * Open the rtnetlink socket and read the initial address list
+     * @returns true on success
+     */
+    bool open_network(void);
+
+    /**
+     * Process pending address change notifications (non blocking)
+     * @returns true if the address list has changed
+     */
+    bool process_network(void);
+
 private:
-    int touch_fd;               // file descriptor for touch input
+    typedef struct {
+        int ifindex;                // interface index
+        std::string address;        // address in text form
+    } net_address_t;
+
+    int open_sysfs(int *fd, const char *path, int flags);
+    int read_sysfs_int(int *fd, const char *path, int flags, long *value);
+    bool read_netlink(bool *done);
+    bool request_addresses(void);
+
     time_t screen_timout;       // screen saver timeout
     bool screen_saver_active;   //
+    // sysfs attributes are kept open and accessed with pread/pwrite
+    int brightness_fd;          // file descriptor for backlight brightness
+    int cpu_temp_fd;            // file descriptor for CPU temperature
+    std::atomic<int> last_brightness;   // last value written, -1 = unknown
+    // statistics, reported on exit
+    std::atomic<unsigned long> sysfs_calls;     // brightness / temperature calls
+    std::atomic<unsigned long> sysfs_syscalls;  // system calls made by these
+    std::atomic<unsigned long> brightness_skipped;  // unchanged values not written
+    // network addresses
+    int netlink_fd;             // rtnetlink socket for address changes
+    std::vector<net_address_t> net_addresses;
+    std::vector<net_address_t> net_dump;    // addresses collected by a pending dump
+    bool net_dump_pending;      // a dump was requested, net_addresses is replaced at its end
+    bool net_resync;            // notifications were lost, request a new dump
 
 };
 
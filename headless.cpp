@@ -0,0 +1,229 @@
+/**
+ * @file headless.cpp
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <syslog.h>
+#include <time.h>
+
+#include "headless.h"
+
+using namespace std;
+
+/*********************
+ * GLOBAL FUNCTIONS
+ *********************/
+
+static uint64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/*********************
+ * MEMBER FUNCTIONS
+ *********************/
+
+HeadlessDisplay::HeadlessDisplay(const char *dumpDir, int dumpMode) {
+    _frame = NULL;
+    _width = 0;
+    _height = 0;
+    _dir = (dumpDir && dumpDir[0]) ? dumpDir : ".";
+    _mode = dumpMode;
+    _frames = 0;
+    _px = 0;
+    _dumps = 0;
+    _dump_time_us = 0;
+}
+
+HeadlessDisplay::~HeadlessDisplay() {
+    free(_frame);
+    if (_frames > 0) {
+        printf("Headless: %lu frames, %llu px/frame, %lu dumps, avg %.3fms/dump\n", _frames,
+            (unsigned long long) (_px / _frames), _dumps, _dumps ? _dump_time_us / 1000.0 / _dumps : 0.0);
+        syslog(LOG_INFO, "headless: %lu frames, %lu dumps", _frames, _dumps);
+    }
+}
+
+bool HeadlessDisplay::init(lv_disp_drv_t *drv) {
+    _width = drv->hor_res;
+    _height = drv->ver_res;
+    _frame = (lv_color_t*) calloc(_width * _height, sizeof(lv_color_t));
+    if (_frame == NULL) {
+        fprintf(stderr, "%s: failed to allocate the frame\n", __func__);
+        return false;
+    }
+    drv->flush_cb = &flush;
+    drv->user_data = this;
+    printf("Headless display %dx%d, dumps to %s\n", _width, _height, _dir.c_str());
+    return true;
+}
+
+bool HeadlessDisplay::dump(const char *name) {
+    lv_area_t area = {0, 0, (lv_coord_t) (_width - 1), (lv_coord_t) (_height - 1)};
+    return write_ppm(_dir + "/" + name + ".ppm", &area);
+}
+
+/*********************
+ * PRIVATE FUNCTIONS
+ *********************/
+
+/**
+ * LVGL flush callback, copies the rendered area into the frame
+ */
+void HeadlessDisplay::flush(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p) {
+    HeadlessDisplay *display = (HeadlessDisplay*) drv->user_data;
+    display->copy(area, color_p);
+    if (lv_disp_flush_is_last(drv)) {
+        display->frame_done();
+    }
+    lv_disp_flush_ready(drv);
+}
+
+void HeadlessDisplay::copy(const lv_area_t *area, const lv_color_t *color_p) {
+    lv_area_t act;
+    lv_area_t scr = {0, 0, (lv_coord_t) (_width - 1), (lv_coord_t) (_height - 1)};
+    if (!_lv_area_intersect(&act, area, &scr)) return;
+    lv_coord_t src_w = lv_area_get_width(area);
+    const lv_color_t *src = color_p + (act.y1 - area->y1) * src_w + (act.x1 - area->x1);
+    size_t len = lv_area_get_width(&act) * sizeof(lv_color_t);
+    for (lv_coord_t y = act.y1; y <= act.y2; y++) {
+        memcpy(&_frame[y * _width + act.x1], src, len);
+        src += src_w;
+    }
+    _px += lv_area_get_size(&act);
+}
+
+/**
+ * Called after the last area of a refresh has been copied
+ */
+void HeadlessDisplay::frame_done(void) {
+    char name[64];
+    _frames++;
+    if (_mode == HEADLESS_DUMP_FRAMES) {
+        snprintf(name, sizeof(name), "frame%05lu", _frames);
+        dump(name);
+    } else if (_mode == HEADLESS_DUMP_RECTS) {
+        // the invalidated areas of the refresh in progress
+        lv_disp_t *disp = _lv_refr_get_disp_refreshing();
+        for (uint16_t i = 0; i < disp->inv_p; i++) {
+            if (disp->inv_area_joined[i]) continue;
+            const lv_area_t *a = &disp->inv_areas[i];
+            snprintf(name, sizeof(name), "/frame%05lu_%d_%d_%dx%d.ppm", _frames,
+                a->x1, a->y1, lv_area_get_width(a), lv_area_get_height(a));
+            write_ppm(_dir + name, a);
+        }
+    }
+}
+
+/**
+ * Write an area of the frame as binary PPM (P6)
+ */
+bool HeadlessDisplay::write_ppm(const string &path, const lv_area_t *area) {
+    uint64_t start = now_us();
+    FILE *fp = fopen(path.c_str(), "wb");
+    if (fp == NULL) {
+        fprintf(stderr, "%s: failed to create %s\n", __func__, path.c_str());
+        return false;
+    }
+    lv_coord_t w = lv_area_get_width(area);
+    vector<uint8_t> row(w * 3);
+    fprintf(fp, "P6\n%d %d\n255\n", w, lv_area_get_height(area));
+    for (lv_coord_t y = area->y1; y <= area->y2; y++) {
+        const lv_color_t *src = &_frame[y * _width + area->x1];
+        for (lv_coord_t x = 0; x < w; x++) {
+            lv_color32_t c;
+            c.full = lv_color_to32(src[x]);
+            row[x * 3] = c.ch.red;
+            row[x * 3 + 1] = c.ch.green;
+            row[x * 3 + 2] = c.ch.blue;
+        }
+        fwrite(row.data(), 1, row.size(), fp);
+    }
+    bool ok = (fclose(fp) == 0);
+    _dumps++;
+    _dump_time_us += now_us() - start;
+    return ok;
+}
+
+TouchScript::TouchScript() {
+    _next = 0;
+    _x = 0;
+    _y = 0;
+}
+
+bool TouchScript::load(const char *path) {
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        fprintf(stderr, "%s: failed to open touch script %s\n", __func__, path);
+        return false;
+    }
+    char line[256];
+    int line_no = 0;
+    bool ok = true;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        char cmd[16], arg[128];
+        unsigned long time_ms;
+        int x, y;
+        line_no++;
+        char *p = line + strspn(line, " \t");
+        if ((*p == '#') || (*p == '\n') || (*p == 0)) continue;
+        int n = sscanf(p, "%lu %15s %127s", &time_ms, cmd, arg);
+        step_t step;
+        step.time_ms = time_ms;
+        step.x = 0;
+        step.y = 0;
+        if ((n >= 2) && ((strcmp(cmd, "down") == 0) || (strcmp(cmd, "move") == 0)) &&
+                (sscanf(p, "%*u %*s %d %d", &x, &y) == 2)) {
+            step.type = STEP_DOWN;
+            step.x = x;
+            step.y = y;
+        } else if ((n >= 2) && (strcmp(cmd, "up") == 0)) {
+            step.type = STEP_UP;
+        } else if ((n == 3) && (strcmp(cmd, "dump") == 0)) {
+            step.type = STEP_DUMP;
+            step.name = arg;
+        } else if ((n >= 2) && (strcmp(cmd, "exit") == 0)) {
+            step.type = STEP_EXIT;
+        } else {
+            fprintf(stderr, "%s: %s:%d invalid step\n", __func__, path, line_no);
+            ok = false;
+            break;
+        }
+        _steps.push_back(step);
+    }
+    fclose(fp);
+    if (!ok) _steps.clear();
+    _next = 0;
+    return ok;
+}
+
+bool TouchScript::process(uint32_t time_ms, TouchInput *touch, HeadlessDisplay *display) {
+    while ((_next < _steps.size()) && (_steps[_next].time_ms <= time_ms)) {
+        const step_t *s = &_steps[_next++];
+        switch (s->type) {
+            case STEP_DOWN:
+                _x = s->x;
+                _y = s->y;
+                touch->inject(_x, _y, true);
+                break;
+            case STEP_UP:
+                touch->inject(_x, _y, false);
+                break;
+            case STEP_DUMP:
+                if (display != NULL) display->dump(s->name.c_str());
+                break;
+            case STEP_EXIT:
+                _next = _steps.size();
+                break;
+        }
+    }
+    return _next < _steps.size();
+}
@@ -0,0 +1,126 @@
+/**
+ * @file headless.h
+ *
+ -----------------------------------------------------------------------------
+ Headless operation without display, touch screen or MQTT broker, used for
+ profiling and pixel-diff tests on a build machine.
+
+ The HeadlessDisplay class is an LVGL display driver rendering into a frame
+ held in memory. Frames are written as binary PPM files (P6):
+ - on request, e.g. a "dump" step of a touch script
+ - every refreshed frame (HEADLESS_DUMP_FRAMES)
+ - the areas refreshed in every frame (HEADLESS_DUMP_RECTS)
+
+ The TouchScript class plays a synthetic touch sequence from a text file,
+ one step per line, time in ms since the start:
+   <ms> down <x> <y>        press (or move while pressed) at screen pixels
+   <ms> move <x> <y>        same as down
+   <ms> up                  release at the last position
+   <ms> dump <name>         write the current frame to <dir>/<name>.ppm
+   <ms> exit                end of the script
+ Empty lines and lines starting with '#' are ignored.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "lvgl.h"
+#include "touch.h"
+
+#define HEADLESS_DUMP_NONE 0        // dump frames on request only
+#define HEADLESS_DUMP_FRAMES 1      // dump every frame
+#define HEADLESS_DUMP_RECTS 2       // dump the refreshed areas of every frame
+
+class HeadlessDisplay {
+public:
+    /**
+     * Constructor
+     * @param dumpDir: directory for the PPM files
+     * @param dumpMode: HEADLESS_DUMP_xxx
+     */
+    HeadlessDisplay(const char *dumpDir = ".", int dumpMode = HEADLESS_DUMP_NONE);
+
+    // Destructor
+    ~HeadlessDisplay();
+
+    /**
+     * Allocate the frame and set the flush callback of the display driver
+     * @param drv: LVGL display driver (before registration)
+     * @returns true on success
+     */
+    bool init(lv_disp_drv_t *drv);
+
+    /**
+     * Write the current frame to <dumpDir>/<name>.ppm
+     * @returns true on success
+     */
+    bool dump(const char *name);
+
+private:
+    static void flush(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p);
+    void copy(const lv_area_t *area, const lv_color_t *color_p);
+    void frame_done(void);
+    bool write_ppm(const std::string &path, const lv_area_t *area);
+
+    lv_color_t *_frame;
+    lv_coord_t _width;
+    lv_coord_t _height;
+    std::string _dir;
+    int _mode;
+    // statistics
+    unsigned long _frames;          // refreshed frames
+    uint64_t _px;                   // pixels flushed
+    unsigned long _dumps;           // PPM files written
+    uint64_t _dump_time_us;
+};
+
+class TouchScript {
+public:
+    // Constructor
+    TouchScript();
+
+    /**
+     * Load a touch script
+     * @param path: script file
+     * @returns true on success
+     */
+    bool load(const char *path);
+
+    /**
+     * Execute the steps due
+     * @param time_ms: time since the start
+     * @param touch: receives the touch samples
+     * @param display: executes the dump steps (can be NULL)
+     * @returns false at the end of the script
+     */
+    bool process(uint32_t time_ms, TouchInput *touch, HeadlessDisplay *display);
+
+private:
+    typedef enum {
+        STEP_DOWN = 0,
+        STEP_UP,
+        STEP_DUMP,
+        STEP_EXIT,
+    } step_type_t;
+
+    typedef struct {
+        uint32_t time_ms;
+        step_type_t type;
+        int16_t x;
+        int16_t y;
+        std::string name;           // dump file name
+    } step_t;
+
+    std::vector<step_t> _steps;
+    size_t _next;
+    int16_t _x;                     // last touch position
+    int16_t _y;
+};
+
+#endif /* HEADLESS_H */
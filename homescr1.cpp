@@ -20,6 +20,9 @@
 #include <unistd.h>
 #include <syslog.h>
 
+#include <atomic>
+#include <mutex>
+
 #include <mosquitto.h>
 
 #include "mqtt.h"
@@ -30,23 +33,53 @@
 #include "hardware.h"
 #include "screen.h"
 #include "datatag.h"
-//#include "mcp9808.h"
-
-#define VAR_PROCESS_INTERVAL 15      // seconds
+#include "worker.h"
+#include "scheduler.h"
+#include "touch.h"
+#include "mcp9808.h"
+#include "sensors.h"
+#include "backlight.h"
+#include "headless.h"
+
+#define CPU_TEMP_INTERVAL 15000     // ms
+#define NETWORK_INTERVAL 1000       // ms
+#define ENV_TEMP_INTERVAL 15000     // ms, publish environment temperature
+#define ENV_TEMP_SAMPLE_INTERVAL 2000   // ms, MCP9808 sample rate
+#define SENSOR_INTERVAL 15000       // ms, publish the system sensors
 
 //#define MQTT_CONNECT_TIMEOUT 5      // seconds
 
 bool exitSignal = false;
 bool debugEnabled = false;
 bool runningAsDaemon = false;
-time_t var_process_time = time(NULL) + VAR_PROCESS_INTERVAL;
 //time_t mqtt_connection_timeout = 0;
 time_t mqtt_connect_time = 0;   // time the connection was initiated
 bool mqtt_connection_in_progress = false;
 std::string processName;
-
-
-extern char *info_label_text;
+const char *envTempSimFile = NULL;  // simulate environment temperature sensor
+// headless operation (no display, touch screen or broker)
+const char *headlessDir = NULL;     // PPM dump directory, NULL = use the display
+int headlessDumpMode = HEADLESS_DUMP_NONE;
+const char *touchScriptFile = NULL;
+
+// brightness value waiting to be written by a worker thread
+std::atomic<int> brightness_request(0);
+std::atomic<bool> brightness_job_queued(false);
+std::mutex brightness_mutex;        // one backlight write at a time, in request order
+// CPU temperature read by a worker thread
+float cpu_temp_value = 0.0;
+bool cpu_temp_job_queued = false;
+// system sensors read in a single pass by a worker thread
+bool sensor_job_queued = false;
+
+// hardware info collected by a worker thread for the settings tab
+typedef struct {
+    char model[80];
+    char os[80];
+    char kernel[80];
+} hw_info_t;
+hw_info_t *hw_info = NULL;      // filled by a worker job, freed on exit
+bool hw_info_ready = false;     // the worker job completed
 
 /* Callback functions to update the display value  */
 extern void cpuTempUpdate(int x, Tag* t);
@@ -68,7 +101,14 @@ void mqtt_publish_tag(int x, Tag* t);
 Hardware hw;
 TagStore ts;
 MQTT mqtt;
-//Mcp9808 envTempSensor;    // Environment temperature sensor at rear of screen
+WorkerPool workers;
+Scheduler scheduler;
+TouchInput touch;
+SensorSet sensors;
+Backlight backlight;
+Mcp9808 *envTempSensor = NULL;    // Environment temperature sensor at rear of screen
+HeadlessDisplay *headless = NULL;   // in-memory display, replaces the frame buffer
+TouchScript *touchScript = NULL;    // synthetic touch input
 
 /*
  * Handle system signals
@@ -96,6 +136,105 @@ void sigHandler(int signum)
     exitSignal = true;
 }
 
+/*
+ * Run a job on the worker pool
+ * the job is executed synchronously if the worker pool is not available
+ */
+void run_job(void (*work) (void*), void (*done) (void*), void *arg)
+{
+    if (!workers.post(work, done, arg)) {
+        (*work) (arg);
+        if (done != NULL) (*done) (arg);
+    }
+}
+
+/*
+ * Worker jobs
+ * "work" functions are executed on a worker thread and must not access
+ * LVGL objects or data tags, "done" functions are executed on the main loop.
+ */
+void shutdown_work(void *arg)
+{
+    hw.shutdown(arg != NULL);
+}
+
+void brightness_work(void *arg)
+{
+    // a job queued by a newer request waits here and writes after this one,
+    // so the last write is always the latest value
+    std::lock_guard<std::mutex> lock(brightness_mutex);
+    // clear the flag first, a newer request will then queue a new job
+    brightness_job_queued = false;
+    hw.set_brightness(brightness_request);
+}
+
+void cpu_temp_work(void *arg)
+{
+    cpu_temp_value = hw.read_cpu_temp();
+}
+
+void cpu_temp_done(void *arg)
+{
+    cpu_temp_job_queued = false;
+    Tag *tag = ts.getTag((char*) TOPIC_CPU_TEMP);
+    if (tag != NULL) {
+        tag->setValue(cpu_temp_value, true);
+        //printf("%s - %s %.1f\n", __func__, tag->getTopic(), tag->floatValue());
+        cpuTempUpdate(0, tag);      // update on screen
+    }
+}
+
+void sensor_read_work(void *arg)
+{
+    sensors.read();
+}
+
+void sensor_read_done(void *arg)
+{
+    sensor_job_queued = false;
+    sensors.update();       // publishes the tags
+}
+
+void hw_info_work(void *arg)
+{
+    hw_info_t *info = (hw_info_t*) arg;
+    hw.get_model_name(info->model, sizeof(info->model));
+    hw.get_os_name(info->os, sizeof(info->os));
+    hw.get_kernel_name(info->kernel, sizeof(info->kernel));
+}
+
+/*
+ * Update the info label on the settings tab
+ * the IP addresses are maintained by hw.process_network()
+ */
+void update_info_label(void)
+{
+    char ip[128];
+    char text[380];
+    if (!hw_info_ready) return;
+    hw.get_ip_address(ip, sizeof(ip));
+    snprintf(text, sizeof(text), "%s\n%s\n%s\n%s", hw_info->model, hw_info->os, hw_info->kernel, ip);
+    screen_set_info(text);
+}
+
+void hw_info_done(void *arg)
+{
+    hw_info_ready = true;
+    update_info_label();
+}
+
+/*
+ * Write a new brightness value from a worker thread
+ * requests are coalesced, only the latest value is written
+ */
+void set_brightness_async(int value)
+{
+    brightness_request = value;
+    if (!brightness_job_queued.exchange(true)) {
+        run_job(&brightness_work, NULL, NULL);
+    }
+}
+
 /*
  * Process commands from screen user interface
  */
@@ -105,16 +244,17 @@ void cmd_process(void)
     switch (screen_getCmd()) {
         case SCR_CMD_SHUTDOWN:
             cmdStr = "Shutdown";
-            hw.shutdown(false);
+            if (headless == NULL) run_job(&shutdown_work, NULL, (void*) 0);
             exitSignal = true;
             break;
         case SCR_CMD_REBOOT:
             cmdStr = "Reboot";
-            hw.shutdown(true);
+            if (headless == NULL) run_job(&shutdown_work, NULL, (void*) 1);
             exitSignal = true;
             break;
         case SCR_CMD_BRIGHTNESS:
-            hw.set_brightness(screen_brightness());
+            // written at the backlight cadence, slider moves are coalesced
+            backlight.setLevel(screen_brightness());
             break;
         default:
             break;
@@ -127,64 +267,117 @@ void cmd_process(void)
 }
 
 /*
- * Process local variables
- * Local variables get are processed at a fixed time interval
+ * Scheduled jobs
+ * Local variables are processed at a fixed time interval by the scheduler.
  * The processing involves reading value from hardware and
  * publishing the value to MQTT broker
  */
-void var_process(void) {
-    time_t now = time(NULL);
-    if (now > var_process_time) {
-        var_process_time = now + VAR_PROCESS_INTERVAL;
-
-        // update CPU temperature
-        Tag *tag = ts.getTag((char*) TOPIC_CPU_TEMP);
-        if (tag != NULL) {
-            tag->setValue(hw.read_cpu_temp(), true);
-            //printf("%s - %s %.1f\n", __func__, tag->getTopic(), tag->floatValue());
-            cpuTempUpdate(0, tag);      // update on screen
-        }
-/*
-        // update environment temperature
-        float fValue;
-        tag = ts.getTag((const char*) TOPIC_ENV_TEMP);
-        if (tag != NULL) {
-            if (envTempSensor.readTempC(&fValue)) {
-                tag->setValue(fValue, true);
-                roomTempUpdate(0, tag);		// update on screen
-            } else {
-				tag->setNoreadStatus(true);
+void cpu_temp_job(void *arg)
+{
+    // update CPU temperature, the tag is updated when the read completes
+    if (!cpu_temp_job_queued) {
+        cpu_temp_job_queued = true;
+        run_job(&cpu_temp_work, &cpu_temp_done, NULL);
+    }
+}
+void sensor_job(void *arg)
+{
+    // read all system sensors, the tags are updated when the read completes
+    if (!sensor_job_queued) {
+        sensor_job_queued = true;
+        run_job(&sensor_read_work, &sensor_read_done, NULL);
+    }
+}
+void network_job(void *arg)
+{
+    // the info label is only updated when the addresses have changed
+    if (hw.process_network()) {
+        update_info_label();
+    }
+}
+void env_temp_job(void *arg)
+{
+    // update environment temperature, sampled on a background thread
+    static bool read_failed = false;
+    float fValue;
+    Tag *tag = ts.getTag((const char*) TOPIC_ENV_TEMP);
+    if ((tag != NULL) && (envTempSensor != NULL)) {
+        if (envTempSensor->getTempC(&fValue)) {
+            tag->setValue(fValue, true);
+            roomTempUpdate(0, tag);		// update on screen
+            read_failed = false;
+        } else {
+			tag->setNoreadStatus(true);
+            roomTempUpdate(0, tag);
+            if (!read_failed) {
                 syslog(LOG_ERR, "Failed to read Mcp9808 temp sensor");
             }
+            read_failed = true;
         }
-*/
     }
+}
 
-    // reconnect mqtt if required
-    /*if (!mqtt.isConnected() && !mqtt_connection_in_progress) {
-        mqtt_connect();
-    }*/
+/*
+ * Start sampling the environment temperature sensor
+ * a file backed fake sensor is used if envTempSimFile is set, headless
+ * operation has no sensor otherwise
+ */
+void init_env_temp(void)
+{
+    if ((headless != NULL) && (envTempSimFile == NULL)) {
+        return;     // no sensor hardware when headless, unless simulated
+    }
+    if (envTempSimFile != NULL) {
+        I2cFake *fake = new I2cFake(MCP9808_DEFAULT_ADDRESS);
+        fake->setRegisterFile(0x05, envTempSimFile, 16.0);     // 0.0625 DegC per bit
+        envTempSensor = new Mcp9808(MCP9808_DEFAULT_ADDRESS, fake);
+    } else {
+        envTempSensor = new Mcp9808();
+    }
+    if (!envTempSensor->start(ENV_TEMP_SAMPLE_INTERVAL)) {
+        syslog(LOG_ERR, "Failed to start Mcp9808 sampling");
+    }
+}
+
+/*
+ * Register the periodic jobs with the scheduler
+ */
+void init_jobs(void)
+{
+    scheduler.addJob("cpu temp", &cpu_temp_job, NULL, CPU_TEMP_INTERVAL);
+    scheduler.addJob("network", &network_job, NULL, NETWORK_INTERVAL);
+    scheduler.addJob("env temp", &env_temp_job, NULL, ENV_TEMP_INTERVAL);
+    if (sensors.count() > 0) {
+        scheduler.addJob("sensors", &sensor_job, NULL, SENSOR_INTERVAL);
+    }
 }
 
 void init_values(void)
 {
-    char info1[80], info2[80], info3[80], info4[80];
     // Initialise brightness
-    int value = hw.get_brightness();
-    if (value < 10) {
-        value = 10; // ensure min value
-        hw.set_brightness(value);
+    // read synchronously, the value is required to create the screen
+    if (headless != NULL) {
+        // the backlight is left alone
+        screen_set_brightness(BACKLIGHT_MAX);
+        backlight.init(&scheduler, NULL, BACKLIGHT_MAX);
+    } else {
+        int value = hw.get_brightness();
+        if (value < 10) {
+            value = 10; // ensure min value
+            set_brightness_async(value);
+        }
+        screen_set_brightness(value);   // write to screen brightness
+        backlight.init(&scheduler, &set_brightness_async, value);
+    }
+
+    // get the IP addresses, changes are received via netlink
+    if (!hw.open_network()) {
+        syslog(LOG_WARNING, "Failed to read network addresses");
     }
-    screen_set_brightness(value);   // write to screen brightness
 
-    // get hardware info
-    hw.get_model_name(info1, sizeof(info1));
-    hw.get_os_name(info2, sizeof(info2));
-    hw.get_kernel_name(info3, sizeof(info3));
-    hw.get_ip_address(info4, sizeof(info4));
-    info_label_text = (char *)malloc(strlen(info1) +strlen(info2) +strlen(info3) +strlen(info4) +5);
-    sprintf(info_label_text, "%s\n%s\n%s\n%s", info1, info2, info3, info4);
-    //printf(info_label_text);
+    // get hardware info, the info label is updated when the job completes
+    hw_info = new hw_info_t();
+    run_job(&hw_info_work, &hw_info_done, hw_info);
 }
 
 /*
@@ -223,12 +416,13 @@ void init_tags(void)
     tp->registerPublishCallback(&mqtt_publish_tag, 0);
 
     // Environment temperature is stored in index 0
-/*    tp = ts.addTag((char*) TOPIC_ENV_TEMP);
+    tp = ts.addTag((char*) TOPIC_ENV_TEMP);
     tp->setPublish();
     tp->setFormat("%.1f");
+	tp->setNoreadStr("##.#");
     tp->registerUpdateCallback(&roomTempUpdate, 0);   // update screen
     tp->registerPublishCallback(&mqtt_publish_tag, 0);
-*/
+
     // Shack Temp is stored in index 1
     tp = ts.addTag((const char*) TOPIC_SHACK_ROOM_TEMP);
     tp->setSubscribe();
@@ -310,6 +504,9 @@ void init_tags(void)
     init_bool_tag((const char*) Topic_Shack_Radio12_Pwr[6], &shackRadio12PwrSwitchUpdate, 6);
     init_bool_tag((const char*) Topic_Shack_Radio12_Pwr[7], &shackRadio12PwrSwitchUpdate, 7);
 
+    // System sensors (thermal, hwmon, cpufreq, load, memory)
+    sensors.discover(&ts, TOPIC_SENSOR_BASE, &mqtt_publish_tag);
+
 }
 
 void mqtt_connect(void) {
@@ -417,13 +614,48 @@ void mqtt_publish_tag(int x, Tag *t) {
  */
 void exit_loop(void)
 {
-	hw.set_brightness(screen_brightness());
+	// queued behind any pending fade step, written when the workers are stopped
+	if (headless == NULL) set_brightness_async(screen_brightness());
 	screen_exit();
 	for (int i=0; i<=10; i++) {
 		lv_tick_inc(SCREEN_UPDATE);
 		lv_task_handler();
 		usleep(SCREEN_UPDATE * 1000);
 	}
+	screen_close();
+	// wait for queued jobs (e.g. shutdown) to finish
+	workers.stop();
+	hw_info_ready = false;
+	delete hw_info;
+	hw_info = NULL;
+	delete envTempSensor;
+	envTempSensor = NULL;
+	delete touchScript;
+	touchScript = NULL;
+	delete headless;
+	headless = NULL;
+}
+
+/*
+ * elapsed time between two timestamps in seconds
+ */
+double elapsed_time(struct timespec *start, struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/*
+ * Suspend rendering while the screen saver has blanked the display
+ * and resume with a full screen refresh when the display is turned on
+ */
+void suspend_process(void)
+{
+    bool blanked = hw.is_screen_saver_active();
+    if (blanked && !screen_is_suspended()) {
+        screen_suspend();
+    } else if (!blanked && screen_is_suspended()) {
+        screen_resume();
+    }
 }
 
 void main_loop()
@@ -431,18 +663,47 @@ void main_loop()
     clock_t start, end;
     double cpu_time_used;
     double min_time = 99999.0, max_time = 0.0;
+    // wall clock time includes time spent blocked in system calls
+    struct timespec loop_start, loop_end;
+    double loop_time, max_stall = 0.0;
+    struct timespec sleep_start, sleep_end;
+    uint32_t tick_ms = SCREEN_UPDATE;
+    uint32_t run_ms = 0;    // LVGL time since the start, drives the touch script
 
     // first call takes a long time (10ms)
     lv_tick_inc(SCREEN_UPDATE);
     lv_task_handler();
     while (!exitSignal) {
         start = clock();
-        lv_tick_inc(SCREEN_UPDATE);
-        lv_task_handler();
+        clock_gettime(CLOCK_MONOTONIC, &loop_start);
+        lv_tick_inc(tick_ms);
+        run_ms += tick_ms;
+        if ((touchScript != NULL) && !touchScript->process(run_ms, &touch, headless)) {
+            exitSignal = true;      // end of the script
+        }
+        // read touch input once for LVGL and the screen saver
+        touch.process();
+        // no rendering while the display is blanked, tags are still updated
+        if (!screen_is_suspended()) {
+            screen_process();
+        }
+        workers.process_completions();
         cmd_process();
-        var_process();
-        hw.process_screen_saver(screen_brightness());
+        scheduler.process();
+        if (hw.process_screen_saver(touch.activity())) {
+            if (hw.is_screen_saver_active()) {
+                backlight.setLevel(0, BACKLIGHT_FADE_OUT);
+            } else {
+                backlight.setLevel(screen_brightness(), BACKLIGHT_FADE_IN);
+            }
+        }
+        suspend_process();
         end = clock();
+        clock_gettime(CLOCK_MONOTONIC, &loop_end);
+        loop_time = elapsed_time(&loop_start, &loop_end);
+        if (loop_time > max_stall) {
+            max_stall = loop_time;
+        }
         cpu_time_used = ((double) (end - start)) / CLOCKS_PER_SEC;
         if (cpu_time_used > max_time) {
             max_time = cpu_time_used;
@@ -450,9 +711,21 @@ void main_loop()
         if (cpu_time_used < min_time) {
             min_time = cpu_time_used;
         }
-        usleep(SCREEN_UPDATE * 1000);
+        if (screen_is_suspended()) {
+            // sleep until touched, the tick must advance by the actual sleep time
+            clock_gettime(CLOCK_MONOTONIC, &sleep_start);
+            touch.wait(scheduler.msToNext(SCREEN_SUSPEND_POLL));
+            clock_gettime(CLOCK_MONOTONIC, &sleep_end);
+            tick_ms = elapsed_time(&sleep_start, &sleep_end) * 1000 + 0.5;
+        } else {
+            tick_ms = SCREEN_UPDATE;
+            // headless: simulated time, frames are rendered as fast as possible
+            if (headless == NULL) usleep(SCREEN_UPDATE * 1000);
+        }
     }
     printf("CPU time %.3fms - %.3fms\n", min_time*1000, max_time*1000);
+    printf("Loop stall max %.3fms\n", max_stall*1000);
+    syslog(LOG_INFO, "Loop stall max %.3fms", max_stall*1000);
 }
 
 void argument(const char *arg) {
@@ -462,6 +735,35 @@ void argument(const char *arg) {
                 debugEnabled = true;
                 printf("Debug enabled\n");
                 break;
+            case 's':
+                // -s<file>: simulate the MCP9808, file contains the temperature in DegC
+                envTempSimFile = &arg[2];
+                printf("Simulating environment temperature from %s\n", envTempSimFile);
+                break;
+            case 'p':
+                // -p<lines>: render in partial stripes instead of page flipping
+                screen_set_stripes(arg[2] ? atoi(&arg[2]) : SCREEN_STRIPE_LINES);
+                break;
+            case 'v':
+                // -v: refresh without aligning to the vblank
+                screen_set_vsync(false);
+                break;
+            case 'H':
+                // -H[dir]: headless, render into memory, dump PPM files to dir
+                headlessDir = arg[2] ? &arg[2] : ".";
+                break;
+            case 'D':
+                // -Df: dump every frame, -Dr: dump the refreshed areas of every frame
+                headlessDumpMode = (arg[2] == 'r') ? HEADLESS_DUMP_RECTS : HEADLESS_DUMP_FRAMES;
+                break;
+            case 'f':
+                // -f<file>: load the fonts of a configuration file, see fonts.h
+                screen_set_fonts(&arg[2]);
+                break;
+            case 't':
+                // -t<file>: play a touch script, exit at the end of the script
+                touchScriptFile = &arg[2];
+                break;
             default:
                 fprintf(stderr, "unknown argument: %s\n", arg);
                 syslog(LOG_NOTICE, "unknown argument: %s", arg);
@@ -496,12 +798,30 @@ int main (int argc, char *argv[])
 
     //mqtt.setConsoleLog(true);
     usleep(100000);
+    // blocking system calls are executed by the worker threads
+    if (!workers.start()) {
+        syslog(LOG_WARNING, "worker pool not available, running jobs on main thread");
+    }
+    if (headlessDir != NULL) {
+        headless = new HeadlessDisplay(headlessDir, headlessDumpMode);
+        printf("Headless operation, no display, touch screen or broker\n");
+    } else {
+        touch.open_device();
+    }
+    if (touchScriptFile != NULL) {
+        touchScript = new TouchScript();
+        if (!touchScript->load(touchScriptFile)) {
+            exit(EXIT_FAILURE);
+        }
+    }
     // sequence is very important, functions rely on initialised data
     screen_init();
     init_tags();
     init_values();
+    init_env_temp();
+    init_jobs();
     screen_create();
-    init_mqtt();
+    if (headless == NULL) init_mqtt();
     main_loop();
     exit_loop();
     syslog(LOG_INFO, "exiting");
@@ -48,6 +48,14 @@
  * Can be changed in the display driver (`lv_disp_drv_t`).*/
 #define LV_DISP_DEF_REFR_PERIOD      50      /*[ms]*/
 
+/* Mark invalidated areas in a bitmap of tiles instead of a list of areas.
+ * The refreshed areas are the horizontal spans of marked tiles, so bursts
+ * of small invalidations never fall back to refreshing the whole screen.*/
+#define LV_INV_TILES        1
+#if LV_INV_TILES
+#define LV_INV_TILE_SIZE    32      /*[px] width and height of a tile*/
+#endif
+
 /* Dot Per Inch: used to initialize default sizes.
  * E.g. a button with width = LV_DPI / 2 -> half inch wide
  * (Not so important, you can adjust it to modify default sizes and spaces)*/
@@ -78,7 +86,7 @@ typedef int16_t lv_coord_t;
 #define LV_MEM_CUSTOM      0
 #if LV_MEM_CUSTOM == 0
 /* Size of the memory used by `lv_mem_alloc` in bytes (>= 2kB)*/
-#  define LV_MEM_SIZE    (32U * 1024U)
+#  define LV_MEM_SIZE    (48U * 1024U)
 
 /* Complier prefix for a big array declaration */
 #  define LV_MEM_ATTR
@@ -156,8 +164,22 @@ typedef void * lv_anim_user_data_t;
  * where shadow size is `shadow_width + radius`
  * Caching has LV_SHADOW_CACHE_SIZE^2 RAM cost*/
 #define LV_SHADOW_CACHE_SIZE    0
+
+/* Number of shadow shapes buffered, the least recently used one is replaced.
+ * The RAM cost is LV_SHADOW_CACHE_CNT * LV_SHADOW_CACHE_SIZE^2 */
+#define LV_SHADOW_CACHE_CNT     1
 #endif
 
+/* Number of radii whose anti-aliased corner is buffered for the radius masks
+ * (rounded rectangles, circles). The corner is calculated once per radius and drawn from the table after it.
+ * A table takes about 10 * radius bytes, the least recently used ones are freed to make room for new radii.
+ * 0: Disable the buffering*/
+#define LV_RADIUS_MASK_CACHE_CNT    16
+
+/* Max. memory of the buffered corners in bytes (from the LVGL heap).
+ * Larger corners are calculated on every draw*/
+#define LV_RADIUS_MASK_CACHE_SIZE   4096
+
 /* 1: Use other blend modes than normal (`LV_BLEND_MODE_...`)*/
 #define LV_USE_BLEND_MODES      1
 
@@ -177,6 +199,10 @@ typedef void * lv_group_user_data_t;
 #define LV_USE_GPU              1   /*Only enables `gpu_fill_cb` and `gpu_blend_cb` in the disp. drv- */
 #define LV_USE_GPU_STM32_DMA2D  0
 
+/* 1: Blend with NEON/SSE2/AVX2 kernels, selected for the CPU at run time.
+ * Bit-exact with the software rendering, LV_COLOR_DEPTH 32 only*/
+#define LV_USE_BLEND_SIMD       1
+
 /* 1: Enable file system (might be required for images */
 #define LV_USE_FILESYSTEM       1
 #if LV_USE_FILESYSTEM
@@ -208,8 +234,14 @@ typedef void * lv_fs_drv_user_data_t;
  * (I.e. no new image decoder is added)
  * With complex image decoders (e.g. PNG or JPG) caching can save the continuous open/decode of images.
  * However the opened images might consume additional RAM.
+ * The least recently used images are closed first.
  * LV_IMG_CACHE_DEF_SIZE must be >= 1 */
-#define LV_IMG_CACHE_DEF_SIZE       1
+#define LV_IMG_CACHE_DEF_SIZE       16
+
+/* Default memory budget of the image cache in bytes.
+ * The cache entries, the images decoded to RAM and the decoders' data (e.g. palettes, file handles) are counted.
+ * The image opened last is always kept. 0: Limit only the number of images */
+#define LV_IMG_CACHE_DEF_MEM_SIZE   (16U * 1024U)
 
 /*Declare the type of the user data of image decoder (can be e.g. `void *`, `int`, `struct`)*/
 typedef void * lv_img_decoder_user_data_t;
@@ -377,6 +409,24 @@ typedef void * lv_indev_drv_user_data_t;            /*Type of user data in the i
  * but with > 10,000 characters if you see issues probably you need to enable it.*/
 #define LV_FONT_FMT_TXT_LARGE   0
 
+/* Cache the glyphs of the built-in format fonts as A8 bitmaps.
+ * Frequently drawn letters skip the glyph search and the decompression.
+ * Number of cached glyphs, 0: disable the cache*/
+#define LV_FONT_FMT_TXT_CACHE_CNT   64
+
+/* Max. memory of the cached bitmaps in bytes (allocated with `lv_mem_alloc`)*/
+#define LV_FONT_FMT_TXT_CACHE_SIZE  (16 * 1024)
+
+/* 1: Look up the glyph ids (and kerning pairs) of U+0020..U+007F and the degree sign
+ * with a direct index built on the first use of a font.
+ * Takes ~200 bytes per font (+9 kB with kerning pairs instead of kerning classes)*/
+#define LV_FONT_FMT_TXT_FAST_INDEX  1
+
+/* 1: Load fonts in the binary format of lv_font_conv (`--format bin`) from memory
+ * with `lv_font_load_bin()`. The glyph bitmaps and tables are used in place
+ * so the data can be e.g. a memory mapped file*/
+#define LV_USE_FONT_LOADER  1
+
 /* Set the pixel order of the display.
  * Important only if "subpx fonts" are used.
  * With "normal" font it doesn't matter.
@@ -503,6 +553,12 @@ typedef struct {
 /*1: enable `lv_obj_realaign()` based on `lv_obj_align()` parameters*/
 #define LV_USE_OBJ_REALIGN          1
 
+/* Cache the style properties resolved by the `lv_obj_get_style_...()` functions
+ * so drawing an unchanged object doesn't search its style lists and its parents again.
+ * Number of cached properties of all objects, 0: disable the cache.
+ * Takes 16 bytes (32 bytes with 64 bit pointers) per property*/
+#define LV_STYLE_CACHE_CNT          1024
+
 /* Enable to make the object clickable on a larger area.
  * LV_EXT_CLICK_AREA_OFF or 0: Disable this feature
  * LV_EXT_CLICK_AREA_TINY: The extra area can be adjusted horizontally and vertically (0..255 px)
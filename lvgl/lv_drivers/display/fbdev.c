@@ -9,6 +9,22 @@
 #include "fbdev.h"
 #if USE_FBDEV || USE_BSD_FBDEV
 
+/*Use NEON / SSE2 kernels for the pixel format conversion if available*/
+#ifndef FBDEV_SIMD
+#define FBDEV_SIMD  1
+#endif
+
+/*Copy long lines with non-temporal (streaming) stores (SSE2 only), the framebuffer is not read back.
+ *Off by default: slower than memcpy if the framebuffer is cached memory (virtual framebuffers)*/
+#ifndef FBDEV_STREAM
+#define FBDEV_STREAM  0
+#endif
+
+/*Ordered dithering when converting to 16 bit per pixel (can be changed with `fbdev_set_dither`)*/
+#ifndef FBDEV_DITHER
+#define FBDEV_DITHER  1
+#endif
+
 #include <stdlib.h>
 #include <unistd.h>
 #include <stddef.h>
@@ -16,6 +32,20 @@
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <sys/ioctl.h>
+#include <pthread.h>
+#include <time.h>
+
+#if FBDEV_SIMD && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define FBDEV_NEON 1
+#elif FBDEV_SIMD && defined(__SSE2__)
+#include <emmintrin.h>
+#define FBDEV_SSE2 1
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define FBDEV_SSSE3 1
+#endif
+#endif
 
 #if USE_BSD_FBDEV
 #include <sys/fcntl.h>
@@ -33,9 +63,30 @@
 #define FBDEV_PATH  "/dev/fb0"
 #endif
 
+/*Lines of at least this many bytes are copied with streaming stores*/
+#ifndef FBDEV_STREAM_MIN_BYTES
+#define FBDEV_STREAM_MIN_BYTES  256
+#endif
+
+/*A shorter vblank period means FBIO_WAITFORVSYNC does not wait*/
+#ifndef FBDEV_VSYNC_MIN_US
+#define FBDEV_VSYNC_MIN_US  2000
+#endif
+
+/*Smaller areas are copied directly instead of by the flush thread*/
+#ifndef FBDEV_ASYNC_MIN_PX
+#define FBDEV_ASYNC_MIN_PX  (16 * 1024)
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
+typedef enum {
+    FB_FMT_NATIVE,      /*same as lv_color_t, copied*/
+    FB_FMT_RGB565,      /*converted from 32 bit*/
+    FB_FMT_RGB888,      /*converted from 32 bit, 3 bytes per pixel*/
+    FB_FMT_GENERIC,     /*converted from 32 bit using the channel offsets, scalar only*/
+} fb_format_t;
 
 /**********************
  *      STRUCTURES
@@ -57,6 +108,20 @@ struct bsd_fb_fix_info{
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static void fbdev_copy(const lv_area_t * area, lv_color_t * color_p);
+static void copy_line(void * dst, const void * src, size_t len);
+static uint64_t now_us(void);
+static fb_format_t detect_format(void);
+#if LV_COLOR_DEPTH == 32
+static void convert_565(uint16_t * dst, const lv_color_t * src, int32_t w, int32_t x, int32_t y);
+static void convert_888(uint8_t * dst, const lv_color_t * src, int32_t w);
+static void convert_generic(uint8_t * dst, const lv_color_t * src, int32_t w);
+#endif
+static void * flush_thread_main(void * arg);
+#if USE_FBDEV
+static void * vsync_thread_main(void * arg);
+static void pan_display(uint32_t yoffset);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -71,6 +136,43 @@ static struct fb_fix_screeninfo finfo;
 static char *fbp = 0;
 static long int screensize = 0;
 static int fbfd = 0;
+static fb_format_t fb_format = FB_FMT_NATIVE;
+static bool dither = FBDEV_DITHER;
+#if USE_FBDEV
+static struct fb_var_screeninfo vinfo_orig;    /*restored on exit if page flipping changed it*/
+static bool page_flip = false;
+static char *page2 = NULL;                      /*second page in the framebuffer*/
+#endif
+/*Stripe handed to the flush thread*/
+static pthread_t flush_thread;
+static pthread_mutex_t flush_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t flush_cond = PTHREAD_COND_INITIALIZER;
+static bool flush_thread_running = false;
+static bool flush_stop = false;
+static bool flush_busy = false;         /*a stripe is waiting or being copied*/
+static lv_disp_drv_t * flush_drv;
+static lv_area_t flush_area;            /*copy, LVGL reuses its area for the next stripe*/
+static lv_color_t * flush_color_p;
+/*Flush thread statistics, the copy time not spent waiting overlaps with rendering*/
+static unsigned long async_flushes;
+static uint64_t async_copy_us;          /*copy time of the flush thread*/
+static uint64_t async_wait_us;          /*time LVGL waited for the flush thread*/
+static uint64_t async_px;
+#if USE_FBDEV
+/*Vblank thread, pans to the page queued by `fbdev_flip` at the next vblank*/
+static pthread_t vsync_thread;
+static pthread_mutex_t vsync_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t vsync_cond = PTHREAD_COND_INITIALIZER;
+static bool vsync_running = false;
+static bool vsync_stop = false;
+static uint32_t vsync_count;            /*vblanks seen*/
+static uint64_t vsync_last_us;          /*time of the last vblank*/
+static uint32_t vsync_period_us;        /*average time between vblanks*/
+static bool pan_pending = false;        /*a page waits for the next vblank*/
+static lv_disp_drv_t * pan_drv;
+static uint32_t pan_yoffset;
+static unsigned long vsync_pans;        /*pans done at a vblank*/
+#endif
 
 /**********************
  *      MACROS
@@ -129,6 +231,7 @@ void fbdev_init(void)
 #endif /* USE_BSD_FBDEV */
 
     printf("%dx%d, %dbpp\n", vinfo.xres, vinfo.yres, vinfo.bits_per_pixel);
+    fb_format = detect_format();
 
     // Figure out the size of the screen in bytes
     screensize =  finfo.smem_len; //finfo.line_length * vinfo.yres;    
@@ -147,9 +250,138 @@ void fbdev_init(void)
 
 void fbdev_exit(void)
 {
+    fbdev_flush_thread_stop();
+    fbdev_vsync_stop();
+#if USE_FBDEV
+    if(page_flip) {
+        /*Both pages hold the same content, restore the original resolution*/
+        vinfo_orig.yoffset = 0;
+        ioctl(fbfd, FBIOPUT_VSCREENINFO, &vinfo_orig);
+        page_flip = false;
+    }
+#endif
     close(fbfd);
 }
 
+/**
+ * Get the visible resolution of the framebuffer
+ * @param width storage for the width in pixels
+ * @param height storage for the height in pixels
+ */
+void fbdev_get_sizes(uint32_t * width, uint32_t * height)
+{
+    if(width) *width = vinfo.xres;
+    if(height) *height = vinfo.yres;
+}
+
+/**
+ * Set the virtual resolution to twice the visible height to render directly
+ * into the framebuffer. The two pages are used as LVGL's draw buffers (true
+ * double buffering) and `fbdev_flip` pans the display to the page rendered last.
+ * Requires the framebuffer format to match `lv_color_t` without line padding.
+ * @param buf1 storage for the address of the first page
+ * @param buf2 storage for the address of the second page
+ * @return the size of a page in pixels, 0 if page flipping is not possible
+ */
+uint32_t fbdev_page_flip_init(void ** buf1, void ** buf2)
+{
+#if USE_FBDEV
+    if(fbp == NULL || fbp == MAP_FAILED) return 0;
+    if(fb_format != FB_FMT_NATIVE || vinfo.bits_per_pixel != LV_COLOR_DEPTH ||
+            finfo.line_length != vinfo.xres * sizeof(lv_color_t)) {
+        printf("Page flipping not supported: %dbpp, line length %d\n", vinfo.bits_per_pixel, finfo.line_length);
+        return 0;
+    }
+
+    vinfo_orig = vinfo;
+    struct fb_var_screeninfo flip_vinfo = vinfo;
+    flip_vinfo.xres_virtual = vinfo.xres;
+    flip_vinfo.yres_virtual = vinfo.yres * 2;
+    flip_vinfo.xoffset = 0;
+    flip_vinfo.yoffset = 0;
+    if(ioctl(fbfd, FBIOPUT_VSCREENINFO, &flip_vinfo) == -1 ||
+            ioctl(fbfd, FBIOGET_VSCREENINFO, &flip_vinfo) == -1 ||
+            ioctl(fbfd, FBIOGET_FSCREENINFO, &finfo) == -1 ||
+            flip_vinfo.yres_virtual < vinfo.yres * 2 ||
+            finfo.smem_len < finfo.line_length * vinfo.yres * 2) {
+        perror("Page flipping not supported");
+        ioctl(fbfd, FBIOPUT_VSCREENINFO, &vinfo_orig);
+        ioctl(fbfd, FBIOGET_FSCREENINFO, &finfo);
+        return 0;
+    }
+    vinfo = flip_vinfo;
+
+    /*The framebuffer memory may have been reallocated, map it again*/
+    munmap(fbp, screensize);
+    screensize = finfo.smem_len;
+    fbp = (char *)mmap(0, screensize, PROT_READ | PROT_WRITE, MAP_SHARED, fbfd, 0);
+    if(fbp == MAP_FAILED) {
+        perror("Error: failed to map framebuffer device to memory");
+        fbp = NULL;
+        ioctl(fbfd, FBIOPUT_VSCREENINFO, &vinfo_orig);
+        return 0;
+    }
+    memset(fbp, 0, screensize);
+
+    page2 = fbp + finfo.line_length * vinfo.yres;
+    page_flip = true;
+    *buf1 = fbp;
+    *buf2 = page2;
+    printf("Page flipping enabled: %dx%d virtual\n", vinfo.xres_virtual, vinfo.yres_virtual);
+    return vinfo.xres * vinfo.yres;
+#else
+    (void) buf1;
+    (void) buf2;
+    return 0;
+#endif
+}
+
+/**
+ * Show the page LVGL has rendered (flush callback in page flipping mode)
+ * The buffers are kept in sync by LVGL, no pixels are copied here.
+ * @param drv pointer to driver where this function belongs
+ * @param area the refreshed area (always the full screen)
+ * @param color_p the page to show
+ */
+void fbdev_flip(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    (void) area;
+#if USE_FBDEV
+    if(page_flip) {
+        uint32_t yoffset = ((char *)color_p == page2) ? vinfo.yres : 0;
+        if(vsync_running) {
+            /*Pan at the next vblank, LVGL waits in `fbdev_flip_wait` before drawing into the other page*/
+            pthread_mutex_lock(&vsync_mutex);
+            pan_drv = drv;
+            pan_yoffset = yoffset;
+            pan_pending = true;
+            pthread_mutex_unlock(&vsync_mutex);
+            return;
+        }
+        pan_display(yoffset);
+    }
+#else
+    (void) color_p;
+#endif
+    lv_disp_flush_ready(drv);
+}
+
+/**
+ * Block until the page queued by `fbdev_flip` is shown (wait callback in page flipping mode)
+ * @param drv pointer to driver where this function belongs
+ */
+void fbdev_flip_wait(lv_disp_drv_t * drv)
+{
+    (void) drv;
+#if USE_FBDEV
+    pthread_mutex_lock(&vsync_mutex);
+    while(pan_pending) {
+        pthread_cond_wait(&vsync_cond, &vsync_mutex);
+    }
+    pthread_mutex_unlock(&vsync_mutex);
+#endif
+}
+
 /**
  * Flush a buffer to the marked area
  * @param drv pointer to driver where this function belongs
@@ -157,13 +389,431 @@ void fbdev_exit(void)
  * @param color_p an array of pixel to copy to the `area` part of the screen
  */
 void fbdev_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    fbdev_copy(area, color_p);
+    lv_disp_flush_ready(drv);
+}
+
+
+/**
+ * Start a thread copying the rendered stripes to the framebuffer.
+ * Use `fbdev_flush_async` as flush callback and `fbdev_flush_wait` as wait callback,
+ * with two draw buffers LVGL renders the next stripe while the previous one is copied.
+ * @return true if the thread is running
+ */
+bool fbdev_flush_thread_start(void)
+{
+    if(flush_thread_running) return true;
+    flush_stop = false;
+    flush_busy = false;
+    if(pthread_create(&flush_thread, NULL, flush_thread_main, NULL) != 0) {
+        perror("Error: cannot create flush thread");
+        return false;
+    }
+    flush_thread_running = true;
+    return true;
+}
+
+/**
+ * Stop the flush thread after the pending stripe has been copied
+ */
+void fbdev_flush_thread_stop(void)
+{
+    if(!flush_thread_running) return;
+    pthread_mutex_lock(&flush_mutex);
+    flush_stop = true;
+    pthread_cond_broadcast(&flush_cond);
+    pthread_mutex_unlock(&flush_mutex);
+    pthread_join(flush_thread, NULL);
+    flush_thread_running = false;
+
+    if(async_flushes > 0 && async_copy_us > 0) {
+        uint64_t hidden_us = async_copy_us > async_wait_us ? async_copy_us - async_wait_us : 0;
+        printf("fbdev: %lu async flushes, %lu px/flush, copy avg %.3fms, wait avg %.3fms, overlap %.1f%%\n",
+               async_flushes, (unsigned long)(async_px / async_flushes),
+               async_copy_us / 1000.0 / async_flushes, async_wait_us / 1000.0 / async_flushes,
+               hidden_us * 100.0 / async_copy_us);
+    }
+}
+
+/**
+ * Hand a stripe to the flush thread (flush callback)
+ * `lv_disp_flush_ready` is called by the flush thread when the copy is done.
+ * @param drv pointer to driver where this function belongs
+ * @param area an area where to copy `color_p`
+ * @param color_p an array of pixel to copy to the `area` part of the screen
+ */
+void fbdev_flush_async(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    if(!flush_thread_running) {
+        fbdev_flush(drv, area, color_p);
+        return;
+    }
+    if(lv_area_get_size(area) < FBDEV_ASYNC_MIN_PX) {
+        /*Handing over costs more than copying, keep the order with the pending stripe*/
+        fbdev_flush_wait(drv);
+        fbdev_flush(drv, area, color_p);
+        return;
+    }
+    pthread_mutex_lock(&flush_mutex);
+    /*LVGL waits for the previous stripe before flushing, so the slot is free*/
+    flush_drv = drv;
+    flush_area = *area;
+    flush_color_p = color_p;
+    flush_busy = true;
+    pthread_cond_broadcast(&flush_cond);
+    pthread_mutex_unlock(&flush_mutex);
+}
+
+/**
+ * Block until the flush thread has copied the pending stripe (wait callback)
+ * @param drv pointer to driver where this function belongs
+ */
+void fbdev_flush_wait(lv_disp_drv_t * drv)
+{
+    (void) drv;
+    pthread_mutex_lock(&flush_mutex);
+    if(flush_busy) {
+        uint64_t start = now_us();
+        while(flush_busy) {
+            pthread_cond_wait(&flush_cond, &flush_mutex);
+        }
+        async_wait_us += now_us() - start;
+    }
+    pthread_mutex_unlock(&flush_mutex);
+}
+
+/**
+ * Start a thread waiting for the vblanks of the display (FBIO_WAITFORVSYNC).
+ * In page flipping mode `fbdev_flip` then pans at the next vblank, use `fbdev_flip_wait`
+ * as wait callback. `fbdev_vsync_get` provides the vblank timing to align the refreshes.
+ * @return true if the driver supports FBIO_WAITFORVSYNC and the thread is running
+ */
+bool fbdev_vsync_start(void)
+{
+#if USE_FBDEV
+    if(vsync_running) return true;
+    if(fbp == NULL || fbp == MAP_FAILED) return false;
+
+    /*Measure the first period, some drivers return without waiting*/
+    uint32_t crtc = 0;
+    if(ioctl(fbfd, FBIO_WAITFORVSYNC, &crtc) == -1) {
+        perror("FBIO_WAITFORVSYNC not supported");
+        return false;
+    }
+    uint64_t first_us = now_us();
+    if(ioctl(fbfd, FBIO_WAITFORVSYNC, &crtc) == -1) return false;
+    vsync_last_us = now_us();
+    vsync_period_us = vsync_last_us - first_us;
+    if(vsync_period_us < FBDEV_VSYNC_MIN_US) {
+        printf("FBIO_WAITFORVSYNC does not wait for the vblank\n");
+        return false;
+    }
+    vsync_count = 1;
+    vsync_pans = 0;
+    vsync_stop = false;
+    pan_pending = false;
+    if(pthread_create(&vsync_thread, NULL, vsync_thread_main, NULL) != 0) {
+        perror("Error: cannot create vsync thread");
+        return false;
+    }
+    vsync_running = true;
+    printf("Vsync %.2fHz\n", 1e6 / vsync_period_us);
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Stop the vblank thread, a queued page is shown before
+ */
+void fbdev_vsync_stop(void)
+{
+#if USE_FBDEV
+    if(!vsync_running) return;
+    pthread_mutex_lock(&vsync_mutex);
+    vsync_stop = true;
+    pthread_mutex_unlock(&vsync_mutex);
+    pthread_join(vsync_thread, NULL);
+    vsync_running = false;
+    printf("fbdev: %lu vblanks, %.2fHz, %lu pans at vblank\n", (unsigned long)vsync_count,
+           1e6 / vsync_period_us, vsync_pans);
+#endif
+}
+
+/**
+ * Get the timing of the last vblank
+ * @param count storage for the number of vblanks seen
+ * @param vblank_us storage for the time of the last vblank (CLOCK_MONOTONIC) in µs
+ * @param period_us storage for the time between two vblanks in µs
+ * @return false if the vblank thread is not running
+ */
+bool fbdev_vsync_get(uint32_t * count, uint64_t * vblank_us, uint32_t * period_us)
+{
+#if USE_FBDEV
+    if(!vsync_running) return false;
+    pthread_mutex_lock(&vsync_mutex);
+    *count = vsync_count;
+    *vblank_us = vsync_last_us;
+    *period_us = vsync_period_us;
+    pthread_mutex_unlock(&vsync_mutex);
+    return true;
+#else
+    (void) count;
+    (void) vblank_us;
+    (void) period_us;
+    return false;
+#endif
+}
+
+/**
+ * Enable or disable ordered dithering when converting to 16 bit per pixel
+ * @param enable true: dither, false: truncate
+ */
+void fbdev_set_dither(bool enable)
+{
+    dither = enable;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Select the copy or conversion for the framebuffer pixel format
+ */
+static fb_format_t detect_format(void)
+{
+#if LV_COLOR_DEPTH == 32
+#if USE_BSD_FBDEV
+    bool rgb = true;        /*no channel layout available, assume RGB*/
+#else
+    bool rgb = vinfo.blue.offset == 0 && vinfo.blue.length <= 8 && vinfo.red.offset > vinfo.green.offset;
+#endif
+    if(vinfo.bits_per_pixel == 32) {
+#if USE_FBDEV
+        if(vinfo.red.offset != 16 || vinfo.green.offset != 8 || vinfo.blue.offset != 0) return FB_FMT_GENERIC;
+#endif
+        return FB_FMT_NATIVE;
+    }
+    if(vinfo.bits_per_pixel == 24) return rgb ? FB_FMT_RGB888 : FB_FMT_GENERIC;
+    if(vinfo.bits_per_pixel == 16) {
+#if USE_FBDEV
+        if(vinfo.red.length != 5 || vinfo.green.length != 6 || vinfo.blue.length != 5) return FB_FMT_GENERIC;
+#endif
+        return rgb ? FB_FMT_RGB565 : FB_FMT_GENERIC;
+    }
+#endif
+    return FB_FMT_NATIVE;
+}
+
+#if LV_COLOR_DEPTH == 32
+/*4x4 Bayer matrix, threshold for the bits dropped by a 5 bit (>> 1) and 6 bit (>> 2) channel*/
+static const uint8_t bayer4[4][4] = {
+    { 0,  8,  2, 10},
+    {12,  4, 14,  6},
+    { 3, 11,  1,  9},
+    {15,  7, 13,  5}
+};
+
+static inline uint8_t sat_add_u8(uint8_t a, uint8_t b)
+{
+    uint32_t sum = (uint32_t)a + b;
+    return sum > 255 ? 255 : sum;
+}
+
+/**
+ * Convert a line of 32 bit pixels to RGB565
+ * @param dst destination in the framebuffer
+ * @param src source pixels
+ * @param w number of pixels
+ * @param x, y screen position of the first pixel (dither phase)
+ */
+static void convert_565(uint16_t * dst, const lv_color_t * src, int32_t w, int32_t x, int32_t y)
+{
+    /*Dither offsets for 4 consecutive pixels starting at x, repeated for 8 pixels*/
+    uint8_t d5[8] = {0};
+    uint8_t d6[8] = {0};
+    int32_t i = 0;
+    if(dither) {
+        for(i = 0; i < 8; i++) {
+            uint8_t m = bayer4[y & 3][(x + i) & 3];
+            d5[i] = m >> 1;
+            d6[i] = m >> 2;
+        }
+    }
+
+    i = 0;
+#if defined(FBDEV_NEON)
+    uint8x8_t v5 = vld1_u8(d5);
+    uint8x8_t v6 = vld1_u8(d6);
+    for(; i + 8 <= w; i += 8) {
+        uint8x8x4_t px = vld4_u8((const uint8_t *)&src[i]);     /*b, g, r, a planes*/
+        uint8x8_t b = vqadd_u8(px.val[0], v5);
+        uint8x8_t g = vqadd_u8(px.val[1], v6);
+        uint8x8_t r = vqadd_u8(px.val[2], v5);
+        uint16x8_t out = vshll_n_u8(r, 8);
+        out = vsriq_n_u16(out, vshll_n_u8(g, 8), 5);
+        out = vsriq_n_u16(out, vshll_n_u8(b, 8), 11);
+        vst1q_u16(&dst[i], out);
+    }
+#elif defined(FBDEV_SSE2)
+    /*The pattern repeats every 4 pixels, one register holds the offsets for 4 pixels*/
+    uint32_t d32[4];
+    int32_t k;
+    for(k = 0; k < 4; k++) d32[k] = (d5[k] << 16) | (d6[k] << 8) | d5[k];
+    __m128i vd = _mm_loadu_si128((const __m128i *)d32);
+    __m128i mask_r = _mm_set1_epi32(0xF800);
+    __m128i mask_g = _mm_set1_epi32(0x07E0);
+    __m128i mask_b = _mm_set1_epi32(0x001F);
+    __m128i bias32 = _mm_set1_epi32(0x8000);
+    __m128i bias16 = _mm_set1_epi16((short)0x8000);
+    for(; i + 8 <= w; i += 8) {
+        __m128i p0 = _mm_adds_epu8(_mm_loadu_si128((const __m128i *)&src[i]), vd);
+        __m128i p1 = _mm_adds_epu8(_mm_loadu_si128((const __m128i *)&src[i + 4]), vd);
+        __m128i c0 = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(p0, 8), mask_r),
+                                  _mm_or_si128(_mm_and_si128(_mm_srli_epi32(p0, 5), mask_g),
+                                               _mm_and_si128(_mm_srli_epi32(p0, 3), mask_b)));
+        __m128i c1 = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(p1, 8), mask_r),
+                                  _mm_or_si128(_mm_and_si128(_mm_srli_epi32(p1, 5), mask_g),
+                                               _mm_and_si128(_mm_srli_epi32(p1, 3), mask_b)));
+        /*Signed saturating pack, biased so 16 bit values pass unchanged*/
+        __m128i out = _mm_packs_epi32(_mm_sub_epi32(c0, bias32), _mm_sub_epi32(c1, bias32));
+        _mm_storeu_si128((__m128i *)&dst[i], _mm_add_epi16(out, bias16));
+    }
+#endif
+
+    for(; i < w; i++) {
+        uint8_t r = sat_add_u8(src[i].ch.red, d5[i & 3]);
+        uint8_t g = sat_add_u8(src[i].ch.green, d6[i & 3]);
+        uint8_t b = sat_add_u8(src[i].ch.blue, d5[i & 3]);
+        dst[i] = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+    }
+}
+
+/**
+ * Convert a line of 32 bit pixels to 24 bit (B, G, R bytes)
+ * @param dst destination in the framebuffer
+ * @param src source pixels
+ * @param w number of pixels
+ */
+static void convert_888(uint8_t * dst, const lv_color_t * src, int32_t w)
+{
+    int32_t i = 0;
+#if defined(FBDEV_NEON)
+    for(; i + 8 <= w; i += 8) {
+        uint8x8x4_t px = vld4_u8((const uint8_t *)&src[i]);
+        uint8x8x3_t out = {{px.val[0], px.val[1], px.val[2]}};
+        vst3_u8(&dst[i * 3], out);
+    }
+#elif defined(FBDEV_SSSE3)
+    /*4 pixels per step, the 16 byte store writes 4 bytes beyond the 12 valid ones
+     *which are overwritten by the next step, keep 6 pixels in front to stay in the line*/
+    __m128i shuffle = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    for(; i + 6 <= w; i += 4) {
+        __m128i px = _mm_loadu_si128((const __m128i *)&src[i]);
+        _mm_storeu_si128((__m128i *)&dst[i * 3], _mm_shuffle_epi8(px, shuffle));
+    }
+#endif
+    for(; i < w; i++) {
+        dst[i * 3] = src[i].ch.blue;
+        dst[i * 3 + 1] = src[i].ch.green;
+        dst[i * 3 + 2] = src[i].ch.red;
+    }
+}
+
+/**
+ * Convert a line of 32 bit pixels using the channel offsets and lengths of the framebuffer
+ * @param dst destination in the framebuffer
+ * @param src source pixels
+ * @param w number of pixels
+ */
+static void convert_generic(uint8_t * dst, const lv_color_t * src, int32_t w)
+{
+#if USE_FBDEV
+    uint32_t bytes_pp = vinfo.bits_per_pixel / 8;
+    int32_t i;
+    uint32_t b;
+    for(i = 0; i < w; i++) {
+        uint32_t px = ((uint32_t)(src[i].ch.red >> (8 - vinfo.red.length)) << vinfo.red.offset) |
+                      ((uint32_t)(src[i].ch.green >> (8 - vinfo.green.length)) << vinfo.green.offset) |
+                      ((uint32_t)(src[i].ch.blue >> (8 - vinfo.blue.length)) << vinfo.blue.offset);
+        for(b = 0; b < bytes_pp; b++) {
+            *dst++ = px >> (b * 8);
+        }
+    }
+#else
+    (void) dst;
+    (void) src;
+    (void) w;
+#endif
+}
+#endif /*LV_COLOR_DEPTH == 32*/
+
+/**
+ * Copy a line into the framebuffer
+ * Long lines bypass the cache with streaming stores: the framebuffer is never read
+ * and the draw buffers stay cached for rendering the next stripe.
+ * @param dst destination in the framebuffer (4 byte aligned)
+ * @param src source pixels
+ * @param len number of bytes (multiple of 4)
+ */
+static void copy_line(void * dst, const void * src, size_t len)
+{
+#if defined(FBDEV_SSE2) && FBDEV_STREAM
+    if(len >= FBDEV_STREAM_MIN_BYTES) {
+        uint8_t * d = dst;
+        const uint8_t * s8 = src;
+        /*Align the destination to 16 bytes*/
+        while(((uintptr_t)d & 0xF) && len) {
+            _mm_stream_si32((int *)d, *(const int *)s8);
+            d += 4;
+            s8 += 4;
+            len -= 4;
+        }
+        for(; len >= 64; len -= 64, d += 64, s8 += 64) {
+            __m128i a = _mm_loadu_si128((const __m128i *)s8);
+            __m128i b = _mm_loadu_si128((const __m128i *)(s8 + 16));
+            __m128i c = _mm_loadu_si128((const __m128i *)(s8 + 32));
+            __m128i e = _mm_loadu_si128((const __m128i *)(s8 + 48));
+            _mm_stream_si128((__m128i *)d, a);
+            _mm_stream_si128((__m128i *)(d + 16), b);
+            _mm_stream_si128((__m128i *)(d + 32), c);
+            _mm_stream_si128((__m128i *)(d + 48), e);
+        }
+        for(; len >= 4; len -= 4, d += 4, s8 += 4) {
+            _mm_stream_si32((int *)d, *(const int *)s8);
+        }
+        return;
+    }
+#endif
+    memcpy(dst, src, len);
+}
+
+/**
+ * Get the time of the monotonic clock
+ * @return the time in microseconds
+ */
+static uint64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/**
+ * Copy a rendered area into the framebuffer
+ * @param area an area where to copy `color_p`
+ * @param color_p an array of pixel to copy to the `area` part of the screen
+ */
+static void fbdev_copy(const lv_area_t * area, lv_color_t * color_p)
 {
     if(fbp == NULL ||
             area->x2 < 0 ||
             area->y2 < 0 ||
             area->x1 > (int32_t)vinfo.xres - 1 ||
             area->y1 > (int32_t)vinfo.yres - 1) {
-        lv_disp_flush_ready(drv);
         return;
     }
 
@@ -179,15 +829,36 @@ void fbdev_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color
     long int byte_location = 0;
     unsigned char bit_location = 0;
 
-    /*32 or 24 bit per pixel*/
-    if(vinfo.bits_per_pixel == 32 || vinfo.bits_per_pixel == 24) {
+#if LV_COLOR_DEPTH == 32
+    /*Converted formats, the source can be clipped on the left*/
+    if(fb_format != FB_FMT_NATIVE) {
+        lv_coord_t src_w = lv_area_get_width(area);
+        const lv_color_t * src = color_p + (act_y1 - area->y1) * src_w + (act_x1 - area->x1);
+        uint32_t bytes_pp = vinfo.bits_per_pixel / 8;
+        int32_t y;
+        for(y = act_y1; y <= act_y2; y++) {
+            uint8_t * dst = (uint8_t *)fbp + (act_x1 + vinfo.xoffset) * bytes_pp + (y + vinfo.yoffset) * finfo.line_length;
+            if(fb_format == FB_FMT_RGB565) convert_565((uint16_t *)dst, src, w, act_x1, y);
+            else if(fb_format == FB_FMT_RGB888) convert_888(dst, src, w);
+            else convert_generic(dst, src, w);
+            src += src_w;
+        }
+        return;
+    }
+#endif
+
+    /*32 bit per pixel*/
+    if(vinfo.bits_per_pixel == 32) {
         uint32_t * fbp32 = (uint32_t *)fbp;
         int32_t y;
         for(y = act_y1; y <= act_y2; y++) {
             location = (act_x1 + vinfo.xoffset) + (y + vinfo.yoffset) * finfo.line_length / 4;
-            memcpy(&fbp32[location], (uint32_t *)color_p, (act_x2 - act_x1 + 1) * 4);
+            copy_line(&fbp32[location], color_p, (act_x2 - act_x1 + 1) * 4);
             color_p += w;
         }
+#if defined(FBDEV_SSE2) && FBDEV_STREAM
+        _mm_sfence();   /*order the streaming stores before the flush is reported ready*/
+#endif
     }
     /*16 bit per pixel*/
     else if(vinfo.bits_per_pixel == 16) {
@@ -232,12 +903,82 @@ void fbdev_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color
 
     //May be some direct update command is required
     //ret = ioctl(state->fd, FBIO_UPDATE, (unsigned long)((uintptr_t)rect));
+}
 
-    lv_disp_flush_ready(drv);
+static void * flush_thread_main(void * arg)
+{
+    (void) arg;
+    pthread_mutex_lock(&flush_mutex);
+    while(true) {
+        while(!flush_busy && !flush_stop) {
+            pthread_cond_wait(&flush_cond, &flush_mutex);
+        }
+        if(!flush_busy) break;      /*stopped and nothing left to copy*/
+        pthread_mutex_unlock(&flush_mutex);
+
+        uint64_t start = now_us();
+        fbdev_copy(&flush_area, flush_color_p);
+        uint64_t copy_us = now_us() - start;
+
+        /*Release the slot before LVGL can see the flush is ready and hand over the next stripe*/
+        pthread_mutex_lock(&flush_mutex);
+        async_flushes++;
+        async_copy_us += copy_us;
+        async_px += lv_area_get_size(&flush_area);
+        flush_busy = false;
+        lv_disp_flush_ready(flush_drv);
+        pthread_cond_broadcast(&flush_cond);
+    }
+    pthread_mutex_unlock(&flush_mutex);
+    return NULL;
 }
 
-/**********************
- *   STATIC FUNCTIONS
- **********************/
+#if USE_FBDEV
+static void * vsync_thread_main(void * arg)
+{
+    (void) arg;
+    uint32_t crtc = 0;
+    bool stop = false;
+    while(!stop) {
+        int res = ioctl(fbfd, FBIO_WAITFORVSYNC, &crtc);
+        uint64_t t = now_us();
+
+        pthread_mutex_lock(&vsync_mutex);
+        if(res == 0) {
+            /*Average the period, gaps (e.g. a blanked display) are not counted*/
+            uint32_t dt = t - vsync_last_us;
+            if(dt < vsync_period_us * 3 / 2) vsync_period_us = (vsync_period_us * 7 + dt) / 8;
+            vsync_last_us = t;
+            vsync_count++;
+        }
+        if(pan_pending) {
+            /*Also on errors, LVGL waits for it*/
+            pan_display(pan_yoffset);
+            if(res == 0) vsync_pans++;
+            pan_pending = false;
+            lv_disp_flush_ready(pan_drv);
+            pthread_cond_broadcast(&vsync_cond);
+        }
+        stop = vsync_stop;
+        pthread_mutex_unlock(&vsync_mutex);
+
+        if(res == -1 && !stop) usleep(vsync_period_us);
+    }
+    return NULL;
+}
+
+/**
+ * Show the page starting at a line of the virtual resolution
+ */
+static void pan_display(uint32_t yoffset)
+{
+    struct fb_var_screeninfo pan = vinfo;
+    pan.xoffset = 0;
+    pan.yoffset = yoffset;
+    if(ioctl(fbfd, FBIOPAN_DISPLAY, &pan) == -1) {
+        perror("Error: FBIOPAN_DISPLAY");
+    }
+}
+#endif
 
 #endif
@@ -43,6 +43,18 @@ extern "C" {
 void fbdev_init(void);
 void fbdev_exit(void);
 void fbdev_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+void fbdev_get_sizes(uint32_t * width, uint32_t * height);
+uint32_t fbdev_page_flip_init(void ** buf1, void ** buf2);
+void fbdev_flip(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+void fbdev_flip_wait(lv_disp_drv_t * drv);
+bool fbdev_flush_thread_start(void);
+void fbdev_flush_thread_stop(void);
+void fbdev_flush_async(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+void fbdev_flush_wait(lv_disp_drv_t * drv);
+bool fbdev_vsync_start(void);
+void fbdev_vsync_stop(void);
+bool fbdev_vsync_get(uint32_t * count, uint64_t * vblank_us, uint32_t * period_us);
+void fbdev_set_dither(bool enable);
 
 
 /**********************
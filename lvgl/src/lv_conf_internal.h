@@ -77,6 +77,18 @@
 #define LV_DISP_DEF_REFR_PERIOD      30      /*[ms]*/
 #endif
 
+/* Mark invalidated areas in a bitmap of tiles instead of a list of areas.
+ * The refreshed areas are the horizontal spans of marked tiles, so bursts
+ * of small invalidations never fall back to refreshing the whole screen.*/
+#ifndef LV_INV_TILES
+#define LV_INV_TILES        0
+#endif
+#if LV_INV_TILES
+#ifndef LV_INV_TILE_SIZE
+#define LV_INV_TILE_SIZE    32      /*[px] width and height of a tile*/
+#endif
+#endif
+
 /* Dot Per Inch: used to initialize default sizes.
  * E.g. a button with width = LV_DPI / 2 -> half inch wide
  * (Not so important, you can adjust it to modify default sizes and spaces)*/
@@ -235,6 +247,26 @@
 #ifndef LV_SHADOW_CACHE_SIZE
 #define LV_SHADOW_CACHE_SIZE    0
 #endif
+
+/* Number of shadow shapes buffered, the least recently used one is replaced.
+ * The RAM cost is LV_SHADOW_CACHE_CNT * LV_SHADOW_CACHE_SIZE^2 */
+#ifndef LV_SHADOW_CACHE_CNT
+#define LV_SHADOW_CACHE_CNT     1
+#endif
+#endif
+
+/* Number of radii whose anti-aliased corner is buffered for the radius masks
+ * (rounded rectangles, circles). The corner is calculated once per radius and drawn from the table after it.
+ * A table takes about 10 * radius bytes, the least recently used ones are freed to make room for new radii.
+ * 0: Disable the buffering*/
+#ifndef LV_RADIUS_MASK_CACHE_CNT
+#define LV_RADIUS_MASK_CACHE_CNT    0
+#endif
+
+/* Max. memory of the buffered corners in bytes (from the LVGL heap).
+ * Larger corners are calculated on every draw*/
+#ifndef LV_RADIUS_MASK_CACHE_SIZE
+#define LV_RADIUS_MASK_CACHE_SIZE   4096
 #endif
 
 /* 1: Use other blend modes than normal (`LV_BLEND_MODE_...`)*/
@@ -267,6 +299,12 @@
 #define LV_USE_GPU_STM32_DMA2D  0
 #endif
 
+/* 1: Blend with NEON/SSE2/AVX2 kernels, selected for the CPU at run time.
+ * Bit-exact with the software rendering, LV_COLOR_DEPTH 32 only*/
+#ifndef LV_USE_BLEND_SIMD
+#define LV_USE_BLEND_SIMD       0
+#endif
+
 /* 1: Enable file system (might be required for images */
 #ifndef LV_USE_FILESYSTEM
 #define LV_USE_FILESYSTEM       1
@@ -309,11 +347,19 @@
  * (I.e. no new image decoder is added)
  * With complex image decoders (e.g. PNG or JPG) caching can save the continuous open/decode of images.
  * However the opened images might consume additional RAM.
+ * The least recently used images are closed first.
  * LV_IMG_CACHE_DEF_SIZE must be >= 1 */
 #ifndef LV_IMG_CACHE_DEF_SIZE
 #define LV_IMG_CACHE_DEF_SIZE       1
 #endif
 
+/* Default memory budget of the image cache in bytes.
+ * The cache entries, the images decoded to RAM and the decoders' data (e.g. palettes, file handles) are counted.
+ * The image opened last is always kept. 0: Limit only the number of images */
+#ifndef LV_IMG_CACHE_DEF_MEM_SIZE
+#define LV_IMG_CACHE_DEF_MEM_SIZE   0
+#endif
+
 /*Declare the type of the user data of image decoder (can be e.g. `void *`, `int`, `struct`)*/
 
 /*=====================
@@ -569,6 +615,32 @@
 #define LV_FONT_FMT_TXT_LARGE   0
 #endif
 
+/* Cache the glyphs of the built-in format fonts as A8 bitmaps.
+ * Frequently drawn letters skip the glyph search and the decompression.
+ * Number of cached glyphs, 0: disable the cache*/
+#ifndef LV_FONT_FMT_TXT_CACHE_CNT
+#define LV_FONT_FMT_TXT_CACHE_CNT   0
+#endif
+
+/* Max. memory of the cached bitmaps in bytes (allocated with `lv_mem_alloc`)*/
+#ifndef LV_FONT_FMT_TXT_CACHE_SIZE
+#define LV_FONT_FMT_TXT_CACHE_SIZE  (8 * 1024)
+#endif
+
+/* 1: Look up the glyph ids (and kerning pairs) of U+0020..U+007F and the degree sign
+ * with a direct index built on the first use of a font.
+ * Takes ~200 bytes per font (+9 kB with kerning pairs instead of kerning classes)*/
+#ifndef LV_FONT_FMT_TXT_FAST_INDEX
+#define LV_FONT_FMT_TXT_FAST_INDEX  0
+#endif
+
+/* 1: Load fonts in the binary format of lv_font_conv (`--format bin`) from memory
+ * with `lv_font_load_bin()`. The glyph bitmaps and tables are used in place
+ * so the data can be e.g. a memory mapped file*/
+#ifndef LV_USE_FONT_LOADER
+#define LV_USE_FONT_LOADER  0
+#endif
+
 /* Set the pixel order of the display.
  * Important only if "subpx fonts" are used.
  * With "normal" font it doesn't matter.
@@ -749,6 +821,14 @@
 #define LV_USE_OBJ_REALIGN          1
 #endif
 
+/* Cache the style properties resolved by the `lv_obj_get_style_...()` functions
+ * so drawing an unchanged object doesn't search its style lists and its parents again.
+ * Number of cached properties of all objects, 0: disable the cache.
+ * Takes 16 bytes (32 bytes with 64 bit pointers) per property*/
+#ifndef LV_STYLE_CACHE_CNT
+#define LV_STYLE_CACHE_CNT          0
+#endif
+
 /* Enable to make the object clickable on a larger area.
  * LV_EXT_CLICK_AREA_OFF or 0: Disable this feature
  * LV_EXT_CLICK_AREA_TINY: The extra area can be adjusted horizontally and vertically (0..255 px)
@@ -72,6 +72,25 @@ typedef struct {
     } end_value;
 } lv_style_trans_t;
 
+#if LV_STYLE_CACHE_CNT
+typedef struct {
+    const lv_style_list_t * list;   /*Style list of the looked up part*/
+    const lv_obj_t * obj;           /*The object whose part was looked up*/
+    lv_style_property_t prop;       /*The property ORed with the state of the part*/
+    uint16_t id;                    /*`cache_id` of the list when the value was resolved*/
+} style_cache_key_t;
+
+typedef struct {
+    style_cache_key_t key;
+    union {
+        lv_color_t _color;
+        lv_style_int_t _int;
+        lv_opa_t _opa;
+        const void * _ptr;
+    } value;
+} style_cache_entry_t;
+#endif
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
@@ -80,6 +99,16 @@ static lv_res_t lv_obj_signal(lv_obj_t * obj, lv_signal_t sign, void * param);
 static void refresh_children_position(lv_obj_t * obj, lv_coord_t x_diff, lv_coord_t y_diff);
 static void report_style_mod_core(void * style_p, lv_obj_t * obj);
 static void refresh_children_style(lv_obj_t * obj);
+static lv_style_int_t get_style_int(const lv_obj_t * obj, uint8_t part, lv_style_property_t prop);
+static lv_color_t get_style_color(const lv_obj_t * obj, uint8_t part, lv_style_property_t prop);
+static lv_opa_t get_style_opa(const lv_obj_t * obj, uint8_t part, lv_style_property_t prop);
+static const void * get_style_ptr(const lv_obj_t * obj, uint8_t part, lv_style_property_t prop);
+#if LV_STYLE_CACHE_CNT
+static const style_cache_entry_t * style_cache_find(const lv_obj_t * obj, uint8_t part, lv_style_property_t prop,
+                                                    style_cache_key_t * key);
+static style_cache_entry_t * style_cache_add(const style_cache_key_t * key);
+static void style_cache_invalidate(lv_obj_t * obj, bool children);
+#endif
 static void base_dir_refr_children(lv_obj_t * obj);
 #if LV_USE_ANIMATION
 static lv_style_trans_t * trans_create(lv_obj_t * obj, lv_style_property_t prop, uint8_t part, lv_state_t prev_state,
@@ -101,6 +130,13 @@ static void obj_del_core(lv_obj_t * obj);
 static bool lv_initialized = false;
 static lv_event_temp_data_t * event_temp_data_head;
 static const void * event_act_data;
+#if LV_STYLE_CACHE_CNT
+static style_cache_entry_t style_cache[LV_STYLE_CACHE_CNT];
+static uint16_t style_cache_id_last;
+static uint32_t style_cache_hit_cnt;
+static uint32_t style_cache_miss_cnt;
+static uint32_t style_cache_entry_cnt;
+#endif
 
 /**********************
  *      MACROS
@@ -157,6 +193,7 @@ void lv_init(void)
 
     _lv_img_decoder_init();
     lv_img_cache_set_size(LV_IMG_CACHE_DEF_SIZE);
+    lv_img_cache_set_mem_size(LV_IMG_CACHE_DEF_MEM_SIZE);
 
     lv_initialized = true;
     LV_LOG_INFO("lv_init ready");
@@ -582,6 +619,10 @@ void lv_obj_set_parent(lv_obj_t * obj, lv_obj_t * parent)
     _lv_ll_chg_list(&obj->parent->child_ll, &parent->child_ll, obj, true);
     obj->parent = parent;
 
+#if LV_STYLE_CACHE_CNT
+    /*The inherited properties come from the new parent*/
+    style_cache_invalidate(obj, true);
+#endif
 
     if(new_base_dir != LV_BIDI_DIR_RTL) {
         lv_obj_set_pos(obj, old_pos.x, old_pos.y);
@@ -1295,8 +1336,12 @@ bool lv_obj_remove_style_local_prop(lv_obj_t * obj, uint8_t part, lv_style_prope
 {
     LV_ASSERT_OBJ(obj, LV_OBJX_NAME);
     lv_style_t * style = lv_obj_get_local_style(obj, part);
-    if(style) return lv_style_remove_prop(style, prop);
-    else return false;
+    if(style == NULL) return false;
+
+#if LV_STYLE_CACHE_CNT
+    style_cache_invalidate(obj, prop & LV_STYLE_INHERIT_MASK);
+#endif
+    return lv_style_remove_prop(style, prop);
 }
 
 /**
@@ -1308,6 +1353,10 @@ void lv_obj_refresh_style(lv_obj_t * obj, lv_style_property_t prop)
 {
     LV_ASSERT_OBJ(obj, LV_OBJX_NAME);
 
+#if LV_STYLE_CACHE_CNT
+    style_cache_invalidate(obj, prop == LV_STYLE_PROP_ALL || (prop & LV_STYLE_INHERIT_MASK));
+#endif
+
     /*If a real style refresh is required*/
     bool real_refr = false;
     switch(prop) {
@@ -1395,6 +1444,35 @@ void lv_obj_report_style_mod(lv_style_t * style)
     }
 }
 
+#if LV_STYLE_CACHE_CNT
+/**
+ * Drop the cached style properties of an object and its children.
+ * Only required if a style is modified directly without `lv_obj_report_style_mod()`.
+ * @param obj pointer to an object or NULL to drop the properties of all objects
+ */
+void lv_obj_style_cache_invalidate(lv_obj_t * obj)
+{
+    if(obj) {
+        style_cache_invalidate(obj, true);
+    }
+    else {
+        _lv_memset_00(style_cache, sizeof(style_cache));
+        style_cache_entry_cnt = 0;
+    }
+}
+
+/**
+ * Get the usage of the style cache
+ * @param info store the result here
+ */
+void lv_obj_style_cache_get_info(lv_obj_style_cache_info_t * info)
+{
+    info->hit_cnt = style_cache_hit_cnt;
+    info->miss_cnt = style_cache_miss_cnt;
+    info->entry_cnt = style_cache_entry_cnt;
+}
+#endif
+
 /*-----------------
  * Attribute set
  *----------------*/
@@ -2377,51 +2455,18 @@ lv_style_list_t * lv_obj_get_style_list(const lv_obj_t * obj, uint8_t part)
  */
 lv_style_int_t _lv_obj_get_style_int(const lv_obj_t * obj, uint8_t part, lv_style_property_t prop)
 {
-    lv_style_property_t prop_ori = prop;
-
-    lv_style_attr_t attr;
-    attr.full = prop_ori >> 8;
-
-    lv_style_int_t value_act;
-    lv_res_t res = LV_RES_INV;
-    const lv_obj_t * parent = obj;
-    while(parent) {
-        lv_style_list_t * dsc = lv_obj_get_style_list(parent, part);
-
-        lv_state_t state = lv_obj_get_state(parent, part);
-        prop = (uint16_t)prop_ori + ((uint16_t)state << LV_STYLE_STATE_POS);
-
-        res = _lv_style_list_get_int(dsc, prop, &value_act);
-        if(res == LV_RES_OK) return value_act;
-
-        if(attr.bits.inherit == 0) break;
-
-        /*If not found, check the `MAIN` style first*/
-        if(part != LV_OBJ_PART_MAIN) {
-            part = LV_OBJ_PART_MAIN;
-            continue;
-        }
+#if LV_STYLE_CACHE_CNT
+    style_cache_key_t key;
+    const style_cache_entry_t * cached = style_cache_find(obj, part, prop, &key);
+    if(cached) return cached->value._int;
 
-        /*Check the parent too.*/
-        parent = lv_obj_get_parent(parent);
-    }
-
-    /*Handle unset values*/
-    prop = prop & (~LV_STYLE_STATE_MASK);
-    switch(prop) {
-        case LV_STYLE_BORDER_SIDE:
-            return LV_BORDER_SIDE_FULL;
-        case LV_STYLE_SIZE:
-            return LV_DPI / 20;
-        case LV_STYLE_SCALE_WIDTH:
-            return LV_DPI / 8;
-        case LV_STYLE_BG_GRAD_STOP:
-            return 255;
-        case LV_STYLE_TRANSFORM_ZOOM:
-            return LV_IMG_ZOOM_NONE;
-    }
-
-    return 0;
+    lv_style_int_t value = get_style_int(obj, part, prop);
+    style_cache_entry_t * entry = style_cache_add(&key);
+    if(entry) entry->value._int = value;
+    return value;
+#else
+    return get_style_int(obj, part, prop);
+#endif
 }
 
 /**
@@ -2440,44 +2485,18 @@ lv_style_int_t _lv_obj_get_style_int(const lv_obj_t * obj, uint8_t part, lv_styl
  */
 lv_color_t _lv_obj_get_style_color(const lv_obj_t * obj, uint8_t part, lv_style_property_t prop)
 {
-    lv_style_property_t prop_ori = prop;
-
-    lv_style_attr_t attr;
-    attr.full = prop_ori >> 8;
-
-    lv_color_t value_act;
-    lv_res_t res = LV_RES_INV;
-    const lv_obj_t * parent = obj;
-    while(parent) {
-        lv_style_list_t * dsc = lv_obj_get_style_list(parent, part);
+#if LV_STYLE_CACHE_CNT
+    style_cache_key_t key;
+    const style_cache_entry_t * cached = style_cache_find(obj, part, prop, &key);
+    if(cached) return cached->value._color;
 
-        lv_state_t state = lv_obj_get_state(parent, part);
-        prop = (uint16_t)prop_ori + ((uint16_t)state << LV_STYLE_STATE_POS);
-
-        res = _lv_style_list_get_color(dsc, prop, &value_act);
-        if(res == LV_RES_OK) return value_act;
-
-        if(attr.bits.inherit == 0) break;
-
-        /*If not found, check the `MAIN` style first*/
-        if(part != LV_OBJ_PART_MAIN) {
-            part = LV_OBJ_PART_MAIN;
-            continue;
-        }
-
-        /*Check the parent too.*/
-        parent = lv_obj_get_parent(parent);
-    }
-
-    /*Handle unset values*/
-    prop = prop & (~LV_STYLE_STATE_MASK);
-    switch(prop) {
-        case LV_STYLE_BG_COLOR:
-        case LV_STYLE_BG_GRAD_COLOR:
-            return LV_COLOR_WHITE;
-    }
-
-    return LV_COLOR_BLACK;
+    lv_color_t value = get_style_color(obj, part, prop);
+    style_cache_entry_t * entry = style_cache_add(&key);
+    if(entry) entry->value._color = value;
+    return value;
+#else
+    return get_style_color(obj, part, prop);
+#endif
 }
 
 /**
@@ -2496,45 +2515,18 @@ lv_color_t _lv_obj_get_style_color(const lv_obj_t * obj, uint8_t part, lv_style_
  */
 lv_opa_t _lv_obj_get_style_opa(const lv_obj_t * obj, uint8_t part, lv_style_property_t prop)
 {
-    lv_style_property_t prop_ori = prop;
-
-    lv_style_attr_t attr;
-    attr.full = prop_ori >> 8;
-
-    lv_opa_t value_act;
-    lv_res_t res = LV_RES_INV;
-    const lv_obj_t * parent = obj;
-    while(parent) {
-        lv_style_list_t * dsc = lv_obj_get_style_list(parent, part);
-
-        lv_state_t state = lv_obj_get_state(parent, part);
-        prop = (uint16_t)prop_ori + ((uint16_t)state << LV_STYLE_STATE_POS);
-
-        res = _lv_style_list_get_opa(dsc, prop, &value_act);
-        if(res == LV_RES_OK) return value_act;
-
-        if(attr.bits.inherit == 0) break;
+#if LV_STYLE_CACHE_CNT
+    style_cache_key_t key;
+    const style_cache_entry_t * cached = style_cache_find(obj, part, prop, &key);
+    if(cached) return cached->value._opa;
 
-        /*If not found, check the `MAIN` style first*/
-        if(part != LV_OBJ_PART_MAIN) {
-            part = LV_OBJ_PART_MAIN;
-            continue;
-        }
-
-        /*Check the parent too.*/
-        parent = lv_obj_get_parent(parent);
-    }
-
-    /*Handle unset values*/
-    prop = prop & (~LV_STYLE_STATE_MASK);
-    switch(prop) {
-        case LV_STYLE_BG_OPA:
-        case LV_STYLE_IMAGE_RECOLOR_OPA:
-        case LV_STYLE_PATTERN_RECOLOR_OPA:
-            return LV_OPA_TRANSP;
-    }
-
-    return LV_OPA_COVER;
+    lv_opa_t value = get_style_opa(obj, part, prop);
+    style_cache_entry_t * entry = style_cache_add(&key);
+    if(entry) entry->value._opa = value;
+    return value;
+#else
+    return get_style_opa(obj, part, prop);
+#endif
 }
 
 /**
@@ -2553,48 +2545,18 @@ lv_opa_t _lv_obj_get_style_opa(const lv_obj_t * obj, uint8_t part, lv_style_prop
  */
 const void * _lv_obj_get_style_ptr(const lv_obj_t * obj, uint8_t part, lv_style_property_t prop)
 {
-    lv_style_property_t prop_ori = prop;
-
-    lv_style_attr_t attr;
-    attr.full = prop_ori >> 8;
+#if LV_STYLE_CACHE_CNT
+    style_cache_key_t key;
+    const style_cache_entry_t * cached = style_cache_find(obj, part, prop, &key);
+    if(cached) return cached->value._ptr;
 
-    const void * value_act;
-    lv_res_t res = LV_RES_INV;
-    const lv_obj_t * parent = obj;
-    while(parent) {
-        lv_style_list_t * dsc = lv_obj_get_style_list(parent, part);
-
-        lv_state_t state = lv_obj_get_state(parent, part);
-        prop = (uint16_t)prop_ori + ((uint16_t)state << LV_STYLE_STATE_POS);
-
-        res = _lv_style_list_get_ptr(dsc, prop, &value_act);
-        if(res == LV_RES_OK)  return value_act;
-
-        if(attr.bits.inherit == 0) break;
-
-        /*If not found, check the `MAIN` style first*/
-        if(part != LV_OBJ_PART_MAIN) {
-            part = LV_OBJ_PART_MAIN;
-            continue;
-        }
-
-        /*Check the parent too.*/
-        parent = lv_obj_get_parent(parent);
-    }
-
-    /*Handle unset values*/
-    prop = prop & (~LV_STYLE_STATE_MASK);
-    switch(prop) {
-        case LV_STYLE_TEXT_FONT:
-        case LV_STYLE_VALUE_FONT:
-            return lv_theme_get_font_normal();
-#if LV_USE_ANIMATION
-        case LV_STYLE_TRANSITION_PATH:
-            return &lv_anim_path_def;
+    const void * value = get_style_ptr(obj, part, prop);
+    style_cache_entry_t * entry = style_cache_add(&key);
+    if(entry) entry->value._ptr = value;
+    return value;
+#else
+    return get_style_ptr(obj, part, prop);
 #endif
-    }
-
-    return NULL;
 }
 
 /**
@@ -3698,6 +3660,320 @@ static void refresh_children_style(lv_obj_t * obj)
     }
 }
 
+/**
+ * Search the style lists of a part, the main part and the parents (for inherited properties) for a property
+ * @param obj pointer to an object
+ * @param part the part of the object which style property should be get.
+ * @param prop the property to get without state
+ * @return the value of the property or the default value if not found
+ */
+static lv_style_int_t get_style_int(const lv_obj_t * obj, uint8_t part, lv_style_property_t prop)
+{
+    lv_style_property_t prop_ori = prop;
+
+    lv_style_attr_t attr;
+    attr.full = prop_ori >> 8;
+
+    lv_style_int_t value_act;
+    lv_res_t res = LV_RES_INV;
+    const lv_obj_t * parent = obj;
+    while(parent) {
+        lv_style_list_t * dsc = lv_obj_get_style_list(parent, part);
+
+        lv_state_t state = lv_obj_get_state(parent, part);
+        prop = (uint16_t)prop_ori + ((uint16_t)state << LV_STYLE_STATE_POS);
+
+        res = _lv_style_list_get_int(dsc, prop, &value_act);
+        if(res == LV_RES_OK) return value_act;
+
+        if(attr.bits.inherit == 0) break;
+
+        /*If not found, check the `MAIN` style first*/
+        if(part != LV_OBJ_PART_MAIN) {
+            part = LV_OBJ_PART_MAIN;
+            continue;
+        }
+
+        /*Check the parent too.*/
+        parent = lv_obj_get_parent(parent);
+    }
+
+    /*Handle unset values*/
+    prop = prop & (~LV_STYLE_STATE_MASK);
+    switch(prop) {
+        case LV_STYLE_BORDER_SIDE:
+            return LV_BORDER_SIDE_FULL;
+        case LV_STYLE_SIZE:
+            return LV_DPI / 20;
+        case LV_STYLE_SCALE_WIDTH:
+            return LV_DPI / 8;
+        case LV_STYLE_BG_GRAD_STOP:
+            return 255;
+        case LV_STYLE_TRANSFORM_ZOOM:
+            return LV_IMG_ZOOM_NONE;
+    }
+
+    return 0;
+}
+
+/**
+ * Search the style lists of a part, the main part and the parents (for inherited properties) for a property
+ * @param obj pointer to an object
+ * @param part the part of the object which style property should be get.
+ * @param prop the property to get without state
+ * @return the value of the property or the default value if not found
+ */
+static lv_color_t get_style_color(const lv_obj_t * obj, uint8_t part, lv_style_property_t prop)
+{
+    lv_style_property_t prop_ori = prop;
+
+    lv_style_attr_t attr;
+    attr.full = prop_ori >> 8;
+
+    lv_color_t value_act;
+    lv_res_t res = LV_RES_INV;
+    const lv_obj_t * parent = obj;
+    while(parent) {
+        lv_style_list_t * dsc = lv_obj_get_style_list(parent, part);
+
+        lv_state_t state = lv_obj_get_state(parent, part);
+        prop = (uint16_t)prop_ori + ((uint16_t)state << LV_STYLE_STATE_POS);
+
+        res = _lv_style_list_get_color(dsc, prop, &value_act);
+        if(res == LV_RES_OK) return value_act;
+
+        if(attr.bits.inherit == 0) break;
+
+        /*If not found, check the `MAIN` style first*/
+        if(part != LV_OBJ_PART_MAIN) {
+            part = LV_OBJ_PART_MAIN;
+            continue;
+        }
+
+        /*Check the parent too.*/
+        parent = lv_obj_get_parent(parent);
+    }
+
+    /*Handle unset values*/
+    prop = prop & (~LV_STYLE_STATE_MASK);
+    switch(prop) {
+        case LV_STYLE_BG_COLOR:
+        case LV_STYLE_BG_GRAD_COLOR:
+            return LV_COLOR_WHITE;
+    }
+
+    return LV_COLOR_BLACK;
+}
+
+/**
+ * Search the style lists of a part, the main part and the parents (for inherited properties) for a property
+ * @param obj pointer to an object
+ * @param part the part of the object which style property should be get.
+ * @param prop the property to get without state
+ * @return the value of the property or the default value if not found
+ */
+static lv_opa_t get_style_opa(const lv_obj_t * obj, uint8_t part, lv_style_property_t prop)
+{
+    lv_style_property_t prop_ori = prop;
+
+    lv_style_attr_t attr;
+    attr.full = prop_ori >> 8;
+
+    lv_opa_t value_act;
+    lv_res_t res = LV_RES_INV;
+    const lv_obj_t * parent = obj;
+    while(parent) {
+        lv_style_list_t * dsc = lv_obj_get_style_list(parent, part);
+
+        lv_state_t state = lv_obj_get_state(parent, part);
+        prop = (uint16_t)prop_ori + ((uint16_t)state << LV_STYLE_STATE_POS);
+
+        res = _lv_style_list_get_opa(dsc, prop, &value_act);
+        if(res == LV_RES_OK) return value_act;
+
+        if(attr.bits.inherit == 0) break;
+
+        /*If not found, check the `MAIN` style first*/
+        if(part != LV_OBJ_PART_MAIN) {
+            part = LV_OBJ_PART_MAIN;
+            continue;
+        }
+
+        /*Check the parent too.*/
+        parent = lv_obj_get_parent(parent);
+    }
+
+    /*Handle unset values*/
+    prop = prop & (~LV_STYLE_STATE_MASK);
+    switch(prop) {
+        case LV_STYLE_BG_OPA:
+        case LV_STYLE_IMAGE_RECOLOR_OPA:
+        case LV_STYLE_PATTERN_RECOLOR_OPA:
+            return LV_OPA_TRANSP;
+    }
+
+    return LV_OPA_COVER;
+}
+
+/**
+ * Search the style lists of a part, the main part and the parents (for inherited properties) for a property
+ * @param obj pointer to an object
+ * @param part the part of the object which style property should be get.
+ * @param prop the property to get without state
+ * @return the value of the property or the default value if not found
+ */
+static const void * get_style_ptr(const lv_obj_t * obj, uint8_t part, lv_style_property_t prop)
+{
+    lv_style_property_t prop_ori = prop;
+
+    lv_style_attr_t attr;
+    attr.full = prop_ori >> 8;
+
+    const void * value_act;
+    lv_res_t res = LV_RES_INV;
+    const lv_obj_t * parent = obj;
+    while(parent) {
+        lv_style_list_t * dsc = lv_obj_get_style_list(parent, part);
+
+        lv_state_t state = lv_obj_get_state(parent, part);
+        prop = (uint16_t)prop_ori + ((uint16_t)state << LV_STYLE_STATE_POS);
+
+        res = _lv_style_list_get_ptr(dsc, prop, &value_act);
+        if(res == LV_RES_OK)  return value_act;
+
+        if(attr.bits.inherit == 0) break;
+
+        /*If not found, check the `MAIN` style first*/
+        if(part != LV_OBJ_PART_MAIN) {
+            part = LV_OBJ_PART_MAIN;
+            continue;
+        }
+
+        /*Check the parent too.*/
+        parent = lv_obj_get_parent(parent);
+    }
+
+    /*Handle unset values*/
+    prop = prop & (~LV_STYLE_STATE_MASK);
+    switch(prop) {
+        case LV_STYLE_TEXT_FONT:
+        case LV_STYLE_VALUE_FONT:
+            return lv_theme_get_font_normal();
+#if LV_USE_ANIMATION
+        case LV_STYLE_TRANSITION_PATH:
+            return &lv_anim_path_def;
+#endif
+    }
+
+    return NULL;
+}
+
+#if LV_STYLE_CACHE_CNT
+
+static inline uint32_t style_cache_hash(const style_cache_key_t * key)
+{
+    uint32_t h = (uint32_t)((uintptr_t)key->list >> 2) ^ ((uint32_t)((uintptr_t)key->obj >> 2) * 31);
+    h = (h ^ key->prop) * 0x9E3779B1;
+    return ((h >> 16) ^ h) % LV_STYLE_CACHE_CNT;
+}
+
+/**
+ * Look up a style property of an object's part in the style cache
+ * @param obj pointer to an object
+ * @param part the part of the object
+ * @param prop the property without state
+ * @param key store the key of the property here to add it with `style_cache_add()`
+ * @return the cached entry or NULL if the property is not cached
+ */
+static const style_cache_entry_t * style_cache_find(const lv_obj_t * obj, uint8_t part, lv_style_property_t prop,
+                                                    style_cache_key_t * key)
+{
+    /*Most lookups are for the main part, get its list without the signal*/
+    lv_style_list_t * list = part == LV_OBJ_PART_MAIN ? &((lv_obj_t *)obj)->style_list :
+                             lv_obj_get_style_list(obj, part);
+
+    /*A skipped transition style is used only temporarily (while creating transitions) so don't cache it*/
+    if(list == NULL || list->skip_trans) {
+        key->list = NULL;
+        return NULL;
+    }
+
+    if(list->cache_id == 0) {
+        style_cache_id_last++;
+        /*The ids will be reused so drop everything cached with the old ones*/
+        if(style_cache_id_last == 0) {
+            _lv_memset_00(style_cache, sizeof(style_cache));
+            style_cache_entry_cnt = 0;
+            style_cache_id_last = 1;
+        }
+        list->cache_id = style_cache_id_last;
+    }
+
+    key->list = list;
+    key->obj = obj;
+    /*Only the real parts have an own state which is asked with a signal*/
+    lv_state_t state = part < _LV_OBJ_PART_REAL_LAST ? obj->state : lv_obj_get_state(obj, part);
+    key->prop = prop + ((uint16_t)state << LV_STYLE_STATE_POS);
+    key->id = list->cache_id;
+
+    const style_cache_entry_t * entry = &style_cache[style_cache_hash(key)];
+    if(entry->key.list == key->list && entry->key.obj == key->obj &&
+       entry->key.prop == key->prop && entry->key.id == key->id) {
+        style_cache_hit_cnt++;
+        return entry;
+    }
+
+    style_cache_miss_cnt++;
+    return NULL;
+}
+
+/**
+ * Add a style property to the style cache. Replaces the property cached in its place.
+ * @param key the key from `style_cache_find()`
+ * @return the entry where the value should be stored or NULL if the property can't be cached
+ */
+static style_cache_entry_t * style_cache_add(const style_cache_key_t * key)
+{
+    if(key->list == NULL) return NULL;
+
+    style_cache_entry_t * entry = &style_cache[style_cache_hash(key)];
+    if(entry->key.list == NULL) style_cache_entry_cnt++;
+    entry->key = *key;
+    return entry;
+}
+
+/**
+ * Drop the cached style properties of all parts of an object
+ * @param obj pointer to an object
+ * @param children true: drop the properties of the children too, e.g. because an inherited property has changed
+ */
+static void style_cache_invalidate(lv_obj_t * obj, bool children)
+{
+    /*The virtual parts are followed by the real parts,
+     *e.g. the style lists of the widget's child objects*/
+    uint8_t part;
+    for(part = 0; part < _LV_OBJ_PART_REAL_LAST; part++) {
+        lv_style_list_t * list = lv_obj_get_style_list(obj, part);
+        if(list == NULL) break;
+        list->cache_id = 0;
+    }
+
+    for(part = _LV_OBJ_PART_REAL_LAST; part < LV_OBJ_PART_ALL; part++) {
+        lv_style_list_t * list = lv_obj_get_style_list(obj, part);
+        if(list == NULL) break;
+        list->cache_id = 0;
+    }
+
+    if(children) {
+        lv_obj_t * child;
+        _LV_LL_READ(obj->child_ll, child) {
+            style_cache_invalidate(child, true);
+        }
+    }
+}
+
+#endif /*LV_STYLE_CACHE_CNT*/
+
 static void base_dir_refr_children(lv_obj_t * obj)
 {
     lv_obj_t * child;
@@ -3853,6 +4129,9 @@ static void trans_del(lv_obj_t * obj, uint8_t part, lv_style_property_t prop, lv
             lv_style_list_t * list = lv_obj_get_style_list(tr->obj, tr->part);
             lv_style_t * style_trans = _lv_style_list_get_transition_style(list);
             lv_style_remove_prop(style_trans, tr->prop);
+#if LV_STYLE_CACHE_CNT
+            list->cache_id = 0;
+#endif
 
             lv_anim_del(tr, NULL);
             _lv_ll_remove(&LV_GC_ROOT(_lv_obj_style_trans_ll), tr);
@@ -3947,6 +4226,9 @@ static void trans_anim_ready_cb(lv_anim_t * a)
         lv_style_list_t * list = lv_obj_get_style_list(tr->obj, tr->part);
         lv_style_t * style_trans = _lv_style_list_get_transition_style(list);
         lv_style_remove_prop(style_trans, tr->prop);
+#if LV_STYLE_CACHE_CNT
+        list->cache_id = 0;
+#endif
     }
 
     _lv_ll_remove(&LV_GC_ROOT(_lv_obj_style_trans_ll), tr);
@@ -273,6 +273,15 @@ typedef struct {
     lv_state_t result;
 } lv_get_state_info_t;
 
+#if LV_STYLE_CACHE_CNT
+/*Usage of the style cache*/
+typedef struct {
+    uint32_t hit_cnt;       /*Style property lookups found in the cache*/
+    uint32_t miss_cnt;      /*Style property lookups resolved from the style lists*/
+    uint32_t entry_cnt;     /*Number of used cache entries*/
+} lv_obj_style_cache_info_t;
+#endif
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -544,6 +553,21 @@ void lv_obj_refresh_style(lv_obj_t * obj, lv_style_property_t prop);
  */
 void lv_obj_report_style_mod(lv_style_t * style);
 
+#if LV_STYLE_CACHE_CNT
+/**
+ * Drop the cached style properties of an object and its children.
+ * Only required if a style is modified directly without `lv_obj_report_style_mod()`.
+ * @param obj pointer to an object or NULL to drop the properties of all objects
+ */
+void lv_obj_style_cache_invalidate(lv_obj_t * obj);
+
+/**
+ * Get the usage of the style cache
+ * @param info store the result here
+ */
+void lv_obj_style_cache_get_info(lv_obj_style_cache_info_t * info);
+#endif
+
 /**
  * Set a local style property of a part of an object in a given state.
  * @param obj pointer to an object
@@ -39,7 +39,13 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+#if LV_INV_TILES
+static void lv_refr_mark_tiles(lv_disp_t * disp, const lv_area_t * area_p);
+static void lv_refr_tiles_to_areas(void);
+static void lv_refr_clear_tiles(lv_disp_t * disp);
+#else
 static void lv_refr_join_area(void);
+#endif
 static void lv_refr_areas(void);
 static void lv_refr_area(const lv_area_t * area_p);
 static void lv_refr_area_part(const lv_area_t * area_p);
@@ -110,6 +116,9 @@ void _lv_inv_area(lv_disp_t * disp, const lv_area_t * area_p)
     /*Clear the invalidate buffer if the parameter is NULL*/
     if(area_p == NULL) {
         disp->inv_p = 0;
+#if LV_INV_TILES
+        lv_refr_clear_tiles(disp);
+#endif
         return;
     }
 
@@ -128,6 +137,14 @@ void _lv_inv_area(lv_disp_t * disp, const lv_area_t * area_p)
     if(suc != false) {
         if(disp->driver.rounder_cb) disp->driver.rounder_cb(&disp->driver, &com_area);
 
+#if LV_INV_TILES
+        if(disp->inv_tiles) {
+            lv_refr_mark_tiles(disp, &com_area);
+            lv_task_set_prio(disp->refr_task, LV_REFR_TASK_PRIO);
+            return;
+        }
+#endif
+
         /*Save only if this area is not in one of the saved areas*/
         uint16_t i;
         for(i = 0; i < disp->inv_p; i++) {
@@ -190,10 +207,17 @@ void _lv_disp_refr_task(lv_task_t * task)
     /*Do nothing if there is no active screen*/
     if(disp_refr->act_scr == NULL) {
         disp_refr->inv_p = 0;
+#if LV_INV_TILES
+        lv_refr_clear_tiles(disp_refr);
+#endif
         return;
     }
 
+#if LV_INV_TILES
+    lv_refr_tiles_to_areas();
+#else
     lv_refr_join_area();
+#endif
 
     lv_refr_areas();
 
@@ -210,8 +234,9 @@ void _lv_disp_refr_task(lv_task_t * task)
             /* With true double buffering the flushing should be only the address change of the
              * current frame buffer. Wait until the address change is ready and copy the changed
              * content to the other frame buffer (new active VDB) to keep the buffers synchronized*/
-            while(vdb->flushing)
-                ;
+            while(vdb->flushing) {
+                if(disp_refr->driver.wait_cb) disp_refr->driver.wait_cb(&disp_refr->driver);
+            }
 
             uint8_t * buf_act = (uint8_t *)vdb->buf_act;
             uint8_t * buf_ina = (uint8_t *)vdb->buf_act == vdb->buf1 ? vdb->buf2 : vdb->buf1;
@@ -289,6 +314,7 @@ void _lv_disp_refr_task(lv_task_t * task)
  *   STATIC FUNCTIONS
  **********************/
 
+#if LV_INV_TILES == 0
 /**
  * Join the areas which has got common parts
  */
@@ -326,6 +352,122 @@ static void lv_refr_join_area(void)
     }
 }
 
+#else
+/**
+ * Mark the tiles covered by an area as invalid
+ * @param disp pointer to the display
+ * @param area_p the area, already truncated to the screen
+ */
+static void lv_refr_mark_tiles(lv_disp_t * disp, const lv_area_t * area_p)
+{
+    lv_coord_t col1 = area_p->x1 / LV_INV_TILE_SIZE;
+    lv_coord_t col2 = area_p->x2 / LV_INV_TILE_SIZE;
+    lv_coord_t row1 = area_p->y1 / LV_INV_TILE_SIZE;
+    lv_coord_t row2 = area_p->y2 / LV_INV_TILE_SIZE;
+
+    lv_coord_t row;
+    lv_coord_t col;
+    for(row = row1; row <= row2; row++) {
+        for(col = col1; col <= col2; col++) {
+            /*The part of the area in the tile*/
+            lv_area_t part;
+            part.x1 = LV_MATH_MAX(area_p->x1, col * LV_INV_TILE_SIZE);
+            part.x2 = LV_MATH_MIN(area_p->x2, (col + 1) * LV_INV_TILE_SIZE - 1);
+            part.y1 = LV_MATH_MAX(area_p->y1, row * LV_INV_TILE_SIZE);
+            part.y2 = LV_MATH_MIN(area_p->y2, (row + 1) * LV_INV_TILE_SIZE - 1);
+
+            uint32_t * word = &disp->inv_tiles[row * disp->inv_tile_words + (col >> 5)];
+            uint32_t bit = (uint32_t)1 << (col & 0x1F);
+            lv_area_t * ext = &disp->inv_tile_areas[row * disp->inv_tile_cols + col];
+            if(*word & bit) {
+                _lv_area_join(ext, ext, &part);
+            }
+            else {
+                lv_area_copy(ext, &part);
+                *word |= bit;
+            }
+        }
+    }
+    disp->inv_tiles_marked = 1;
+}
+
+/**
+ * Convert the invalidated tiles to areas. Every run of marked tiles in a tile row is an area
+ * limited to the invalidated extent of its tiles. Areas of consecutive rows with the same
+ * horizontal extent are merged.
+ */
+static void lv_refr_tiles_to_areas(void)
+{
+    if(disp_refr->inv_tiles_marked == 0) return;
+
+    lv_coord_t cols = disp_refr->inv_tile_cols;
+    lv_coord_t row;
+    for(row = 0; row < disp_refr->inv_tile_rows; row++) {
+        uint32_t * words = &disp_refr->inv_tiles[row * disp_refr->inv_tile_words];
+        lv_area_t * exts = &disp_refr->inv_tile_areas[row * cols];
+        lv_coord_t col = 0;
+        while(col < cols) {
+            uint32_t word = words[col >> 5];
+            if(word == 0 && (col & 0x1F) == 0) {
+                col += 32;          /*Skip 32 unmarked tiles*/
+                continue;
+            }
+            if((word & ((uint32_t)1 << (col & 0x1F))) == 0) {
+                col++;
+                continue;
+            }
+
+            /*Join the extent of the run of marked tiles*/
+            lv_area_t a;
+            lv_area_copy(&a, &exts[col]);
+            col++;
+            while(col < cols && (words[col >> 5] & ((uint32_t)1 << (col & 0x1F)))) {
+                _lv_area_join(&a, &a, &exts[col]);
+                col++;
+            }
+
+            /*Extend an area of the previous row if it has the same columns and they touch.
+             *Only an area ending on the last line of the previous row can touch this one.*/
+            uint16_t i;
+            bool merged = false;
+            for(i = 0; i < disp_refr->inv_p; i++) {
+                lv_area_t * p = &disp_refr->inv_areas[i];
+                if(p->x1 == a.x1 && p->x2 == a.x2 && p->y2 + 1 == a.y1) {
+                    p->y2 = a.y2;
+                    merged = true;
+                    break;
+                }
+            }
+            if(merged) continue;
+
+            if(disp_refr->inv_p < LV_INV_BUF_SIZE) {
+                lv_area_copy(&disp_refr->inv_areas[disp_refr->inv_p], &a);
+                disp_refr->inv_area_joined[disp_refr->inv_p] = 0;
+                disp_refr->inv_p++;
+            }
+            else {
+                /*No more place: grow the last area to cover this one too*/
+                lv_area_t * last = &disp_refr->inv_areas[LV_INV_BUF_SIZE - 1];
+                _lv_area_join(last, last, &a);
+            }
+        }
+    }
+
+    lv_refr_clear_tiles(disp_refr);
+}
+
+/**
+ * Clear the invalidated tiles
+ * @param disp pointer to the display
+ */
+static void lv_refr_clear_tiles(lv_disp_t * disp)
+{
+    if(disp->inv_tiles_marked == 0) return;
+    _lv_memset_00(disp->inv_tiles, disp->inv_tile_rows * disp->inv_tile_words * sizeof(uint32_t));
+    disp->inv_tiles_marked = 0;
+}
+#endif
+
 /**
  * Refresh the joined areas
  */
@@ -37,6 +37,7 @@
  **********************/
 LV_ATTRIBUTE_FAST_MEM static inline int32_t get_property_index(const lv_style_t * style, lv_style_property_t prop);
 static lv_style_t * get_alloc_local_style(lv_style_list_t * list);
+static inline void style_list_changed(lv_style_list_t * list);
 
 /**********************
  *  GLOABAL VARIABLES
@@ -223,6 +224,7 @@ void _lv_style_list_add_style(lv_style_list_t * list, lv_style_t * style)
     new_classes[first_style] = style;
     list->style_cnt++;
     list->style_list = new_classes;
+    style_list_changed(list);
 }
 
 /**
@@ -248,6 +250,8 @@ void _lv_style_list_remove_style(lv_style_list_t * list, lv_style_t * style)
     }
     if(found == false) return;
 
+    style_list_changed(list);
+
     if(list->style_cnt == 1) {
         lv_mem_free(list->style_list);
         list->style_list = NULL;
@@ -307,6 +311,7 @@ void _lv_style_list_reset(lv_style_list_t * list)
     list->has_local = 0;
     list->has_trans = 0;
     list->skip_trans = 0;
+    style_list_changed(list);
 
     /* Intentionally leave `ignore_trans` as it is,
      * because it's independent from the styles in the list*/
@@ -749,6 +754,7 @@ void _lv_style_list_set_local_int(lv_style_list_t * list, lv_style_property_t pr
 
     lv_style_t * local = get_alloc_local_style(list);
     _lv_style_set_int(local, prop, value);
+    style_list_changed(list);
 }
 
 /**
@@ -765,6 +771,7 @@ void _lv_style_list_set_local_opa(lv_style_list_t * list, lv_style_property_t pr
 
     lv_style_t * local = get_alloc_local_style(list);
     _lv_style_set_opa(local, prop, value);
+    style_list_changed(list);
 }
 
 /**
@@ -781,6 +788,7 @@ void _lv_style_list_set_local_color(lv_style_list_t * list, lv_style_property_t
 
     lv_style_t * local = get_alloc_local_style(list);
     _lv_style_set_color(local, prop, value);
+    style_list_changed(list);
 }
 
 /**
@@ -797,6 +805,7 @@ void _lv_style_list_set_local_ptr(lv_style_list_t * list, lv_style_property_t pr
 
     lv_style_t * local = get_alloc_local_style(list);
     _lv_style_set_ptr(local, prop, value);
+    style_list_changed(list);
 }
 
 
@@ -1087,3 +1096,17 @@ static lv_style_t * get_alloc_local_style(lv_style_list_t * list)
 
     return local_style;
 }
+
+/**
+ * Drop the values of a style list from the style cache of the objects.
+ * Called on every change of the list's styles.
+ * @param list pointer to a style list
+ */
+static inline void style_list_changed(lv_style_list_t * list)
+{
+#if LV_STYLE_CACHE_CNT
+    list->cache_id = 0;
+#else
+    (void)list; /*Unused*/
+#endif
+}
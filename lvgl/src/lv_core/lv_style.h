@@ -228,6 +228,9 @@ typedef struct {
     uint8_t has_trans    : 1;
     uint8_t skip_trans   : 1;       /*1: Temporally skip the transition style if any*/
     uint8_t ignore_trans   : 1;     /*1: Mark that this style list shouldn't receive transitions at all*/
+#if LV_STYLE_CACHE_CNT
+    uint16_t cache_id;              /*Tags the values of the list in the style cache of the objects. 0: none cached*/
+#endif
 } lv_style_list_t;
 
 /**********************
@@ -13,12 +13,18 @@
 #include "../lv_core/lv_refr.h"
 
 #include "../lv_gpu/lv_gpu_stm32_dma2d.h"
+#include "lv_draw_blend_simd.h"
 
 /*********************
  *      DEFINES
  *********************/
 #define GPU_SIZE_LIMIT      240
 
+/* The SIMD kernels blend 32 bit pixels without screen transparency in `fill_normal` and `map_normal`.
+ * `fill_set_px`/`map_set_px` draw pixel by pixel with the driver's `set_px_cb` and
+ * `fill_blended`/`map_blended` (additive and subtractive modes, not used by the themes) stay scalar*/
+#define BLEND_SIMD          (LV_USE_BLEND_SIMD && LV_COLOR_DEPTH == 32 && LV_COLOR_SCREEN_TRANSP == 0)
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -352,6 +358,27 @@ LV_ATTRIBUTE_FAST_MEM static void fill_normal(const lv_area_t * disp_area, lv_co
             lv_color_premult(color, opa, color_premult);
             lv_opa_t opa_inv = 255 - opa;
 
+#if BLEND_SIMD
+            const lv_blend_simd_t * simd = _lv_blend_simd_get();
+            if(simd) {
+                /*The leading black pixels get the cached `last_res_color` as in the loop below*/
+                bool black_start = true;
+                for(y = 0; y < draw_area_h; y++) {
+                    x = 0;
+                    if(black_start) {
+                        while(x < draw_area_w && disp_buf_first[x].full == last_dest_color.full) {
+                            disp_buf_first[x] = last_res_color;
+                            x++;
+                        }
+                        if(x < draw_area_w) black_start = false;
+                    }
+                    simd->fill_premult(disp_buf_first + x, color_premult, opa_inv, draw_area_w - x);
+                    disp_buf_first += disp_w;
+                }
+                return;
+            }
+#endif
+
             for(y = 0; y < draw_area_h; y++) {
                 for(x = 0; x < draw_area_w; x++) {
                     if(last_dest_color.full != disp_buf_first[x].full) {
@@ -384,6 +411,17 @@ LV_ATTRIBUTE_FAST_MEM static void fill_normal(const lv_area_t * disp_area, lv_co
         }
 #endif
 
+#if BLEND_SIMD
+        const lv_blend_simd_t * simd = _lv_blend_simd_get();
+        if(simd) {
+            for(y = 0; y < draw_area_h; y++) {
+                simd->mix(disp_buf_first, NULL, color, mask, opa > LV_OPA_MAX ? LV_OPA_COVER : opa, LV_OPA_COVER, draw_area_w);
+                disp_buf_first += disp_w;
+                mask += draw_area_w;
+            }
+            return;
+        }
+#endif
 
         /*Buffer the result color to avoid recalculating the same color*/
         lv_color_t last_dest_color;
@@ -709,6 +747,18 @@ LV_ATTRIBUTE_FAST_MEM static void map_normal(const lv_area_t * disp_area, lv_col
             }
 #endif
 
+#if BLEND_SIMD
+            const lv_blend_simd_t * simd = _lv_blend_simd_get();
+            if(simd) {
+                for(y = 0; y < draw_area_h; y++) {
+                    simd->mix(disp_buf_first, map_buf_first, LV_COLOR_BLACK, NULL, opa, LV_OPA_MAX, draw_area_w);
+                    disp_buf_first += disp_w;
+                    map_buf_first += map_w;
+                }
+                return;
+            }
+#endif
+
             /*Software rendering*/
 
             for(y = 0; y < draw_area_h; y++) {
@@ -731,6 +781,20 @@ LV_ATTRIBUTE_FAST_MEM static void map_normal(const lv_area_t * disp_area, lv_col
     }
     /*Masked*/
     else {
+#if BLEND_SIMD
+        const lv_blend_simd_t * simd = _lv_blend_simd_get();
+        if(simd) {
+            for(y = 0; y < draw_area_h; y++) {
+                simd->mix(disp_buf_first, map_buf_first, LV_COLOR_BLACK, mask, opa > LV_OPA_MAX ? LV_OPA_COVER : opa,
+                          LV_OPA_MAX, draw_area_w);
+                disp_buf_first += disp_w;
+                mask += draw_area_w;
+                map_buf_first += map_w;
+            }
+            return;
+        }
+#endif
+
         /*Only the mask matters*/
         if(opa > LV_OPA_MAX) {
             /*Go to the first pixel of the row */
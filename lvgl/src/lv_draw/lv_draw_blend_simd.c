@@ -0,0 +1,438 @@
+/**
+ * @file lv_draw_blend_simd.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw_blend_simd.h"
+#include "../lv_misc/lv_log.h"
+
+#if LV_USE_BLEND_SIMD
+
+#include <string.h>
+
+/*The kernels work on 32 bit B, G, R, A pixels*/
+#if LV_COLOR_DEPTH == 32 && LV_COLOR_SCREEN_TRANSP == 0
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define LV_BLEND_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define LV_BLEND_SSE2 1
+#if defined(__GNUC__)
+/*Compiled for AVX2 per function, used if the CPU supports it*/
+#include <immintrin.h>
+#define LV_BLEND_AVX2 1
+#endif
+#endif
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static const lv_blend_simd_t * level_kernels(lv_blend_simd_level_t level);
+static const lv_blend_simd_t * select_kernels(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const lv_blend_simd_t * kernels;
+static bool kernels_selected;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Get the blend kernels for the CPU, selected on the first call
+ * @return the kernels or NULL to use the software rendering
+ */
+const lv_blend_simd_t * _lv_blend_simd_get(void)
+{
+    if(!kernels_selected) {
+        kernels = select_kernels();
+        kernels_selected = true;
+        LV_LOG_INFO(kernels ? kernels->name : "software blending");
+    }
+    return kernels;
+}
+
+/**
+ * Force the kernels of an instruction set, e.g. to compare them with the software rendering
+ * @param level `LV_BLEND_SIMD_NONE` for the software rendering, `LV_BLEND_SIMD_AUTO` for the
+ * widest kernels the CPU supports (default) or an instruction set
+ * @return false if the kernels of `level` are not built or the CPU doesn't support them,
+ * the kernels in use are not changed then
+ */
+bool _lv_blend_simd_force(lv_blend_simd_level_t level)
+{
+    const lv_blend_simd_t * k;
+    if(level == LV_BLEND_SIMD_AUTO) k = select_kernels();
+    else if(level == LV_BLEND_SIMD_NONE) k = NULL;
+    else {
+        k = level_kernels(level);
+        if(k == NULL) return false;
+    }
+
+    kernels = k;
+    kernels_selected = true;
+    return true;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+#if defined(LV_BLEND_NEON) || defined(LV_BLEND_SSE2)
+
+/**
+ * Blend one pixel as described at `lv_blend_mix_cb_t`, for the pixels after the last full vector
+ */
+static inline void mix_px(lv_color_t * dest, lv_color_t s, const lv_opa_t * mask, lv_opa_t opa, lv_opa_t opa_max)
+{
+    lv_opa_t a = opa;
+    if(mask) {
+        if(*mask == 0) return;
+        if(opa == LV_OPA_COVER) a = *mask;
+        else a = *mask >= opa_max ? opa : ((uint32_t)*mask * opa) >> 8;
+    }
+    *dest = a == LV_OPA_COVER ? s : lv_color_mix(s, *dest, a);
+}
+
+static void mix_tail(lv_color_t * dest, const lv_color_t * src, lv_color_t color,
+                     const lv_opa_t * mask, lv_opa_t opa, lv_opa_t opa_max, int32_t i, int32_t len)
+{
+    for(; i < len; i++) {
+        mix_px(&dest[i], src ? src[i] : color, mask ? &mask[i] : NULL, opa, opa_max);
+    }
+}
+
+static void fill_premult_tail(lv_color_t * dest, const uint16_t * premult, lv_opa_t opa_inv, int32_t i, int32_t len)
+{
+    for(; i < len; i++) {
+        dest[i] = lv_color_mix_premult((uint16_t *)premult, dest[i], opa_inv);
+    }
+}
+#endif
+
+#if defined(LV_BLEND_NEON)
+/**
+ * (s * a + d * (255 - a)) / 255 on 16 bytes, exact as `LV_MATH_UDIV255` for these products
+ */
+static inline uint8x16_t mix_neon(uint8x16_t s, uint8x16_t d, uint8x16_t a)
+{
+    uint8x16_t a_inv = vmvnq_u8(a);
+    uint16x8_t lo = vmull_u8(vget_low_u8(s), vget_low_u8(a));
+    uint16x8_t hi = vmull_u8(vget_high_u8(s), vget_high_u8(a));
+    lo = vmlal_u8(lo, vget_low_u8(d), vget_low_u8(a_inv));
+    hi = vmlal_u8(hi, vget_high_u8(d), vget_high_u8(a_inv));
+    /*x / 255 = (x + 1 + ((x + 1) >> 8)) >> 8*/
+    lo = vaddq_u16(lo, vdupq_n_u16(1));
+    hi = vaddq_u16(hi, vdupq_n_u16(1));
+    lo = vsraq_n_u16(lo, lo, 8);
+    hi = vsraq_n_u16(hi, hi, 8);
+    return vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8));
+}
+
+static void blend_mix_neon(lv_color_t * dest, const lv_color_t * src, lv_color_t color,
+                           const lv_opa_t * mask, lv_opa_t opa, lv_opa_t opa_max, int32_t len)
+{
+    const uint8x16_t alpha = vreinterpretq_u8_u32(vdupq_n_u32(0xFF000000));
+    const uint8x16_t v255 = vdupq_n_u8(255);
+    const uint8x16_t vcolor = vreinterpretq_u8_u32(vdupq_n_u32(color.full));
+    const uint8x8_t idx_lo = vcreate_u8(0x0101010100000000ULL);     /*mask byte of pixel 0 and 1*/
+    const uint8x8_t idx_hi = vcreate_u8(0x0303030302020202ULL);     /*mask byte of pixel 2 and 3*/
+    int32_t i = 0;
+    for(; i + 4 <= len; i += 4) {
+        uint8x16_t s = src ? vld1q_u8((const uint8_t *)&src[i]) : vcolor;
+        uint8x16_t a = vdupq_n_u8(opa);
+        uint8x16_t skip = vdupq_n_u8(0);
+        if(mask) {
+            uint32_t m32;
+            memcpy(&m32, &mask[i], sizeof(m32));
+            if(m32 == 0) continue;
+            if(m32 == 0xFFFFFFFF && opa == LV_OPA_COVER) {
+                vst1q_u8((uint8_t *)&dest[i], s);
+                continue;
+            }
+            uint8x8_t m8 = vreinterpret_u8_u32(vdup_n_u32(m32));
+            uint8x16_t m = vcombine_u8(vtbl1_u8(m8, idx_lo), vtbl1_u8(m8, idx_hi));
+            skip = vceqq_u8(m, vdupq_n_u8(0));
+            if(opa == LV_OPA_COVER) {
+                a = m;
+            }
+            else {
+                uint8x16_t scaled = vcombine_u8(vshrn_n_u16(vmull_u8(vget_low_u8(m), vdup_n_u8(opa)), 8),
+                                                vshrn_n_u16(vmull_u8(vget_high_u8(m), vdup_n_u8(opa)), 8));
+                a = vbslq_u8(vcgeq_u8(m, vdupq_n_u8(opa_max)), vdupq_n_u8(opa), scaled);
+            }
+        }
+        uint8x16_t d = vld1q_u8((const uint8_t *)&dest[i]);
+        uint8x16_t res = vorrq_u8(mix_neon(s, d, a), alpha);
+        res = vbslq_u8(vceqq_u8(a, v255), s, res);
+        res = vbslq_u8(skip, d, res);
+        vst1q_u8((uint8_t *)&dest[i], res);
+    }
+    mix_tail(dest, src, color, mask, opa, opa_max, i, len);
+}
+
+static void blend_fill_premult_neon(lv_color_t * dest, const uint16_t * premult, lv_opa_t opa_inv, int32_t len)
+{
+    const uint8x16_t alpha = vreinterpretq_u8_u32(vdupq_n_u32(0xFF000000));
+    const uint16_t pm_px[8] = {premult[2], premult[1], premult[0], 0, premult[2], premult[1], premult[0], 0};
+    const uint16x8_t pm = vld1q_u16(pm_px);
+    const uint8x8_t inv = vdup_n_u8(opa_inv);
+    int32_t i = 0;
+    for(; i + 4 <= len; i += 4) {
+        uint8x16_t d = vld1q_u8((const uint8_t *)&dest[i]);
+        uint16x8_t lo = vmlal_u8(pm, vget_low_u8(d), inv);
+        uint16x8_t hi = vmlal_u8(pm, vget_high_u8(d), inv);
+        uint8x16_t res = vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8));
+        vst1q_u8((uint8_t *)&dest[i], vorrq_u8(res, alpha));
+    }
+    fill_premult_tail(dest, premult, opa_inv, i, len);
+}
+
+static const lv_blend_simd_t kernels_neon = {"NEON", LV_BLEND_SIMD_NEON, blend_mix_neon, blend_fill_premult_neon};
+#endif /*LV_BLEND_NEON*/
+
+#if defined(LV_BLEND_SSE2)
+static inline __m128i sel_sse2(__m128i m, __m128i a, __m128i b)
+{
+    return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b));
+}
+
+/**
+ * (s * a + d * (255 - a)) / 255 in 16 bit lanes, exact as `LV_MATH_UDIV255` for these products
+ */
+static inline __m128i mix16_sse2(__m128i s, __m128i d, __m128i a)
+{
+    __m128i x = _mm_add_epi16(_mm_mullo_epi16(s, a), _mm_mullo_epi16(d, _mm_sub_epi16(_mm_set1_epi16(255), a)));
+    x = _mm_add_epi16(x, _mm_set1_epi16(1));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+/**
+ * Mask values to mix ratios: `m >= opa_max ? opa : (m * opa) >> 8` in 16 bit lanes
+ */
+static inline __m128i scale16_sse2(__m128i m, __m128i opa, __m128i opa_max_1)
+{
+    __m128i full = _mm_cmpgt_epi16(m, opa_max_1);
+    return sel_sse2(full, opa, _mm_srli_epi16(_mm_mullo_epi16(m, opa), 8));
+}
+
+static void blend_mix_sse2(lv_color_t * dest, const lv_color_t * src, lv_color_t color,
+                           const lv_opa_t * mask, lv_opa_t opa, lv_opa_t opa_max, int32_t len)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i v255 = _mm_set1_epi16(255);
+    const __m128i vopa = _mm_set1_epi16(opa);
+    const __m128i vopa_max_1 = _mm_set1_epi16(opa_max - 1);
+    const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+    const __m128i vcolor = _mm_set1_epi32((int)color.full);
+    int32_t i = 0;
+    for(; i + 4 <= len; i += 4) {
+        __m128i s = src ? _mm_loadu_si128((const __m128i *)&src[i]) : vcolor;
+        __m128i a_lo = vopa;    /*pixel 0 and 1*/
+        __m128i a_hi = vopa;    /*pixel 2 and 3*/
+        __m128i skip = zero;
+        if(mask) {
+            uint32_t m32;
+            memcpy(&m32, &mask[i], sizeof(m32));
+            if(m32 == 0) continue;
+            if(m32 == 0xFFFFFFFF && opa == LV_OPA_COVER) {
+                _mm_storeu_si128((__m128i *)&dest[i], s);
+                continue;
+            }
+            /*The mask byte of each pixel in its 4 bytes*/
+            __m128i m = _mm_cvtsi32_si128((int)m32);
+            m = _mm_unpacklo_epi8(m, m);
+            m = _mm_unpacklo_epi16(m, m);
+            skip = _mm_cmpeq_epi8(m, zero);
+            a_lo = _mm_unpacklo_epi8(m, zero);
+            a_hi = _mm_unpackhi_epi8(m, zero);
+            if(opa != LV_OPA_COVER) {
+                a_lo = scale16_sse2(a_lo, vopa, vopa_max_1);
+                a_hi = scale16_sse2(a_hi, vopa, vopa_max_1);
+            }
+        }
+        __m128i d = _mm_loadu_si128((const __m128i *)&dest[i]);
+        __m128i lo = mix16_sse2(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), a_lo);
+        __m128i hi = mix16_sse2(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), a_hi);
+        __m128i res = _mm_or_si128(_mm_packus_epi16(lo, hi), alpha);
+        __m128i cover = _mm_packs_epi16(_mm_cmpeq_epi16(a_lo, v255), _mm_cmpeq_epi16(a_hi, v255));
+        res = sel_sse2(cover, s, res);
+        res = sel_sse2(skip, d, res);
+        _mm_storeu_si128((__m128i *)&dest[i], res);
+    }
+    mix_tail(dest, src, color, mask, opa, opa_max, i, len);
+}
+
+static void blend_fill_premult_sse2(lv_color_t * dest, const uint16_t * premult, lv_opa_t opa_inv, int32_t len)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+    const __m128i inv = _mm_set1_epi16(opa_inv);
+    const __m128i pm = _mm_setr_epi16((short)premult[2], (short)premult[1], (short)premult[0], 0,
+                                      (short)premult[2], (short)premult[1], (short)premult[0], 0);
+    int32_t i = 0;
+    for(; i + 4 <= len; i += 4) {
+        __m128i d = _mm_loadu_si128((const __m128i *)&dest[i]);
+        __m128i lo = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), inv), pm), 8);
+        __m128i hi = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), inv), pm), 8);
+        _mm_storeu_si128((__m128i *)&dest[i], _mm_or_si128(_mm_packus_epi16(lo, hi), alpha));
+    }
+    fill_premult_tail(dest, premult, opa_inv, i, len);
+}
+
+static const lv_blend_simd_t kernels_sse2 = {"SSE2", LV_BLEND_SIMD_SSE2, blend_mix_sse2, blend_fill_premult_sse2};
+#endif /*LV_BLEND_SSE2*/
+
+#if defined(LV_BLEND_AVX2)
+#define LV_AVX2 __attribute__((target("avx2")))
+
+LV_AVX2 static inline __m256i sel_avx2(__m256i m, __m256i a, __m256i b)
+{
+    return _mm256_or_si256(_mm256_and_si256(m, a), _mm256_andnot_si256(m, b));
+}
+
+LV_AVX2 static inline __m256i mix16_avx2(__m256i s, __m256i d, __m256i a)
+{
+    __m256i x = _mm256_add_epi16(_mm256_mullo_epi16(s, a),
+                                 _mm256_mullo_epi16(d, _mm256_sub_epi16(_mm256_set1_epi16(255), a)));
+    x = _mm256_add_epi16(x, _mm256_set1_epi16(1));
+    return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+LV_AVX2 static inline __m256i scale16_avx2(__m256i m, __m256i opa, __m256i opa_max_1)
+{
+    __m256i full = _mm256_cmpgt_epi16(m, opa_max_1);
+    return sel_avx2(full, opa, _mm256_srli_epi16(_mm256_mullo_epi16(m, opa), 8));
+}
+
+/*Same as the SSE2 kernel with 8 pixels, the unpacks work within the 128 bit lanes*/
+LV_AVX2 static void blend_mix_avx2(lv_color_t * dest, const lv_color_t * src, lv_color_t color,
+                                   const lv_opa_t * mask, lv_opa_t opa, lv_opa_t opa_max, int32_t len)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i v255 = _mm256_set1_epi16(255);
+    const __m256i vopa = _mm256_set1_epi16(opa);
+    const __m256i vopa_max_1 = _mm256_set1_epi16(opa_max - 1);
+    const __m256i alpha = _mm256_set1_epi32((int)0xFF000000);
+    const __m256i vcolor = _mm256_set1_epi32((int)color.full);
+    int32_t i = 0;
+    for(; i + 8 <= len; i += 8) {
+        __m256i s = src ? _mm256_loadu_si256((const __m256i *)&src[i]) : vcolor;
+        __m256i a_lo = vopa;
+        __m256i a_hi = vopa;
+        __m256i skip = zero;
+        if(mask) {
+            uint64_t m64;
+            memcpy(&m64, &mask[i], sizeof(m64));
+            if(m64 == 0) continue;
+            if(m64 == UINT64_MAX && opa == LV_OPA_COVER) {
+                _mm256_storeu_si256((__m256i *)&dest[i], s);
+                continue;
+            }
+            __m128i m8 = _mm_loadl_epi64((const __m128i *)&mask[i]);
+            m8 = _mm_unpacklo_epi8(m8, m8);
+            __m256i m = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi16(m8, m8)),
+                                                _mm_unpackhi_epi16(m8, m8), 1);
+            skip = _mm256_cmpeq_epi8(m, zero);
+            a_lo = _mm256_unpacklo_epi8(m, zero);
+            a_hi = _mm256_unpackhi_epi8(m, zero);
+            if(opa != LV_OPA_COVER) {
+                a_lo = scale16_avx2(a_lo, vopa, vopa_max_1);
+                a_hi = scale16_avx2(a_hi, vopa, vopa_max_1);
+            }
+        }
+        __m256i d = _mm256_loadu_si256((const __m256i *)&dest[i]);
+        __m256i lo = mix16_avx2(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero), a_lo);
+        __m256i hi = mix16_avx2(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero), a_hi);
+        __m256i res = _mm256_or_si256(_mm256_packus_epi16(lo, hi), alpha);
+        __m256i cover = _mm256_packs_epi16(_mm256_cmpeq_epi16(a_lo, v255), _mm256_cmpeq_epi16(a_hi, v255));
+        res = sel_avx2(cover, s, res);
+        res = sel_avx2(skip, d, res);
+        _mm256_storeu_si256((__m256i *)&dest[i], res);
+    }
+    mix_tail(dest, src, color, mask, opa, opa_max, i, len);
+}
+
+LV_AVX2 static void blend_fill_premult_avx2(lv_color_t * dest, const uint16_t * premult, lv_opa_t opa_inv,
+                                            int32_t len)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i alpha = _mm256_set1_epi32((int)0xFF000000);
+    const __m256i inv = _mm256_set1_epi16(opa_inv);
+    const __m256i pm = _mm256_setr_epi16((short)premult[2], (short)premult[1], (short)premult[0], 0,
+                                         (short)premult[2], (short)premult[1], (short)premult[0], 0,
+                                         (short)premult[2], (short)premult[1], (short)premult[0], 0,
+                                         (short)premult[2], (short)premult[1], (short)premult[0], 0);
+    int32_t i = 0;
+    for(; i + 8 <= len; i += 8) {
+        __m256i d = _mm256_loadu_si256((const __m256i *)&dest[i]);
+        __m256i lo = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), inv), pm), 8);
+        __m256i hi = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), inv), pm), 8);
+        _mm256_storeu_si256((__m256i *)&dest[i], _mm256_or_si256(_mm256_packus_epi16(lo, hi), alpha));
+    }
+    fill_premult_tail(dest, premult, opa_inv, i, len);
+}
+
+static const lv_blend_simd_t kernels_avx2 = {"AVX2", LV_BLEND_SIMD_AVX2, blend_mix_avx2, blend_fill_premult_avx2};
+#endif /*LV_BLEND_AVX2*/
+
+/**
+ * Get the kernels of an instruction set
+ * @param level an instruction set
+ * @return the kernels or NULL if they are not built or the CPU doesn't support them
+ */
+static const lv_blend_simd_t * level_kernels(lv_blend_simd_level_t level)
+{
+    switch(level) {
+#if defined(LV_BLEND_AVX2)
+        case LV_BLEND_SIMD_AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") ? &kernels_avx2 : NULL;
+#endif
+#if defined(LV_BLEND_SSE2)
+        case LV_BLEND_SIMD_SSE2:
+            return &kernels_sse2;
+#endif
+#if defined(LV_BLEND_NEON)
+        case LV_BLEND_SIMD_NEON:
+            return &kernels_neon;
+#endif
+        default:
+            return NULL;
+    }
+}
+
+/**
+ * Select the widest kernels the CPU supports
+ */
+static const lv_blend_simd_t * select_kernels(void)
+{
+    static const lv_blend_simd_level_t levels[] = {LV_BLEND_SIMD_AVX2, LV_BLEND_SIMD_NEON, LV_BLEND_SIMD_SSE2};
+    uint32_t i;
+    for(i = 0; i < sizeof(levels) / sizeof(levels[0]); i++) {
+        const lv_blend_simd_t * k = level_kernels(levels[i]);
+        if(k) return k;
+    }
+    return NULL;
+}
+
+#endif /*LV_USE_BLEND_SIMD*/
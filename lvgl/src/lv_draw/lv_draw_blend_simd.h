@@ -0,0 +1,93 @@
+/**
+ * @file lv_draw_blend_simd.h
+ *
+ */
+
+#ifndef LV_DRAW_BLEND_SIMD_H
+#define LV_DRAW_BLEND_SIMD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdbool.h>
+#include "../lv_misc/lv_color.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/** Instruction sets of the blend kernels*/
+enum {
+    LV_BLEND_SIMD_NONE,     /**< Software rendering*/
+    LV_BLEND_SIMD_SSE2,
+    LV_BLEND_SIMD_AVX2,
+    LV_BLEND_SIMD_NEON,
+    LV_BLEND_SIMD_AUTO,     /**< The widest kernels the CPU supports (default)*/
+};
+typedef uint8_t lv_blend_simd_level_t;
+
+/**
+ * Blend a line into the display buffer, per pixel:
+ * - `m = mask[i]`, not drawn if `m == 0`. Without mask `a = opa`.
+ * - `a = m` if `opa == LV_OPA_COVER`, else `a = m >= opa_max ? opa : (m * opa) >> 8`
+ * - `dest[i] = a == LV_OPA_COVER ? s : lv_color_mix(s, dest[i], a)`
+ * where `s` is `src[i]` or `color` if `src` is NULL.
+ */
+typedef void (*lv_blend_mix_cb_t)(lv_color_t * dest, const lv_color_t * src, lv_color_t color,
+                                  const lv_opa_t * mask, lv_opa_t opa, lv_opa_t opa_max, int32_t len);
+
+/**
+ * Fill a line with a color and opacity: `dest[i] = lv_color_mix_premult(premult, dest[i], opa_inv)`
+ */
+typedef void (*lv_blend_fill_premult_cb_t)(lv_color_t * dest, const uint16_t * premult, lv_opa_t opa_inv,
+                                           int32_t len);
+
+typedef struct {
+    const char * name;
+    lv_blend_simd_level_t level;
+    lv_blend_mix_cb_t mix;
+    lv_blend_fill_premult_cb_t fill_premult;
+} lv_blend_simd_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+//! @cond Doxygen_Suppress
+#if LV_USE_BLEND_SIMD
+
+/**
+ * Get the blend kernels for the CPU, selected on the first call
+ * @return the kernels or NULL to use the software rendering
+ */
+const lv_blend_simd_t * _lv_blend_simd_get(void);
+
+/**
+ * Force the kernels of an instruction set, e.g. to compare them with the software rendering
+ * @param level `LV_BLEND_SIMD_NONE` for the software rendering, `LV_BLEND_SIMD_AUTO` for the
+ * widest kernels the CPU supports (default) or an instruction set
+ * @return false if the kernels of `level` are not built or the CPU doesn't support them,
+ * the kernels in use are not changed then
+ */
+bool _lv_blend_simd_force(lv_blend_simd_level_t level);
+
+#endif /*LV_USE_BLEND_SIMD*/
+//! @endcond
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_DRAW_BLEND_SIMD_H*/
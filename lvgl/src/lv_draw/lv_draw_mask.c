@@ -13,6 +13,7 @@
 #include "lv_draw_mask.h"
 #include "../lv_misc/lv_math.h"
 #include "../lv_misc/lv_log.h"
+#include "../lv_misc/lv_mem.h"
 #include "../lv_core/lv_debug.h"
 #include "../lv_misc/lv_gc.h"
 
@@ -27,6 +28,23 @@
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_RADIUS_MASK_CACHE_CNT
+/*The pixels crossed by the circle in a row of the corner,
+ *from the innermost one (`ofs` pixels from the edge of the rectangle) to the outside*/
+typedef struct {
+    int16_t ofs;
+    uint16_t cnt;
+    uint32_t opa_ofs;       /*Index of the innermost pixel's opacity in `opa`*/
+} radius_corner_row_t;
+
+typedef struct _lv_draw_mask_radius_corner_t {
+    lv_coord_t radius;      /*0: unused*/
+    uint32_t mem_size;
+    uint32_t life;          /*Time of the last use, the oldest entry is freed first*/
+    radius_corner_row_t * rows; /*Indexed with `y - 1`, `y` is the distance of the row from the center*/
+    lv_opa_t * opa;         /*Opacity of the crossed pixels, not inverted*/
+} lv_draw_mask_radius_corner_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
@@ -57,9 +75,23 @@ LV_ATTRIBUTE_FAST_MEM static lv_draw_mask_res_t line_mask_steep(lv_opa_t * mask_
 LV_ATTRIBUTE_FAST_MEM static inline lv_opa_t mask_mix(lv_opa_t mask_act, lv_opa_t mask_new);
 LV_ATTRIBUTE_FAST_MEM static inline void sqrt_approx(lv_sqrt_res_t * q, lv_sqrt_res_t * ref, uint32_t x);
 
+#if LV_RADIUS_MASK_CACHE_CNT
+static const lv_draw_mask_radius_corner_t * radius_corner_get(lv_coord_t radius);
+static void radius_corner_free(lv_draw_mask_radius_corner_t * corner);
+static uint32_t radius_corner_row(int32_t radius, int32_t y, lv_opa_t * opa, int32_t * ofs);
+#endif
+
 /**********************
  *  STATIC VARIABLES
  **********************/
+#if LV_RADIUS_MASK_CACHE_CNT
+static lv_draw_mask_radius_corner_t radius_corners[LV_RADIUS_MASK_CACHE_CNT];
+static uint32_t radius_corner_life;
+static uint32_t radius_corner_mem_size;
+static lv_coord_t radius_corner_too_large; /*The smallest radius found larger than the budget, 0: none*/
+static uint32_t radius_corner_hit_cnt;
+static uint32_t radius_corner_miss_cnt;
+#endif
 
 /**********************
  *      MACROS
@@ -387,7 +419,29 @@ void lv_draw_mask_radius_init(lv_draw_mask_radius_param_t * param, const lv_area
     param->y_prev = INT32_MIN;
     param->y_prev_x.f = 0;
     param->y_prev_x.i = 0;
+#if LV_RADIUS_MASK_CACHE_CNT
+    param->corner = radius_corner_get(radius);
+#endif
+}
+
+#if LV_RADIUS_MASK_CACHE_CNT
+/**
+ * Get the usage of the buffered radius mask corners
+ * @param info store the result here
+ */
+void lv_draw_mask_radius_cache_get_info(lv_draw_mask_radius_cache_info_t * info)
+{
+    info->hit_cnt = radius_corner_hit_cnt;
+    info->miss_cnt = radius_corner_miss_cnt;
+    info->entry_cnt = 0;
+    info->mem_size = radius_corner_mem_size;
+
+    uint32_t i;
+    for(i = 0; i < LV_RADIUS_MASK_CACHE_CNT; i++) {
+        if(radius_corners[i].radius != 0) info->entry_cnt++;
+    }
 }
+#endif
 
 
 /**
@@ -955,6 +1009,51 @@ LV_ATTRIBUTE_FAST_MEM static lv_draw_mask_res_t lv_draw_mask_radius(lv_opa_t * m
     /*Handle corner areas*/
     if(abs_y < radius || abs_y > h - radius - 1) {
 
+#if LV_RADIUS_MASK_CACHE_CNT
+        /*Take the crossed pixels of the row from the buffered corner if it wasn't freed since the init*/
+        if(p->corner && p->corner->radius == radius) {
+            int32_t y = abs_y < radius ? radius - abs_y : radius - (h - abs_y) + 1;
+            const radius_corner_row_t * row = &p->corner->rows[y - 1];
+            const lv_opa_t * opa = &p->corner->opa[row->opa_ofs];
+            int32_t kl = k + row->ofs;
+            int32_t kr = k + (w - row->ofs - 1);
+
+            if(outer) {
+                int32_t first = kl + 1;
+                if(first < 0) first = 0;
+
+                int32_t len_tmp = kr - first;
+                if(len_tmp + first > len) len_tmp = len - first;
+                if(first < len && len_tmp >= 0) {
+                    _lv_memset_00(&mask_buf[first], len_tmp);
+                }
+            }
+
+            uint32_t i;
+            for(i = 0; i < row->cnt; i++) {
+                lv_opa_t m = outer ? 255 - opa[i] : opa[i];
+                if(kl >= 0 && kl < len) mask_buf[kl] = mask_mix(mask_buf[kl], m);
+                if(kr >= 0 && kr < len) mask_buf[kr] = mask_mix(mask_buf[kr], m);
+                kl--;
+                kr++;
+            }
+
+            if(outer == false) {
+                kl++;
+                if(kl > len) {
+                    return LV_DRAW_MASK_RES_TRANSP;
+                }
+                if(kl >= 0) _lv_memset_00(&mask_buf[0], kl);
+
+                if(kr < 0) {
+                    return LV_DRAW_MASK_RES_TRANSP;
+                }
+                if(kr < len) _lv_memset_00(&mask_buf[kr], len - kr);
+            }
+            return LV_DRAW_MASK_RES_CHANGED;
+        }
+#endif
+
         uint32_t sqrt_mask;
         if(radius <= 32) sqrt_mask = 0x200;
         if(radius <= 256) sqrt_mask = 0x800;
@@ -1253,3 +1352,170 @@ LV_ATTRIBUTE_FAST_MEM static inline void sqrt_approx(lv_sqrt_res_t * q, lv_sqrt_
     q->i = d >> 4;
     q->f = (d & 0xF) << 4;
 }
+
+#if LV_RADIUS_MASK_CACHE_CNT
+/**
+ * Get the buffered corner of a radius, calculate it if it's new.
+ * The least recently used corners are freed to keep the tables in `LV_RADIUS_MASK_CACHE_SIZE` bytes.
+ * @param radius the radius
+ * @return the corner or NULL if it's larger than the budget or there is no memory for it
+ */
+static const lv_draw_mask_radius_corner_t * radius_corner_get(lv_coord_t radius)
+{
+    if(radius <= 0) return NULL;
+
+    radius_corner_life++;
+
+    uint32_t i;
+    for(i = 0; i < LV_RADIUS_MASK_CACHE_CNT; i++) {
+        if(radius_corners[i].radius == radius) {
+            radius_corners[i].life = radius_corner_life;
+            radius_corner_hit_cnt++;
+            return &radius_corners[i];
+        }
+    }
+
+    radius_corner_miss_cnt++;
+
+    /*Every row crosses at least one pixel so skip the radii which can't fit into the budget
+     *and the ones not smaller than a radius which didn't fit*/
+    if(radius * (sizeof(radius_corner_row_t) + 1) > LV_RADIUS_MASK_CACHE_SIZE) return NULL;
+    if(radius_corner_too_large && radius >= radius_corner_too_large) return NULL;
+
+    /*Count the crossed pixels to allocate the corner in one block*/
+    lv_opa_t * opa_tmp = _lv_mem_buf_get(radius + 2);
+    uint32_t opa_cnt = 0;
+    int32_t y;
+    int32_t ofs;
+    for(y = 1; y <= radius; y++) {
+        opa_cnt += radius_corner_row(radius, y, opa_tmp, &ofs);
+    }
+    _lv_mem_buf_release(opa_tmp);
+
+    uint32_t mem_size = radius * sizeof(radius_corner_row_t) + opa_cnt;
+    if(mem_size > LV_RADIUS_MASK_CACHE_SIZE) {
+        radius_corner_too_large = radius;
+        return NULL;
+    }
+
+    /*Free the oldest corners until there is a free entry and the new one fits into the budget.
+     *Free more if the heap is full*/
+    lv_draw_mask_radius_corner_t * corner = NULL;
+    uint8_t * mem = NULL;
+    while(1) {
+        lv_draw_mask_radius_corner_t * oldest = NULL;
+        corner = NULL;
+        for(i = 0; i < LV_RADIUS_MASK_CACHE_CNT; i++) {
+            lv_draw_mask_radius_corner_t * e = &radius_corners[i];
+            if(e->radius == 0) {
+                if(corner == NULL) corner = e;
+            }
+            else if(oldest == NULL || e->life < oldest->life) oldest = e;
+        }
+
+        if(corner && radius_corner_mem_size + mem_size <= LV_RADIUS_MASK_CACHE_SIZE) {
+            mem = lv_mem_alloc(mem_size);
+            if(mem) break;
+        }
+
+        if(oldest == NULL) return NULL;
+        radius_corner_free(oldest);
+    }
+
+    corner->rows = (radius_corner_row_t *)mem;
+    corner->opa = mem + radius * sizeof(radius_corner_row_t);
+
+    opa_cnt = 0;
+    for(y = 1; y <= radius; y++) {
+        radius_corner_row_t * row = &corner->rows[y - 1];
+        row->opa_ofs = opa_cnt;
+        row->cnt = radius_corner_row(radius, y, &corner->opa[opa_cnt], &ofs);
+        row->ofs = ofs;
+        opa_cnt += row->cnt;
+    }
+    corner->mem_size = mem_size;
+    corner->radius = radius;
+    corner->life = radius_corner_life;
+    radius_corner_mem_size += mem_size;
+
+    return corner;
+}
+
+/**
+ * Free the tables of a buffered corner.
+ * Masks still referring to the entry see that its radius changed and calculate their corners.
+ * @param corner the corner to free
+ */
+static void radius_corner_free(lv_draw_mask_radius_corner_t * corner)
+{
+    lv_mem_free(corner->rows);
+    radius_corner_mem_size -= corner->mem_size;
+    corner->rows = NULL;
+    corner->opa = NULL;
+    corner->mem_size = 0;
+    corner->radius = 0;
+}
+
+/**
+ * Calculate the pixels crossed by the circle in a row of a corner the same way as `lv_draw_mask_radius()`
+ * @param radius radius of the corner
+ * @param y distance of the row from the center of the circle [1..radius]
+ * @param opa store the opacity of the crossed pixels here from the innermost one, at most `radius + 2`
+ * @param ofs store the distance of the innermost pixel from the edge of the rectangle here
+ * @return number of crossed pixels
+ */
+static uint32_t radius_corner_row(int32_t radius, int32_t y, lv_opa_t * opa, int32_t * ofs)
+{
+    uint32_t r2 = radius * radius;
+    uint32_t sqrt_mask = radius <= 256 ? 0x800 : 0x8000;
+
+    lv_sqrt_res_t x0;
+    lv_sqrt_res_t x1;
+    _lv_sqrt(r2 - (y * y), &x0, sqrt_mask);
+    _lv_sqrt(r2 - ((y - 1) * (y - 1)), &x1, sqrt_mask);
+
+    if(x0.i == x1.i - 1 && x1.f == 0) {
+        x1.i--;
+        x1.f = 0xFF;
+    }
+
+    if(x0.i == x1.i) {
+        opa[0] = (x0.f + x1.f) >> 1;
+        *ofs = radius - x0.i - 1;
+        return 1;
+    }
+
+    *ofs = radius - (x0.i + 1);
+
+    uint32_t cnt = 0;
+    uint32_t i = x0.i + 1;
+    lv_sqrt_res_t y_prev;
+    lv_sqrt_res_t y_next;
+
+    _lv_sqrt(r2 - (x0.i * x0.i), &y_prev, sqrt_mask);
+
+    if(y_prev.f == 0) {
+        y_prev.i--;
+        y_prev.f = 0xFF;
+    }
+
+    if(y_prev.i >= y) {
+        _lv_sqrt(r2 - (i * i), &y_next, sqrt_mask);
+        opa[cnt++] = 255 - (((255 - x0.f) * (255 - y_next.f)) >> 9);
+        y_prev.f = y_next.f;
+        i++;
+    }
+
+    for(; i <= x1.i; i++) {
+        sqrt_approx(&y_next, &y_prev, r2 - (i * i));
+        opa[cnt++] = (y_prev.f + y_next.f) >> 1;
+        y_prev.f = y_next.f;
+    }
+
+    if(y_prev.f) {
+        opa[cnt++] = (y_prev.f * x1.f) >> 9;
+    }
+
+    return cnt;
+}
+#endif
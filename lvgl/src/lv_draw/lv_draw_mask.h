@@ -135,9 +135,22 @@ typedef struct {
     } cfg;
     int32_t y_prev;
     lv_sqrt_res_t y_prev_x;
+#if LV_RADIUS_MASK_CACHE_CNT
+    /*The buffered corner of the radius or NULL to calculate it. Not used if it was freed since*/
+    const struct _lv_draw_mask_radius_corner_t * corner;
+#endif
 
 } lv_draw_mask_radius_param_t;
 
+#if LV_RADIUS_MASK_CACHE_CNT
+typedef struct {
+    uint32_t hit_cnt;       /*Radius masks drawn with a buffered corner*/
+    uint32_t miss_cnt;      /*Radius masks whose corner was calculated or buffered now*/
+    uint32_t entry_cnt;     /*Number of buffered radii*/
+    uint32_t mem_size;      /*Memory of the buffered corners in bytes*/
+} lv_draw_mask_radius_cache_info_t;
+#endif
+
 typedef struct {
     /*The first element must be the common descriptor*/
     lv_draw_mask_common_dsc_t dsc;
@@ -275,6 +288,14 @@ void lv_draw_mask_angle_init(lv_draw_mask_angle_param_t * param, lv_coord_t vert
  */
 void lv_draw_mask_radius_init(lv_draw_mask_radius_param_t * param, const lv_area_t * rect, lv_coord_t radius, bool inv);
 
+#if LV_RADIUS_MASK_CACHE_CNT
+/**
+ * Get the usage of the buffered radius mask corners
+ * @param info store the result here
+ */
+void lv_draw_mask_radius_cache_get_info(lv_draw_mask_radius_cache_info_t * info);
+#endif
+
 /**
  * Initialize a fade mask.
  * @param param pointer to a `lv_draw_mask_param_t` to initialize
@@ -23,6 +23,18 @@
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_USE_SHADOW && LV_SHADOW_CACHE_SIZE
+/*A blurred shadow corner. It depends only on the width and radius of the shadow
+ *and, for small shadows, on the size of the shadow's rectangle*/
+typedef struct {
+    uint32_t life;      /*Time of the last use, the oldest entry is replaced*/
+    lv_coord_t sw;      /*Shadow width, 0: unused entry*/
+    lv_coord_t r;
+    lv_coord_t w;       /*Limited to the sizes where the corner still changes*/
+    lv_coord_t h;
+    lv_opa_t buf[LV_SHADOW_CACHE_SIZE * LV_SHADOW_CACHE_SIZE];
+} shadow_cache_entry_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
@@ -38,6 +50,9 @@ LV_ATTRIBUTE_FAST_MEM static void draw_shadow(const lv_area_t * coords, const lv
 LV_ATTRIBUTE_FAST_MEM static void shadow_draw_corner_buf(const lv_area_t * coords,  uint16_t * sh_buf, lv_coord_t s,
                                                          lv_coord_t r);
 LV_ATTRIBUTE_FAST_MEM static void shadow_blur_corner(lv_coord_t size, lv_coord_t sw, uint16_t * sh_ups_buf);
+#if LV_SHADOW_CACHE_SIZE
+static shadow_cache_entry_t * shadow_cache_get(lv_coord_t sw, lv_coord_t r, lv_coord_t w, lv_coord_t h, bool * found);
+#endif
 #endif
 static void draw_pattern(const lv_area_t * coords, const lv_area_t * clip, lv_draw_rect_dsc_t * dsc);
 static void draw_value(const lv_area_t * coords, const lv_area_t * clip, lv_draw_rect_dsc_t * dsc);
@@ -46,9 +61,10 @@ static void draw_value(const lv_area_t * coords, const lv_area_t * clip, lv_draw
  *  STATIC VARIABLES
  **********************/
 #if LV_USE_SHADOW && LV_SHADOW_CACHE_SIZE
-    static uint8_t sh_cache[LV_SHADOW_CACHE_SIZE * LV_SHADOW_CACHE_SIZE];
-    static int32_t sh_cache_size = -1;
-    static int32_t sh_cache_r = -1;
+    static shadow_cache_entry_t sh_cache[LV_SHADOW_CACHE_CNT];
+    static uint32_t sh_cache_life;
+    static uint32_t sh_cache_hit_cnt;
+    static uint32_t sh_cache_miss_cnt;
 #endif
 
 /**********************
@@ -135,6 +151,37 @@ void lv_draw_px(const lv_point_t * point, const lv_area_t * clip_area, const lv_
     //    }
 }
 
+#if LV_USE_SHADOW && LV_SHADOW_CACHE_SIZE
+/**
+ * Drop the buffered shadow corners, e.g. to measure the drawing without the cache
+ */
+void lv_draw_shadow_cache_invalidate(void)
+{
+    uint32_t i;
+    for(i = 0; i < LV_SHADOW_CACHE_CNT; i++) {
+        sh_cache[i].sw = 0;
+        sh_cache[i].life = 0;
+    }
+}
+
+/**
+ * Get the usage of the shadow cache
+ * @param info store the result here
+ */
+void lv_draw_shadow_cache_get_info(lv_draw_shadow_cache_info_t * info)
+{
+    info->hit_cnt = sh_cache_hit_cnt;
+    info->miss_cnt = sh_cache_miss_cnt;
+    info->entry_cnt = 0;
+    info->mem_size = sizeof(sh_cache);
+
+    uint32_t i;
+    for(i = 0; i < LV_SHADOW_CACHE_CNT; i++) {
+        if(sh_cache[i].sw) info->entry_cnt++;
+    }
+}
+#endif
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -650,22 +697,25 @@ LV_ATTRIBUTE_FAST_MEM static void draw_shadow(const lv_area_t * coords, const lv
     lv_opa_t * sh_buf;
 
 #if LV_SHADOW_CACHE_SIZE
-    if(sh_cache_size == corner_size && sh_cache_r == r_sh) {
-        /*Use the cache if available*/
+    /*The corner is blurred from a rectangle as large as the shadow.
+     *It changes with the size only while the far edges of the rectangle reach into the corner*/
+    lv_coord_t sh_w = LV_MATH_MIN(lv_area_get_width(&sh_rect_area), 2 * corner_size);
+    lv_coord_t sh_h = LV_MATH_MIN(lv_area_get_height(&sh_rect_area), 2 * corner_size);
+    bool found = false;
+    shadow_cache_entry_t * sh_cached = NULL;
+    if(corner_size <= LV_SHADOW_CACHE_SIZE) sh_cached = shadow_cache_get(sw, r_sh, sh_w, sh_h, &found);
+
+    if(found) {
+        /*Copy because the corner is mirrored in place while drawing*/
         sh_buf = _lv_mem_buf_get(corner_size * corner_size);
-        _lv_memcpy(sh_buf, sh_cache, corner_size * corner_size);
+        _lv_memcpy(sh_buf, sh_cached->buf, corner_size * corner_size);
     }
     else {
         /*A larger buffer is required for calculation */
         sh_buf = _lv_mem_buf_get(corner_size * corner_size * sizeof(uint16_t));
         shadow_draw_corner_buf(&sh_rect_area, (uint16_t *)sh_buf, dsc->shadow_width, r_sh);
 
-        /*Cache the corner if it fits into the cache size*/
-        if(corner_size * corner_size < sizeof(sh_cache)) {
-            _lv_memcpy(sh_cache, sh_buf, corner_size * corner_size);
-            sh_cache_size = corner_size;
-            sh_cache_r = r_sh;
-        }
+        if(sh_cached) _lv_memcpy(sh_cached->buf, sh_buf, corner_size * corner_size);
     }
 #else
     sh_buf = _lv_mem_buf_get(corner_size * corner_size * sizeof(uint16_t));
@@ -1206,6 +1256,44 @@ LV_ATTRIBUTE_FAST_MEM static void shadow_blur_corner(lv_coord_t size, lv_coord_t
     _lv_mem_buf_release(sh_ups_blur_buf);
 }
 
+#if LV_SHADOW_CACHE_SIZE
+/**
+ * Find a shadow corner in the cache or the entry to store it
+ * @param sw width of the shadow
+ * @param r radius of the shadow
+ * @param w width of the shadow's rectangle, limited to `2 * (sw + r)`
+ * @param h height of the shadow's rectangle, limited to `2 * (sw + r)`
+ * @param found set to true if the corner is in the returned entry
+ * @return the entry of the corner or the least recently used entry, already assigned to the corner
+ */
+static shadow_cache_entry_t * shadow_cache_get(lv_coord_t sw, lv_coord_t r, lv_coord_t w, lv_coord_t h, bool * found)
+{
+    sh_cache_life++;
+
+    shadow_cache_entry_t * oldest = &sh_cache[0];
+    uint32_t i;
+    for(i = 0; i < LV_SHADOW_CACHE_CNT; i++) {
+        shadow_cache_entry_t * e = &sh_cache[i];
+        if(e->sw == sw && e->r == r && e->w == w && e->h == h) {
+            e->life = sh_cache_life;
+            sh_cache_hit_cnt++;
+            *found = true;
+            return e;
+        }
+        if(e->life < oldest->life) oldest = e;
+    }
+
+    sh_cache_miss_cnt++;
+    oldest->sw = sw;
+    oldest->r = r;
+    oldest->w = w;
+    oldest->h = h;
+    oldest->life = sh_cache_life;
+    *found = false;
+    return oldest;
+}
+#endif
+
 #endif
 
 static void draw_outline(const lv_area_t * coords, const lv_area_t * clip, lv_draw_rect_dsc_t * dsc)
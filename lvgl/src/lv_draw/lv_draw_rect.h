@@ -80,6 +80,16 @@ typedef struct {
     lv_blend_mode_t value_blend_mode;
 } lv_draw_rect_dsc_t;
 
+#if LV_USE_SHADOW && LV_SHADOW_CACHE_SIZE
+/*Usage of the shadow cache*/
+typedef struct {
+    uint32_t hit_cnt;       /*Shadows drawn with a cached corner*/
+    uint32_t miss_cnt;      /*Shadows whose corner was blurred and cached*/
+    uint32_t entry_cnt;     /*Number of cached corners*/
+    uint32_t mem_size;      /*Memory of the cache in bytes*/
+} lv_draw_shadow_cache_info_t;
+#endif
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -104,6 +114,19 @@ void lv_draw_rect(const lv_area_t * coords, const lv_area_t * mask, lv_draw_rect
  */
 void lv_draw_px(const lv_point_t * point, const lv_area_t * clip_area, const lv_style_t * style);
 
+#if LV_USE_SHADOW && LV_SHADOW_CACHE_SIZE
+/**
+ * Drop the buffered shadow corners, e.g. to measure the drawing without the cache
+ */
+void lv_draw_shadow_cache_invalidate(void);
+
+/**
+ * Get the usage of the shadow cache
+ * @param info store the result here
+ */
+void lv_draw_shadow_cache_get_info(lv_draw_shadow_cache_info_t * info);
+#endif
+
 /**********************
  *      MACROS
  **********************/
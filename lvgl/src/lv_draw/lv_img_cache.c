@@ -19,19 +19,8 @@
 /*********************
  *      DEFINES
  *********************/
-/*Decrement life with this value in every open*/
-#define LV_IMG_CACHE_AGING 1
-
-/*Boost life by this factor (multiply time_to_open with this value)*/
-#define LV_IMG_CACHE_LIFE_GAIN 1
-
-/*Don't let life to be greater than this limit because it would require a lot of time to
- * "die" from very high values */
-#define LV_IMG_CACHE_LIFE_LIMIT 1000
-
-#if LV_IMG_CACHE_DEF_SIZE < 1
-    #error "LV_IMG_CACHE_DEF_SIZE must be >= 1. See lv_conf.h"
-#endif
+/*Number of hash indexes, must be a power of 2*/
+#define LV_IMG_CACHE_HASH_CNT   32
 
 /**********************
  *      TYPEDEFS
@@ -40,11 +29,27 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static uint32_t src_hash(const void * src, lv_img_src_t src_type, lv_color_t color);
+static bool src_match(const lv_img_cache_entry_t * entry, const void * src, lv_img_src_t src_type, lv_color_t color);
+static uint32_t opened_size(const lv_img_decoder_dsc_t * dsc);
+static void lru_unlink(lv_img_cache_entry_t * entry);
+static void lru_add_first(lv_img_cache_entry_t * entry);
+static void entry_close(lv_img_cache_entry_t * entry);
+static bool cache_init(void);
+static bool cache_full(void);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
-static uint16_t entry_cnt;
+static lv_img_cache_entry_t * lru_first;    /*The most recently used entry*/
+static lv_img_cache_entry_t * lru_last;     /*The least recently used entry, closed first*/
+static uint32_t mem_used;
+static uint32_t mem_max;
+static uint32_t entry_cnt;
+static uint16_t entry_max = 1;
+static uint32_t hit_cnt;
+static uint32_t miss_cnt;
+static uint32_t decode_time;
 
 /**********************
  *      MACROS
@@ -57,126 +62,109 @@ static uint16_t entry_cnt;
 /**
  * Open an image using the image decoder interface and cache it.
  * The image will be left open meaning if the image decoder open callback allocated memory then it will remain.
- * The image is closed if a new image is opened and the new image takes its place in the cache.
+ * The least recently used images are closed when the number of images or the memory budget is exceeded,
+ * the image opened last is kept even if it's larger than the budget.
  * @param src source of the image. Path to file or pointer to an `lv_img_dsc_t` variable
  * @param style style of the image
  * @return pointer to the cache entry or NULL if can open the image
  */
 lv_img_cache_entry_t * _lv_img_cache_open(const void * src, lv_color_t color)
 {
-    if(entry_cnt == 0) {
-        LV_LOG_WARN("lv_img_cache_open: the cache size is 0");
+    lv_img_cache_entry_t ** hash_tbl = LV_GC_ROOT(_lv_img_cache_array);
+    if(hash_tbl == NULL) {
+        LV_LOG_WARN("lv_img_cache_open: the cache is not initialized");
         return NULL;
     }
 
-    lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
-
-    /*Decrement all lifes. Make the entries older*/
-    uint16_t i;
-    for(i = 0; i < entry_cnt; i++) {
-        if(cache[i].life > INT32_MIN + LV_IMG_CACHE_AGING) {
-            cache[i].life -= LV_IMG_CACHE_AGING;
-        }
-    }
-
     /*Is the image cached?*/
-    lv_img_cache_entry_t * cached_src = NULL;
-    for(i = 0; i < entry_cnt; i++) {
-        bool match = false;
-        lv_img_src_t src_type = lv_img_src_get_type(cache[i].dec_dsc.src);
-        if(src_type == LV_IMG_SRC_VARIABLE) {
-            if(cache[i].dec_dsc.src == src && cache[i].dec_dsc.color.full == color.full) match = true;
-        }
-        else if(src_type == LV_IMG_SRC_FILE) {
-            if(strcmp(cache[i].dec_dsc.src, src) == 0) match = true;
-        }
-
-        if(match) {
-            /* If opened increment its life.
-             * Image difficult to open should live longer to keep avoid frequent their recaching.
-             * Therefore increase `life` with `time_to_open`*/
-            cached_src = &cache[i];
-            cached_src->life += cached_src->dec_dsc.time_to_open * LV_IMG_CACHE_LIFE_GAIN;
-            if(cached_src->life > LV_IMG_CACHE_LIFE_LIMIT) cached_src->life = LV_IMG_CACHE_LIFE_LIMIT;
+    lv_img_src_t src_type = lv_img_src_get_type(src);
+    uint32_t hash = src_hash(src, src_type, color);
+    lv_img_cache_entry_t ** hash_head = &hash_tbl[hash & (LV_IMG_CACHE_HASH_CNT - 1)];
+    lv_img_cache_entry_t * entry;
+    for(entry = *hash_head; entry != NULL; entry = entry->hash_next) {
+        if(entry->hash == hash && src_match(entry, src, src_type, color)) {
+            lru_unlink(entry);
+            lru_add_first(entry);
+            hit_cnt++;
             LV_LOG_TRACE("image draw: image found in the cache");
-            break;
+            return entry;
         }
     }
 
-    /*The image is not cached then cache it now*/
-    if(cached_src == NULL) {
-        /*Find an entry to reuse. Select the entry with the least life*/
-        cached_src = &cache[0];
-        for(i = 1; i < entry_cnt; i++) {
-            if(cache[i].life < cached_src->life) {
-                cached_src = &cache[i];
-            }
-        }
-
-        /*Close the decoder to reuse if it was opened (has a valid source)*/
-        if(cached_src->dec_dsc.src) {
-            lv_img_decoder_close(&cached_src->dec_dsc);
-            LV_LOG_INFO("image draw: cache miss, close and reuse an entry");
-        }
-        else {
-            LV_LOG_INFO("image draw: cache miss, cached to an empty entry");
-        }
+    /*The image is not cached then cache it now. Close the least recently used images if there is no memory*/
+    miss_cnt++;
+    entry = lv_mem_alloc(sizeof(lv_img_cache_entry_t));
+    while(entry == NULL && lru_last != NULL) {
+        entry_close(lru_last);
+        entry = lv_mem_alloc(sizeof(lv_img_cache_entry_t));
+    }
+    LV_ASSERT_MEM(entry);
+    if(entry == NULL) return NULL;
+    _lv_memset_00(entry, sizeof(lv_img_cache_entry_t));
 
-        /*Open the image and measure the time to open*/
-        uint32_t t_start;
-        t_start                          = lv_tick_get();
-        cached_src->dec_dsc.time_to_open = 0;
-        lv_res_t open_res                = lv_img_decoder_open(&cached_src->dec_dsc, src, color);
-        if(open_res == LV_RES_INV) {
-            LV_LOG_WARN("Image draw cannot open the image resource");
-            lv_img_decoder_close(&cached_src->dec_dsc);
-            _lv_memset_00(&cached_src->dec_dsc, sizeof(lv_img_decoder_dsc_t));
-            _lv_memset_00(cached_src, sizeof(lv_img_cache_entry_t));
-            cached_src->life = INT32_MIN; /*Make the empty entry very "weak" to force its use  */
-            return NULL;
-        }
+    /*Open the image and measure the time to open*/
+    uint32_t t_start = lv_tick_get();
+    lv_res_t open_res = lv_img_decoder_open(&entry->dec_dsc, src, color);
+    if(open_res == LV_RES_INV) {
+        LV_LOG_WARN("Image draw cannot open the image resource");
+        lv_img_decoder_close(&entry->dec_dsc);
+        lv_mem_free(entry);
+        return NULL;
+    }
 
-        cached_src->life = 0;
+    /*If `time_to_open` was not set in the open function set it here*/
+    if(entry->dec_dsc.time_to_open == 0) {
+        entry->dec_dsc.time_to_open = lv_tick_elaps(t_start);
+    }
+    decode_time += entry->dec_dsc.time_to_open;
+    if(entry->dec_dsc.time_to_open == 0) entry->dec_dsc.time_to_open = 1;
 
-        /*If `time_to_open` was not set in the open function set it here*/
-        if(cached_src->dec_dsc.time_to_open == 0) {
-            cached_src->dec_dsc.time_to_open = lv_tick_elaps(t_start);
-        }
+    entry->hash = hash;
+    entry->mem_size = sizeof(lv_img_cache_entry_t) + opened_size(&entry->dec_dsc);
+    entry->hash_next = *hash_head;
+    *hash_head = entry;
+    lru_add_first(entry);
+    mem_used += entry->mem_size;
+    entry_cnt++;
 
-        if(cached_src->dec_dsc.time_to_open == 0) cached_src->dec_dsc.time_to_open = 1;
+    /*Keep the limits but not by closing the new image*/
+    while(cache_full() && lru_last != entry) {
+        LV_LOG_INFO("image draw: cache is full, close the least recently used image");
+        entry_close(lru_last);
     }
 
-    return cached_src;
+    return entry;
 }
 
 /**
- * Set the number of images to be cached.
- * More cached images mean more opened image at same time which might mean more memory usage.
- * E.g. if 20 PNG or JPG images are open in the RAM they consume memory while opened in the cache.
- * @param new_entry_cnt number of image to cache
+ * Set the number of images to keep opened in the cache.
+ * The least recently used images are closed if there are more.
+ * @param new_entry_cnt number of images to keep opened, at least 1
  */
 void lv_img_cache_set_size(uint16_t new_entry_cnt)
 {
-    if(LV_GC_ROOT(_lv_img_cache_array) != NULL) {
-        /*Clean the cache before free it*/
-        lv_img_cache_invalidate_src(NULL);
-        lv_mem_free(LV_GC_ROOT(_lv_img_cache_array));
-    }
+    if(cache_init() == false) return;
 
-    /*Reallocate the cache*/
-    LV_GC_ROOT(_lv_img_cache_array) = lv_mem_alloc(sizeof(lv_img_cache_entry_t) * new_entry_cnt);
-    LV_ASSERT_MEM(LV_GC_ROOT(_lv_img_cache_array));
-    if(LV_GC_ROOT(_lv_img_cache_array) == NULL) {
-        entry_cnt = 0;
-        return;
+    entry_max = new_entry_cnt > 0 ? new_entry_cnt : 1;
+    while(cache_full() && lru_last != NULL) {
+        entry_close(lru_last);
     }
-    entry_cnt = new_entry_cnt;
+}
 
-    /*Clean the cache*/
-    uint16_t i;
-    for(i = 0; i < entry_cnt; i++) {
-        _lv_memset_00(&LV_GC_ROOT(_lv_img_cache_array)[i].dec_dsc, sizeof(lv_img_decoder_dsc_t));
-        _lv_memset_00(&LV_GC_ROOT(_lv_img_cache_array)[i], sizeof(lv_img_cache_entry_t));
+/**
+ * Set the memory budget of the image cache.
+ * The cache entries, the images decoded to RAM (e.g. PNG or JPG) and the decoders' `user_data`
+ * (e.g. palettes, file handles) are counted, images used directly from their `lv_img_dsc_t` variable only take an entry.
+ * The least recently used images are closed to fit into the new budget.
+ * @param mem_size memory budget in bytes, 0: only the number of images is limited
+ */
+void lv_img_cache_set_mem_size(uint32_t mem_size)
+{
+    if(cache_init() == false) return;
+
+    mem_max = mem_size;
+    while(cache_full() && lru_last != NULL) {
+        entry_close(lru_last);
     }
 }
 
@@ -187,22 +175,156 @@ void lv_img_cache_set_size(uint16_t new_entry_cnt)
  */
 void lv_img_cache_invalidate_src(const void * src)
 {
-
-    lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
-
-    uint16_t i;
-    for(i = 0; i < entry_cnt; i++) {
-        if(cache[i].dec_dsc.src == src || src == NULL) {
-            if(cache[i].dec_dsc.src != NULL) {
-                lv_img_decoder_close(&cache[i].dec_dsc);
-            }
-
-            _lv_memset_00(&cache[i].dec_dsc, sizeof(lv_img_decoder_dsc_t));
-            _lv_memset_00(&cache[i], sizeof(lv_img_cache_entry_t));
+    /*The source can be cached with several colors so check all entries*/
+    lv_img_src_t src_type = src ? lv_img_src_get_type(src) : LV_IMG_SRC_UNKNOWN;
+    lv_img_cache_entry_t * entry = lru_first;
+    while(entry != NULL) {
+        lv_img_cache_entry_t * next = entry->lru_next;
+        if(src == NULL || src_match(entry, src, src_type, entry->dec_dsc.color)) {
+            entry_close(entry);
         }
+        entry = next;
     }
 }
 
+/**
+ * Get the usage of the image cache
+ * @param info store the result here
+ */
+void lv_img_cache_get_info(lv_img_cache_info_t * info)
+{
+    info->hit_cnt = hit_cnt;
+    info->miss_cnt = miss_cnt;
+    info->decode_time = decode_time;
+    info->entry_cnt = entry_cnt;
+    info->entry_max = entry_max;
+    info->mem_size = mem_used;
+    info->mem_max = mem_max;
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
+
+/**
+ * Allocate the hash index of the cache if it's not allocated yet
+ * @return true: the cache can be used
+ */
+static bool cache_init(void)
+{
+    if(LV_GC_ROOT(_lv_img_cache_array) == NULL) {
+        LV_GC_ROOT(_lv_img_cache_array) = lv_mem_alloc(sizeof(lv_img_cache_entry_t *) * LV_IMG_CACHE_HASH_CNT);
+        LV_ASSERT_MEM(LV_GC_ROOT(_lv_img_cache_array));
+        if(LV_GC_ROOT(_lv_img_cache_array) == NULL) return false;
+
+        _lv_memset_00(LV_GC_ROOT(_lv_img_cache_array), sizeof(lv_img_cache_entry_t *) * LV_IMG_CACHE_HASH_CNT);
+    }
+
+    return true;
+}
+
+/**
+ * Check whether the opened images exceed the number of images or the memory budget
+ */
+static bool cache_full(void)
+{
+    if(entry_cnt > entry_max) return true;
+    return mem_max != 0 && mem_used > mem_max;
+}
+
+/**
+ * Hash an image source (FNV-1a). Variables are hashed by their address and color, files by their path.
+ */
+static uint32_t src_hash(const void * src, lv_img_src_t src_type, lv_color_t color)
+{
+    uint32_t hash = 2166136261u;
+    if(src_type == LV_IMG_SRC_VARIABLE) {
+        uintptr_t p = (uintptr_t)src;
+        uint32_t i;
+        for(i = 0; i < sizeof(p); i++) {
+            hash = (hash ^ (uint8_t)(p >> (i * 8))) * 16777619u;
+        }
+        uint32_t c = color.full;
+        for(i = 0; i < sizeof(color); i++) {
+            hash = (hash ^ (uint8_t)(c >> (i * 8))) * 16777619u;
+        }
+    }
+    else {
+        const uint8_t * txt = src;
+        while(*txt) {
+            hash = (hash ^ *txt) * 16777619u;
+            txt++;
+        }
+    }
+
+    return hash;
+}
+
+/**
+ * Check whether an entry is opened from an image source
+ */
+static bool src_match(const lv_img_cache_entry_t * entry, const void * src, lv_img_src_t src_type, lv_color_t color)
+{
+    if(entry->dec_dsc.src_type != src_type) return false;
+
+    if(src_type == LV_IMG_SRC_VARIABLE) {
+        return entry->dec_dsc.src == src && entry->dec_dsc.color.full == color.full;
+    }
+    else {
+        return strcmp(entry->dec_dsc.src, src) == 0;
+    }
+}
+
+/**
+ * Get the memory an opened image takes: the image decoded to RAM, the decoder's `user_data` and the copied file path
+ */
+static uint32_t opened_size(const lv_img_decoder_dsc_t * dsc)
+{
+    uint32_t size = dsc->user_data_size;
+    if(dsc->src_type == LV_IMG_SRC_FILE) size += strlen(dsc->src) + 1;
+
+    if(dsc->img_data == NULL) return size;
+
+    /*Drawn from the variable directly*/
+    if(dsc->src_type == LV_IMG_SRC_VARIABLE && dsc->img_data == ((const lv_img_dsc_t *)dsc->src)->data) return size;
+
+    return size + lv_img_buf_get_img_size(dsc->header.w, dsc->header.h, dsc->header.cf);
+}
+
+static void lru_unlink(lv_img_cache_entry_t * entry)
+{
+    if(entry->lru_prev) entry->lru_prev->lru_next = entry->lru_next;
+    else lru_first = entry->lru_next;
+
+    if(entry->lru_next) entry->lru_next->lru_prev = entry->lru_prev;
+    else lru_last = entry->lru_prev;
+
+    entry->lru_prev = NULL;
+    entry->lru_next = NULL;
+}
+
+static void lru_add_first(lv_img_cache_entry_t * entry)
+{
+    entry->lru_prev = NULL;
+    entry->lru_next = lru_first;
+    if(lru_first) lru_first->lru_prev = entry;
+    else lru_last = entry;
+    lru_first = entry;
+}
+
+/**
+ * Close the image of an entry and free it
+ */
+static void entry_close(lv_img_cache_entry_t * entry)
+{
+    lv_img_cache_entry_t ** prev_next = &LV_GC_ROOT(_lv_img_cache_array)[entry->hash & (LV_IMG_CACHE_HASH_CNT - 1)];
+    while(*prev_next != entry) prev_next = &(*prev_next)->hash_next;
+    *prev_next = entry->hash_next;
+
+    lru_unlink(entry);
+    mem_used -= entry->mem_size;
+    entry_cnt--;
+
+    lv_img_decoder_close(&entry->dec_dsc);
+    lv_mem_free(entry);
+}
@@ -28,15 +28,26 @@ extern "C" {
  *
  * To avoid repeating this heavy load images can be cached.
  */
-typedef struct {
+typedef struct _lv_img_cache_entry_t {
     lv_img_decoder_dsc_t dec_dsc; /**< Image information */
 
-    /** Count the cache entries's life. Add `time_tio_open` to `life` when the entry is used.
-     * Decrement all lifes by one every in every ::lv_img_cache_open.
-     * If life == 0 the entry can be reused */
-    int32_t life;
+    struct _lv_img_cache_entry_t * hash_next;   /**< Next entry with the same hash index*/
+    struct _lv_img_cache_entry_t * lru_prev;    /**< The more recently used entry*/
+    struct _lv_img_cache_entry_t * lru_next;    /**< The less recently used entry*/
+    uint32_t hash;
+    uint32_t mem_size;  /**< Size of the entry, the decoded image and the decoder's data counted in the budget*/
 } lv_img_cache_entry_t;
 
+typedef struct {
+    uint32_t hit_cnt;       /**< Images found opened in the cache*/
+    uint32_t miss_cnt;      /**< Images opened by the decoders*/
+    uint32_t decode_time;   /**< Time spent to open the images by the decoders [ms]*/
+    uint32_t entry_cnt;     /**< Number of opened images*/
+    uint32_t entry_max;     /**< Max. number of opened images*/
+    uint32_t mem_size;      /**< Memory counted in the budget*/
+    uint32_t mem_max;       /**< The memory budget, 0: not limited*/
+} lv_img_cache_info_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -44,7 +55,8 @@ typedef struct {
 /**
  * Open an image using the image decoder interface and cache it.
  * The image will be left open meaning if the image decoder open callback allocated memory then it will remain.
- * The image is closed if a new image is opened and the new image takes its place in the cache.
+ * The least recently used images are closed when the number of images or the memory budget is exceeded,
+ * the image opened last is kept even if it's larger than the budget.
  * @param src source of the image. Path to file or pointer to an `lv_img_dsc_t` variable
  * @param style style of the image
  * @return pointer to the cache entry or NULL if can open the image
@@ -52,12 +64,20 @@ typedef struct {
 lv_img_cache_entry_t * _lv_img_cache_open(const void * src, lv_color_t color);
 
 /**
- * Set the number of images to be cached.
- * More cached images mean more opened image at same time which might mean more memory usage.
- * E.g. if 20 PNG or JPG images are open in the RAM they consume memory while opened in the cache.
- * @param new_entry_cnt number of image to cache
+ * Set the number of images to keep opened in the cache.
+ * The least recently used images are closed if there are more.
+ * @param new_entry_cnt number of images to keep opened, at least 1
  */
-void lv_img_cache_set_size(uint16_t new_slot_num);
+void lv_img_cache_set_size(uint16_t new_entry_cnt);
+
+/**
+ * Set the memory budget of the image cache.
+ * The cache entries, the images decoded to RAM (e.g. PNG or JPG) and the decoders' `user_data`
+ * (e.g. palettes, file handles) are counted, images used directly from their `lv_img_dsc_t` variable only take an entry.
+ * The least recently used images are closed to fit into the new budget.
+ * @param mem_size memory budget in bytes, 0: only the number of images is limited
+ */
+void lv_img_cache_set_mem_size(uint32_t mem_size);
 
 /**
  * Invalidate an image source in the cache.
@@ -66,6 +86,12 @@ void lv_img_cache_set_size(uint16_t new_slot_num);
  */
 void lv_img_cache_invalidate_src(const void * src);
 
+/**
+ * Get the usage of the image cache
+ * @param info store the result here
+ */
+void lv_img_cache_get_info(lv_img_cache_info_t * info);
+
 /**********************
  *      MACROS
  **********************/
@@ -120,6 +120,7 @@ lv_res_t lv_img_decoder_open(lv_img_decoder_dsc_t * dsc, const void * src, lv_co
     dsc->color     = color;
     dsc->src_type  = lv_img_src_get_type(src);
     dsc->user_data = NULL;
+    dsc->user_data_size = 0;
 
     if(dsc->src_type == LV_IMG_SRC_FILE) {
         size_t fnlen = strlen(src);
@@ -342,6 +343,7 @@ lv_res_t lv_img_decoder_built_in_open(lv_img_decoder_t * decoder, lv_img_decoder
                 return LV_RES_INV;
             }
             _lv_memset_00(dsc->user_data, sizeof(lv_img_decoder_built_in_data_t));
+            dsc->user_data_size += sizeof(lv_img_decoder_built_in_data_t);
         }
 
         lv_img_decoder_built_in_data_t * user_data = dsc->user_data;
@@ -354,6 +356,7 @@ lv_res_t lv_img_decoder_built_in_open(lv_img_decoder_t * decoder, lv_img_decoder
         }
 
         _lv_memcpy_small(user_data->f, &f, sizeof(f));
+        dsc->user_data_size += sizeof(f) + f.drv->file_size;
 
 #else
         LV_LOG_WARN("Image built-in decoder cannot read file because LV_USE_FILESYSTEM = 0");
@@ -400,6 +403,7 @@ lv_res_t lv_img_decoder_built_in_open(lv_img_decoder_t * decoder, lv_img_decoder
                 return LV_RES_INV;
             }
             _lv_memset_00(dsc->user_data, sizeof(lv_img_decoder_built_in_data_t));
+            dsc->user_data_size += sizeof(lv_img_decoder_built_in_data_t);
         }
 
         lv_img_decoder_built_in_data_t * user_data = dsc->user_data;
@@ -412,6 +416,7 @@ lv_res_t lv_img_decoder_built_in_open(lv_img_decoder_t * decoder, lv_img_decoder
             lv_img_decoder_built_in_close(decoder, dsc);
             return LV_RES_INV;
         }
+        dsc->user_data_size += palette_size * (sizeof(lv_color_t) + sizeof(lv_opa_t));
 
         if(dsc->src_type == LV_IMG_SRC_FILE) {
             /*Read the palette from file*/
@@ -535,6 +540,7 @@ void lv_img_decoder_built_in_close(lv_img_decoder_t * decoder, lv_img_decoder_ds
         lv_mem_free(user_data);
 
         dsc->user_data = NULL;
+        dsc->user_data_size = 0;
     }
 }
 
@@ -126,6 +126,10 @@ typedef struct _lv_img_decoder_dsc {
 
     /**Store any custom data here is required*/
     void * user_data;
+
+    /**Memory allocated for `user_data` (e.g. palette, file handle) in bytes.
+     * Can be set in `open` function to count it in the memory budget of `lv_img_cache`*/
+    uint32_t user_data_size;
 } lv_img_decoder_dsc_t;
 
 /**********************
@@ -18,6 +18,20 @@
 /*********************
  *      DEFINES
  *********************/
+#if LV_FONT_FMT_TXT_CACHE_CNT
+#if LV_FONT_FMT_TXT_CACHE_CNT >= 0xFFFF
+#error "LV_FONT_FMT_TXT_CACHE_CNT must be less than 65535"
+#endif
+
+#define CACHE_NONE  0xFFFF
+
+/*Glyphs larger than the whole cache are not cached and drawn with the font's bpp*/
+#define CACHE_FITS(gdsc) ((uint32_t)(gdsc)->box_w * (gdsc)->box_h <= LV_FONT_FMT_TXT_CACHE_SIZE)
+#endif
+
+#if LV_FONT_FMT_TXT_FAST_INDEX
+#define FAST_DEGREE_SIGN    0xB0
+#endif
 
 /**********************
  *      TYPEDEFS
@@ -28,34 +42,80 @@ typedef enum {
     RLE_STATE_COUNTER,
 } rle_state_t;
 
+#if LV_FONT_FMT_TXT_CACHE_CNT
+typedef struct {
+    const lv_font_t * font;     /*NULL: free entry*/
+    uint32_t letter;
+    uint32_t gid;               /*Glyph id of the letter, 0: not found*/
+    uint8_t * bitmap;           /*A8 bitmap or NULL if not decoded yet*/
+    uint32_t bitmap_size;
+    uint16_t hash_next;         /*Next entry in the same bucket or in the free list*/
+    uint16_t lru_prev;          /*The more recently used entry*/
+    uint16_t lru_next;          /*The less recently used entry*/
+} glyph_cache_entry_t;
+#endif
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter);
+static uint32_t search_glyph_dsc_id(const lv_font_t * font, uint32_t letter);
 static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t gid_right);
 static int32_t unicode_list_compare(const void * ref, const void * element);
 static int32_t kern_pair_8_compare(const void * ref, const void * element);
 static int32_t kern_pair_16_compare(const void * ref, const void * element);
 
-static void decompress(const uint8_t * in, uint8_t * out, lv_coord_t w, lv_coord_t h, uint8_t bpp);
+static uint32_t glyph_bitmap_bits(const lv_font_fmt_txt_dsc_t * fdsc, uint32_t gid);
+static void decompress(const uint8_t * in, uint8_t * out, lv_coord_t w, lv_coord_t h, uint8_t bpp, uint8_t bit_ofs,
+                       uint32_t bit_num);
+static void bits_align(const uint8_t * in, uint8_t * out, uint8_t bit_ofs, uint32_t bit_num);
 static inline void decompress_line(uint8_t * out, lv_coord_t w);
 static inline uint8_t get_bits(const uint8_t * in, uint32_t bit_pos, uint8_t len);
 static inline void bits_write(uint8_t * out, uint32_t bit_pos, uint8_t val, uint8_t len);
-static inline void rle_init(const uint8_t * in,  uint8_t bpp);
+static inline void rle_init(const uint8_t * in,  uint8_t bpp, uint8_t bit_ofs, uint32_t bit_num);
+static inline uint8_t rle_read(uint8_t len);
 static inline uint8_t rle_next(void);
 
+#if LV_FONT_FMT_TXT_FAST_INDEX
+static const lv_font_fmt_txt_fast_index_t * get_fast_index(const lv_font_t * font);
+static inline int32_t fast_index_slot(uint32_t letter);
+#endif
+
+#if LV_FONT_FMT_TXT_CACHE_CNT
+static uint16_t cache_find(const lv_font_t * font, uint32_t letter);
+static uint16_t cache_get(const lv_font_t * font, uint32_t letter);
+static const uint8_t * cache_get_bitmap(uint16_t id);
+static void cache_drop(uint16_t id);
+static void bitmap_to_a8(const uint8_t * in, uint8_t * out, uint32_t px_num, uint8_t bpp, uint8_t bit_ofs);
+#endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 static uint8_t * decompr_buf;
 static uint32_t rle_rdp;
+static uint32_t rle_rdp_start;
+static uint32_t rle_rdp_end;
+static bool rle_overrun;
 static const uint8_t * rle_in;
 static uint8_t rle_bpp;
 static uint8_t rle_prev_v;
 static uint8_t rle_cnt;
 static rle_state_t rle_state;
 
+#if LV_FONT_FMT_TXT_CACHE_CNT
+static glyph_cache_entry_t cache[LV_FONT_FMT_TXT_CACHE_CNT];
+static uint16_t cache_buckets[LV_FONT_FMT_TXT_CACHE_CNT];
+static uint16_t cache_lru_first;
+static uint16_t cache_lru_last;
+static uint16_t cache_free;
+static bool cache_inited;
+static uint16_t cache_glyph_cnt;
+static uint32_t cache_mem_size;
+static uint32_t cache_hit_cnt;
+static uint32_t cache_miss_cnt;
+#endif
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -79,15 +139,25 @@ const uint8_t * lv_font_get_bitmap_fmt_txt(const lv_font_t * font, uint32_t unic
     if(unicode_letter == '\t') unicode_letter = ' ';
 
     lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *) font->dsc;
+#if LV_FONT_FMT_TXT_CACHE_CNT
+    uint16_t cache_id = cache_get(font, unicode_letter);
+    if(cache_id == CACHE_NONE) return NULL;
+    uint32_t gid = cache[cache_id].gid;
+#else
     uint32_t gid = get_glyph_dsc_id(font, unicode_letter);
     if(!gid) return NULL;
+#endif
 
     const lv_font_fmt_txt_glyph_dsc_t * gdsc = &fdsc->glyph_dsc[gid];
 
-    if(fdsc->bitmap_format == LV_FONT_FMT_TXT_PLAIN) {
+#if LV_FONT_FMT_TXT_CACHE_CNT
+    if(CACHE_FITS(gdsc)) return cache_get_bitmap(cache_id);
+#endif
+
+    if(fdsc->bitmap_format == LV_FONT_FMT_TXT_PLAIN && fdsc->bitmap_bit_ofs == 0) {
         if(gdsc) return &fdsc->glyph_bitmap[gdsc->bitmap_index];
     }
-    /*Handle compressed bitmap*/
+    /*Handle compressed bitmap and plain bitmaps not starting on a byte boundary*/
     else {
         uint32_t gsize = gdsc->box_w * gdsc->box_h;
         if(gsize == 0) return NULL;
@@ -115,7 +185,17 @@ const uint8_t * lv_font_get_bitmap_fmt_txt(const lv_font_t * font, uint32_t unic
             if(decompr_buf == NULL) return NULL;
         }
 
-        decompress(&fdsc->glyph_bitmap[gdsc->bitmap_index], decompr_buf, gdsc->box_w, gdsc->box_h, (uint8_t)fdsc->bpp);
+        if(fdsc->bitmap_format == LV_FONT_FMT_TXT_PLAIN) {
+            bits_align(&fdsc->glyph_bitmap[gdsc->bitmap_index], decompr_buf, fdsc->bitmap_bit_ofs, gsize * fdsc->bpp);
+        }
+        else {
+            decompress(&fdsc->glyph_bitmap[gdsc->bitmap_index], decompr_buf, gdsc->box_w, gdsc->box_h,
+                       (uint8_t)fdsc->bpp, fdsc->bitmap_bit_ofs, glyph_bitmap_bits(fdsc, gid));
+            if(rle_overrun) {
+                LV_LOG_WARN("lv_font_get_bitmap_fmt_txt: the compressed bitmap runs past its glyph");
+                return NULL;
+            }
+        }
         return decompr_buf;
     }
 
@@ -140,14 +220,55 @@ bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t *
         is_tab = true;
     }
     lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *) font->dsc;
-    uint32_t gid = get_glyph_dsc_id(font, unicode_letter);
+#if LV_FONT_FMT_TXT_FAST_INDEX
+    const lv_font_fmt_txt_fast_index_t * fast = get_fast_index(font);
+    int32_t slot = fast_index_slot(unicode_letter);
+    int32_t slot_next = fast_index_slot(unicode_letter_next);
+#endif
+
+    uint32_t gid;
+#if LV_FONT_FMT_TXT_FAST_INDEX
+    if(fast && slot >= 0) gid = fast->glyph_id[slot];
+    else
+#endif
+    {
+#if LV_FONT_FMT_TXT_CACHE_CNT
+        uint16_t cache_id = cache_get(font, unicode_letter);
+        gid = cache_id != CACHE_NONE ? cache[cache_id].gid : 0;
+#else
+        gid = get_glyph_dsc_id(font, unicode_letter);
+#endif
+    }
     if(!gid) return false;
 
     int8_t kvalue = 0;
-    if(fdsc->kern_dsc) {
-        uint32_t gid_next = get_glyph_dsc_id(font, unicode_letter_next);
-        if(gid_next) {
-            kvalue = get_kern_value(font, gid, gid_next);
+    /*No kerning with the end of the text and control codes, e.g. '\n'*/
+    if(fdsc->kern_dsc && unicode_letter_next >= 0x20) {
+#if LV_FONT_FMT_TXT_FAST_INDEX
+        if(fast && fast->kern && slot >= 0 && slot_next >= 0) {
+            kvalue = fast->kern[slot * LV_FONT_FMT_TXT_FAST_CNT + slot_next];
+        }
+        else
+#endif
+        {
+            uint32_t gid_next;
+#if LV_FONT_FMT_TXT_FAST_INDEX
+            if(fast && slot_next >= 0) gid_next = fast->glyph_id[slot_next];
+            else
+#endif
+            {
+#if LV_FONT_FMT_TXT_CACHE_CNT
+                /*Only peek into the cache, the next letter is added when it is drawn*/
+                uint16_t cache_id_next = cache_find(font, unicode_letter_next);
+                if(cache_id_next != CACHE_NONE) gid_next = cache[cache_id_next].gid;
+                else gid_next = get_glyph_dsc_id(font, unicode_letter_next);
+#else
+                gid_next = get_glyph_dsc_id(font, unicode_letter_next);
+#endif
+            }
+            if(gid_next) {
+                kvalue = get_kern_value(font, gid, gid_next);
+            }
         }
     }
 
@@ -167,7 +288,12 @@ bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t *
     dsc_out->box_w = gdsc->box_w;
     dsc_out->ofs_x = gdsc->ofs_x;
     dsc_out->ofs_y = gdsc->ofs_y;
+#if LV_FONT_FMT_TXT_CACHE_CNT
+    /*The cached bitmaps are A8*/
+    dsc_out->bpp   = CACHE_FITS(gdsc) ? 8 : (uint8_t)fdsc->bpp;
+#else
     dsc_out->bpp   = (uint8_t)fdsc->bpp;
+#endif
 
     if(is_tab) dsc_out->box_w = dsc_out->box_w * 2;
 
@@ -185,12 +311,87 @@ void _lv_font_clean_up_fmt_txt(void)
     }
 }
 
+/**
+ * Free the cached glyphs and the lookup tables built for a font.
+ * Call it before freeing a font created at run time.
+ * @param font pointer to a font
+ */
+void _lv_font_fmt_txt_release(const lv_font_t * font)
+{
+    lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *) font->dsc;
+
+#if LV_FONT_FMT_TXT_CACHE_CNT
+    lv_font_fmt_txt_cache_invalidate(font);
+#endif
+
+#if LV_FONT_FMT_TXT_FAST_INDEX
+    if(fdsc->fast_index) {
+        if(fdsc->fast_index->kern) lv_mem_free(fdsc->fast_index->kern);
+        lv_mem_free(fdsc->fast_index);
+        fdsc->fast_index = NULL;
+    }
+    fdsc->fast_index_failed = 0;
+#endif
+
+    fdsc->last_letter = 0;
+    fdsc->last_glyph_id = 0;
+}
+
+#if LV_FONT_FMT_TXT_CACHE_CNT
+/**
+ * Remove the cached glyphs of a font, e.g. before freeing it.
+ * @param font pointer to a font or NULL to remove all cached glyphs
+ */
+void lv_font_fmt_txt_cache_invalidate(const lv_font_t * font)
+{
+    if(!cache_inited) return;
+
+    uint16_t i;
+    for(i = 0; i < LV_FONT_FMT_TXT_CACHE_CNT; i++) {
+        if(cache[i].font && (font == NULL || cache[i].font == font)) cache_drop(i);
+    }
+}
+
+/**
+ * Get the usage of the glyph cache
+ * @param info store the result here
+ */
+void lv_font_fmt_txt_cache_get_info(lv_font_fmt_txt_cache_info_t * info)
+{
+    info->hit_cnt = cache_hit_cnt;
+    info->miss_cnt = cache_miss_cnt;
+    info->glyph_cnt = cache_glyph_cnt;
+    info->mem_size = cache_mem_size;
+}
+#endif
+
 
 /**********************
  *   STATIC FUNCTIONS
  **********************/
 
 static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
+{
+    if(letter == '\0') return 0;
+
+#if LV_FONT_FMT_TXT_FAST_INDEX
+    int32_t slot = fast_index_slot(letter);
+    if(slot >= 0) {
+        const lv_font_fmt_txt_fast_index_t * fast = get_fast_index(font);
+        if(fast) return fast->glyph_id[slot];
+    }
+#endif
+
+    return search_glyph_dsc_id(font, letter);
+}
+
+/**
+ * Search a letter in the cmaps of a font
+ * @param font pointer to a font
+ * @param letter an UNICODE letter code
+ * @return the glyph id or 0 if not found
+ */
+static uint32_t search_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
 {
     if(letter == '\0') return 0;
 
@@ -204,7 +405,7 @@ static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
 
         /*Relative code point*/
         uint32_t rcp = letter - fdsc->cmaps[i].range_start;
-        if(rcp > fdsc->cmaps[i].range_length) continue;
+        if(rcp >= fdsc->cmaps[i].range_length) continue;
         uint32_t glyph_id = 0;
         if(fdsc->cmaps[i].type == LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY) {
             glyph_id = fdsc->cmaps[i].glyph_id_start + rcp;
@@ -230,7 +431,7 @@ static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
             if(p) {
                 lv_uintptr_t ofs = (lv_uintptr_t)(p - (uint8_t *) fdsc->cmaps[i].unicode_list);
                 ofs = ofs >> 1;     /*The list stores `uint16_t` so the get the index divide by 2*/
-                const uint8_t * gid_ofs_16 = fdsc->cmaps[i].glyph_id_ofs_list;
+                const uint16_t * gid_ofs_16 = fdsc->cmaps[i].glyph_id_ofs_list;
                 glyph_id = fdsc->cmaps[i].glyph_id_start + gid_ofs_16[ofs];
             }
         }
@@ -247,6 +448,295 @@ static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
 
 }
 
+#if LV_FONT_FMT_TXT_FAST_INDEX
+
+/**
+ * Get the index of a letter in the fast index
+ * @param letter an UNICODE letter code
+ * @return the index or -1 if the letter has no direct lookup
+ */
+static inline int32_t fast_index_slot(uint32_t letter)
+{
+    if(letter - 0x20 <= 0x7F - 0x20) return letter - 0x20;
+    if(letter == FAST_DEGREE_SIGN) return LV_FONT_FMT_TXT_FAST_CNT - 1;
+    return -1;
+}
+
+/**
+ * Get the fast index of a font, build it on the first call.
+ * If it can't be allocated the font keeps searching the letters, the allocation is not retried.
+ * @param font pointer to a font
+ * @return the fast index or NULL if it couldn't be allocated
+ */
+static const lv_font_fmt_txt_fast_index_t * get_fast_index(const lv_font_t * font)
+{
+    lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *) font->dsc;
+    if(fdsc->fast_index) return fdsc->fast_index;
+    if(fdsc->fast_index_failed) return NULL;
+
+    lv_font_fmt_txt_fast_index_t * fast = lv_mem_alloc(sizeof(lv_font_fmt_txt_fast_index_t));
+    if(fast == NULL) {
+        LV_LOG_WARN("get_fast_index: no memory for the fast index, searching the letters");
+        fdsc->fast_index_failed = 1;
+        return NULL;
+    }
+
+    uint32_t i;
+    for(i = 0; i < LV_FONT_FMT_TXT_FAST_CNT; i++) {
+        uint32_t letter = i < LV_FONT_FMT_TXT_FAST_CNT - 1 ? 0x20 + i : FAST_DEGREE_SIGN;
+        fast->glyph_id[i] = search_glyph_dsc_id(font, letter);
+    }
+
+    /*Kerning pairs are binary searched so store them in a matrix*/
+    fast->kern = NULL;
+    if(fdsc->kern_dsc && fdsc->kern_classes == 0) {
+        fast->kern = lv_mem_alloc(LV_FONT_FMT_TXT_FAST_CNT * LV_FONT_FMT_TXT_FAST_CNT);
+        if(fast->kern) {
+            uint32_t left;
+            uint32_t right;
+            for(left = 0; left < LV_FONT_FMT_TXT_FAST_CNT; left++) {
+                for(right = 0; right < LV_FONT_FMT_TXT_FAST_CNT; right++) {
+                    uint32_t gid_left = fast->glyph_id[left];
+                    uint32_t gid_right = fast->glyph_id[right];
+                    fast->kern[left * LV_FONT_FMT_TXT_FAST_CNT + right] =
+                        (gid_left && gid_right) ? get_kern_value(font, gid_left, gid_right) : 0;
+                }
+            }
+        }
+        else {
+            LV_LOG_WARN("get_fast_index: no memory for the kerning matrix, using the kerning pairs");
+        }
+    }
+
+    fdsc->fast_index = fast;
+    return fast;
+}
+
+#endif /*LV_FONT_FMT_TXT_FAST_INDEX*/
+
+#if LV_FONT_FMT_TXT_CACHE_CNT
+
+static uint32_t cache_hash(const lv_font_t * font, uint32_t letter)
+{
+    return (uint32_t)(((lv_uintptr_t)font >> 2) ^ (letter * 2654435761u)) % LV_FONT_FMT_TXT_CACHE_CNT;
+}
+
+static void cache_init(void)
+{
+    uint16_t i;
+    for(i = 0; i < LV_FONT_FMT_TXT_CACHE_CNT; i++) {
+        cache_buckets[i] = CACHE_NONE;
+        cache[i].hash_next = i + 1 < LV_FONT_FMT_TXT_CACHE_CNT ? i + 1 : CACHE_NONE;
+    }
+    cache_free = 0;
+    cache_lru_first = CACHE_NONE;
+    cache_lru_last = CACHE_NONE;
+    cache_inited = true;
+}
+
+static void cache_lru_unlink(uint16_t id)
+{
+    glyph_cache_entry_t * e = &cache[id];
+    if(e->lru_prev != CACHE_NONE) cache[e->lru_prev].lru_next = e->lru_next;
+    else cache_lru_first = e->lru_next;
+    if(e->lru_next != CACHE_NONE) cache[e->lru_next].lru_prev = e->lru_prev;
+    else cache_lru_last = e->lru_prev;
+}
+
+static void cache_lru_add_first(uint16_t id)
+{
+    cache[id].lru_prev = CACHE_NONE;
+    cache[id].lru_next = cache_lru_first;
+    if(cache_lru_first != CACHE_NONE) cache[cache_lru_first].lru_prev = id;
+    else cache_lru_last = id;
+    cache_lru_first = id;
+}
+
+/**
+ * Find a letter in the glyph cache without changing the order of the entries
+ * @param font pointer to a font
+ * @param letter an UNICODE letter code
+ * @return index of the entry in `cache` or `CACHE_NONE` if the letter is not cached
+ */
+static uint16_t cache_find(const lv_font_t * font, uint32_t letter)
+{
+    if(!cache_inited) cache_init();
+
+    uint16_t id;
+    for(id = cache_buckets[cache_hash(font, letter)]; id != CACHE_NONE; id = cache[id].hash_next) {
+        if(cache[id].font == font && cache[id].letter == letter) return id;
+    }
+    return CACHE_NONE;
+}
+
+/**
+ * Find a letter in the glyph cache or add it, dropping the least recently used glyph if the cache is full.
+ * The entry becomes the most recently used one. Letters without a glyph in the font are not cached.
+ * @param font pointer to a font
+ * @param letter an UNICODE letter code
+ * @return index of the entry in `cache` or `CACHE_NONE` if the font has no glyph for the letter
+ */
+static uint16_t cache_get(const lv_font_t * font, uint32_t letter)
+{
+    uint16_t id = cache_find(font, letter);
+    if(id != CACHE_NONE) {
+        cache_hit_cnt++;
+        if(cache_lru_first != id) {
+            cache_lru_unlink(id);
+            cache_lru_add_first(id);
+        }
+        return id;
+    }
+
+    cache_miss_cnt++;
+    uint32_t gid = get_glyph_dsc_id(font, letter);
+    if(gid == 0) return CACHE_NONE;
+
+    if(cache_free == CACHE_NONE) cache_drop(cache_lru_last);
+
+    id = cache_free;
+    glyph_cache_entry_t * e = &cache[id];
+    cache_free = e->hash_next;
+
+    uint32_t h = cache_hash(font, letter);
+    e->font = font;
+    e->letter = letter;
+    e->gid = gid;
+    e->bitmap = NULL;
+    e->bitmap_size = 0;
+    e->hash_next = cache_buckets[h];
+    cache_buckets[h] = id;
+    cache_lru_add_first(id);
+    cache_glyph_cnt++;
+
+    return id;
+}
+
+/**
+ * Get the A8 bitmap of a cached glyph, decode it if required.
+ * Drops the least recently used bitmaps to keep the cache in `LV_FONT_FMT_TXT_CACHE_SIZE`.
+ * @param id index of a cache entry returned by `cache_get()`. Should be the most recently used.
+ * @return pointer to the bitmap or NULL on error
+ */
+static const uint8_t * cache_get_bitmap(uint16_t id)
+{
+    glyph_cache_entry_t * e = &cache[id];
+    if(e->bitmap) return e->bitmap;
+
+    lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *) e->font->dsc;
+    const lv_font_fmt_txt_glyph_dsc_t * gdsc = &fdsc->glyph_dsc[e->gid];
+    uint32_t px_num = (uint32_t)gdsc->box_w * gdsc->box_h;
+    if(px_num == 0) return NULL;
+
+    while(cache_mem_size + px_num > LV_FONT_FMT_TXT_CACHE_SIZE && cache_lru_last != id) {
+        cache_drop(cache_lru_last);
+    }
+
+    uint8_t * bitmap = lv_mem_alloc(px_num);
+    while(bitmap == NULL && cache_lru_last != id) {
+        cache_drop(cache_lru_last);
+        bitmap = lv_mem_alloc(px_num);
+    }
+    LV_ASSERT_MEM(bitmap);
+    if(bitmap == NULL) return NULL;
+
+    uint8_t bpp = (uint8_t)fdsc->bpp;
+    if(fdsc->bitmap_format == LV_FONT_FMT_TXT_PLAIN) {
+        bitmap_to_a8(&fdsc->glyph_bitmap[gdsc->bitmap_index], bitmap, px_num, bpp, fdsc->bitmap_bit_ofs);
+    }
+    else {
+        /*Decompress to the font's bpp (3 bpp is upscaled to 4) then convert*/
+        uint8_t * packed = _lv_mem_buf_get((px_num * (bpp == 3 ? 4 : bpp) + 7) >> 3);
+        decompress(&fdsc->glyph_bitmap[gdsc->bitmap_index], packed, gdsc->box_w, gdsc->box_h, bpp,
+                   fdsc->bitmap_bit_ofs, glyph_bitmap_bits(fdsc, e->gid));
+        bitmap_to_a8(packed, bitmap, px_num, bpp, 0);
+        _lv_mem_buf_release(packed);
+        if(rle_overrun) {
+            LV_LOG_WARN("cache_get_bitmap: the compressed bitmap runs past its glyph");
+            lv_mem_free(bitmap);
+            return NULL;
+        }
+    }
+
+    e->bitmap = bitmap;
+    e->bitmap_size = px_num;
+    cache_mem_size += px_num;
+
+    return bitmap;
+}
+
+/**
+ * Remove an entry from the glyph cache and free its bitmap
+ * @param id index of the entry in `cache`
+ */
+static void cache_drop(uint16_t id)
+{
+    glyph_cache_entry_t * e = &cache[id];
+
+    uint16_t * p = &cache_buckets[cache_hash(e->font, e->letter)];
+    while(*p != id) p = &cache[*p].hash_next;
+    *p = e->hash_next;
+
+    cache_lru_unlink(id);
+
+    if(e->bitmap) {
+        lv_mem_free(e->bitmap);
+        cache_mem_size -= e->bitmap_size;
+        e->bitmap = NULL;
+    }
+
+    e->font = NULL;
+    e->hash_next = cache_free;
+    cache_free = id;
+    cache_glyph_cnt--;
+}
+
+/**
+ * Convert a bitmap to one byte per pixel with the opacity tables of `lv_draw_letter`
+ * so the glyph is drawn the same.
+ * @param in bitmap with `bpp` bits per pixel (`bpp = 3` is read as 4 like in `lv_draw_letter`)
+ * @param out buffer for `px_num` bytes
+ * @param px_num number of pixels in the glyph (width * height)
+ * @param bpp bit per pixel of `in`
+ * @param bit_ofs the bitmap starts at this bit of `in[0]`
+ */
+static void bitmap_to_a8(const uint8_t * in, uint8_t * out, uint32_t px_num, uint8_t bpp, uint8_t bit_ofs)
+{
+    const uint8_t * opa_table;
+    switch(bpp) {
+        case 1:
+            opa_table = _lv_bpp1_opa_table;
+            break;
+        case 2:
+            opa_table = _lv_bpp2_opa_table;
+            break;
+        case 3:
+        case 4:
+            bpp = 4;
+            opa_table = _lv_bpp4_opa_table;
+            break;
+        default:
+            if(bit_ofs) bits_align(in, out, bit_ofs, px_num << 3);
+            else _lv_memcpy(out, in, px_num);
+            return;
+    }
+
+    uint8_t bit_mask = (1 << bpp) - 1;
+    uint32_t bit_pos = bit_ofs;
+    uint32_t i;
+    for(i = 0; i < px_num; i++) {
+        /*With a bit offset the pixels can cross byte boundaries*/
+        uint32_t byte_pos = bit_pos >> 3;
+        uint8_t shift = bit_pos & 0x7;
+        uint16_t in16 = in[byte_pos] << 8;
+        if(shift + bpp > 8) in16 |= in[byte_pos + 1];
+        out[i] = opa_table[(in16 >> (16 - shift - bpp)) & bit_mask];
+        bit_pos += bpp;
+    }
+}
+
+#endif /*LV_FONT_FMT_TXT_CACHE_CNT*/
+
 static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t gid_right)
 {
     lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *) font->dsc;
@@ -274,13 +764,13 @@ static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t
             /* Use binary search to find the kern value.
              * The pairs are ordered left_id first, then right_id secondly. */
             const uint16_t * g_ids = kdsc->glyph_ids;
-            lv_uintptr_t g_id_both = (uint32_t)((uint32_t)gid_right << 8) + gid_left; /*Create one number from the ids*/
-            uint8_t * kid_p = _lv_utils_bsearch(&g_id_both, g_ids, kdsc->pair_cnt, 4, kern_pair_16_compare);
+            uint16_t g_id_both[2] = {(uint16_t)gid_left, (uint16_t)gid_right};
+            uint8_t * kid_p = _lv_utils_bsearch(g_id_both, g_ids, kdsc->pair_cnt, 4, kern_pair_16_compare);
 
             /*If the `g_id_both` were found get its index from the pointer*/
             if(kid_p) {
                 lv_uintptr_t ofs = (lv_uintptr_t)(kid_p - (const uint8_t *)g_ids);
-                ofs = ofs >> 4;     /*ofs is 4 byte pairs, divide by 4 to refer as a single value*/
+                ofs = ofs >> 2;     /*ofs is 4 byte pairs, divide by 4 to refer as a single value*/
                 value = kdsc->values[ofs];
             }
 
@@ -326,20 +816,39 @@ static int32_t kern_pair_16_compare(const void * ref, const void * element)
     else return (int32_t) ref16_p[1] - element16_p[1];
 }
 
+/**
+ * Get the number of bits the compressed bitmap of a glyph can be read from
+ * @param fdsc pointer to a font descriptor
+ * @param gid id of a glyph with a bitmap
+ * @return the bits counted from the byte at `bitmap_index`, not bounded for the C fonts
+ */
+static uint32_t glyph_bitmap_bits(const lv_font_fmt_txt_dsc_t * fdsc, uint32_t gid)
+{
+    if(fdsc->bitmap_size == 0) return UINT32_MAX;
+
+    uint32_t end = gid + 1 < fdsc->glyph_cnt ? fdsc->glyph_dsc[gid + 1].bitmap_index : fdsc->bitmap_size;
+    uint32_t start = fdsc->glyph_dsc[gid].bitmap_index;
+    return end > start ? (end - start) * 8 : 0;
+}
+
 /**
  * The compress a glyph's bitmap
  * @param in the compressed bitmap
  * @param out buffer to store the result
  * @param px_num number of pixels in the glyph (width * height)
  * @param bpp bit per pixel (bpp = 3 will be converted to bpp = 4)
+ * @param bit_ofs the compressed bitmap starts at this bit of `in[0]`
+ * @param bit_num the bits of `in` which can be read, counted from `in[0]`. A corrupt bitmap which
+ * doesn't end in them is decompressed with 0 for the missing bits.
  */
-static void decompress(const uint8_t * in, uint8_t * out, lv_coord_t w, lv_coord_t h, uint8_t bpp)
+static void decompress(const uint8_t * in, uint8_t * out, lv_coord_t w, lv_coord_t h, uint8_t bpp, uint8_t bit_ofs,
+                       uint32_t bit_num)
 {
     uint32_t wrp = 0;
     uint8_t wr_size = bpp;
     if(bpp == 3) wr_size = 4;
 
-    rle_init(in, bpp);
+    rle_init(in, bpp, bit_ofs, bit_num);
 
     uint8_t * line_buf1 = _lv_mem_buf_get(w);
     uint8_t * line_buf2 = _lv_mem_buf_get(w);
@@ -368,6 +877,25 @@ static void decompress(const uint8_t * in, uint8_t * out, lv_coord_t w, lv_coord
     _lv_mem_buf_release(line_buf2);
 }
 
+/**
+ * Copy a bitmap which doesn't start on a byte boundary to a byte aligned buffer
+ * @param in the input buffer
+ * @param out buffer for `(bit_num + 7) / 8` bytes
+ * @param bit_ofs the bitmap starts at this bit of `in[0]`
+ * @param bit_num size of the bitmap in bits. The bytes of `in` after the bitmap are not read.
+ */
+static void bits_align(const uint8_t * in, uint8_t * out, uint8_t bit_ofs, uint32_t bit_num)
+{
+    uint32_t out_size = (bit_num + 7) >> 3;
+    uint32_t in_size = (bit_ofs + bit_num + 7) >> 3;
+    uint32_t i;
+    for(i = 0; i < out_size; i++) {
+        uint8_t v = in[i] << bit_ofs;
+        if(i + 1 < in_size) v |= in[i + 1] >> (8 - bit_ofs);
+        out[i] = v;
+    }
+}
+
 /**
  * Decompress one line. Store one pixel per byte
  * @param out output buffer
@@ -414,7 +942,8 @@ static inline uint8_t get_bits(const uint8_t * in, uint32_t bit_pos, uint8_t len
     uint32_t byte_pos = bit_pos >> 3;
     bit_pos = bit_pos & 0x7;
 
-    if(bit_pos + len >= 8) {
+    /*Don't read the next byte if not required, it might be after the end of a mapped file*/
+    if(bit_pos + len > 8) {
         uint16_t in16 = (in[byte_pos] << 8) + in[byte_pos + 1];
         return (in16 >> (16 - bit_pos - len)) & bit_mask;
     }
@@ -472,55 +1001,69 @@ static inline void bits_write(uint8_t * out, uint32_t bit_pos, uint8_t val, uint
     out[byte_pos] |= (val << bit_pos);
 }
 
-static inline void rle_init(const uint8_t * in,  uint8_t bpp)
+static inline void rle_init(const uint8_t * in,  uint8_t bpp, uint8_t bit_ofs, uint32_t bit_num)
 {
     rle_in = in;
     rle_bpp = bpp;
     rle_state = RLE_STATE_SINGLE;
-    rle_rdp = 0;
+    rle_rdp = bit_ofs;
+    rle_rdp_start = bit_ofs;
+    rle_rdp_end = bit_num;
+    rle_overrun = false;
     rle_prev_v = 0;
     rle_cnt = 0;
 }
 
+/**
+ * Read the next bits of the compressed bitmap.
+ * The bits after `rle_rdp_end` are never read, they are 0 and `rle_overrun` is set.
+ * @param len number of bits to read (must be <= 8)
+ * @return the read bits
+ */
+static inline uint8_t rle_read(uint8_t len)
+{
+    uint8_t v = 0;
+    if(rle_rdp <= rle_rdp_end && len <= rle_rdp_end - rle_rdp) v = get_bits(rle_in, rle_rdp, len);
+    else rle_overrun = true;
+    rle_rdp += len;
+    return v;
+}
+
 static inline uint8_t rle_next(void)
 {
     uint8_t v = 0;
     uint8_t ret = 0;
 
     if(rle_state == RLE_STATE_SINGLE) {
-        ret = get_bits(rle_in, rle_rdp, rle_bpp);
-        if(rle_rdp != 0 && rle_prev_v == ret) {
+        bool first = rle_rdp == rle_rdp_start;
+        ret = rle_read(rle_bpp);
+        if(!first && rle_prev_v == ret) {
             rle_cnt = 0;
             rle_state = RLE_STATE_REPEATE;
         }
 
         rle_prev_v = ret;
-        rle_rdp += rle_bpp;
     }
     else if(rle_state == RLE_STATE_REPEATE) {
-        v = get_bits(rle_in, rle_rdp, 1);
+        v = rle_read(1);
         rle_cnt++;
-        rle_rdp += 1;
         if(v == 1) {
             ret = rle_prev_v;
             if(rle_cnt == 11) {
-                rle_cnt = get_bits(rle_in, rle_rdp, 6);
-                rle_rdp += 6;
+                rle_cnt = rle_read(6);
                 if(rle_cnt != 0) {
                     rle_state = RLE_STATE_COUNTER;
                 }
                 else {
-                    ret = get_bits(rle_in, rle_rdp, rle_bpp);
+                    ret = rle_read(rle_bpp);
                     rle_prev_v = ret;
-                    rle_rdp += rle_bpp;
                     rle_state = RLE_STATE_SINGLE;
                 }
             }
         }
         else {
-            ret = get_bits(rle_in, rle_rdp, rle_bpp);
+            ret = rle_read(rle_bpp);
             rle_prev_v = ret;
-            rle_rdp += rle_bpp;
             rle_state = RLE_STATE_SINGLE;
         }
 
@@ -530,9 +1073,8 @@ static inline uint8_t rle_next(void)
         ret = rle_prev_v;
         rle_cnt--;
         if(rle_cnt == 0) {
-            ret = get_bits(rle_in, rle_rdp, rle_bpp);
+            ret = rle_read(rle_bpp);
             rle_prev_v = ret;
-            rle_rdp += rle_bpp;
             rle_state = RLE_STATE_SINGLE;
         }
     }
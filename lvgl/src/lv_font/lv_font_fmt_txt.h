@@ -21,6 +21,10 @@ extern "C" {
 /*********************
  *      DEFINES
  *********************/
+#if LV_FONT_FMT_TXT_FAST_INDEX
+/*Letters looked up with a direct index: U+0020..U+007F and the degree sign (U+00B0)*/
+#define LV_FONT_FMT_TXT_FAST_CNT    (0x7F - 0x20 + 1 + 1)
+#endif
 
 /**********************
  *      TYPEDEFS
@@ -153,6 +157,20 @@ typedef enum {
 } lv_font_fmt_txt_bitmap_format_t;
 
 
+#if LV_FONT_FMT_TXT_FAST_INDEX
+/*Glyph ids and kerning values of the common letters, indexed directly by the letter*/
+typedef struct {
+#if LV_FONT_FMT_TXT_LARGE == 0
+    uint16_t glyph_id[LV_FONT_FMT_TXT_FAST_CNT];
+#else
+    uint32_t glyph_id[LV_FONT_FMT_TXT_FAST_CNT];
+#endif
+    /* Kerning of the letter pairs: `kern[left * LV_FONT_FMT_TXT_FAST_CNT + right]`.
+     * Only for kerning pairs, NULL with kerning classes (they are looked up directly anyway)*/
+    int8_t * kern;
+} lv_font_fmt_txt_fast_index_t;
+#endif
+
 /*Describe store additional data for fonts */
 typedef struct {
     /*The bitmaps os all glyphs*/
@@ -189,12 +207,40 @@ typedef struct {
      */
     uint16_t bitmap_format  : 2;
 
+    /* The bitmaps start at this bit of `glyph_bitmap[bitmap_index]`.
+     * 0 for the C fonts, binary fonts can store the bitmaps after bit packed glyph headers*/
+    uint16_t bitmap_bit_ofs : 3;
+
+    /* Bound the reads of the compressed bitmaps of fonts loaded at run time, 0 for the C fonts.
+     * The bitmap of glyph `i` is read at most up to the bitmap of glyph `i + 1`,
+     * the bitmap of the last glyph up to `bitmap_size` bytes of `glyph_bitmap`*/
+    uint32_t bitmap_size;
+    uint32_t glyph_cnt;
+
     /*Cache the last letter and is glyph id*/
     uint32_t last_letter;
     uint32_t last_glyph_id;
 
+#if LV_FONT_FMT_TXT_FAST_INDEX
+    /*Built on the first lookup of the font*/
+    lv_font_fmt_txt_fast_index_t * fast_index;
+
+    /*The fast index couldn't be allocated, don't try again and search the letters*/
+    uint8_t fast_index_failed;
+#endif
+
 } lv_font_fmt_txt_dsc_t;
 
+#if LV_FONT_FMT_TXT_CACHE_CNT
+/*Usage of the glyph cache*/
+typedef struct {
+    uint32_t hit_cnt;       /*Glyph lookups found in the cache*/
+    uint32_t miss_cnt;      /*Glyph lookups added to the cache*/
+    uint16_t glyph_cnt;     /*Number of cached glyphs*/
+    uint32_t mem_size;      /*Memory of the cached bitmaps in bytes*/
+} lv_font_fmt_txt_cache_info_t;
+#endif
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -223,6 +269,27 @@ bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t *
  */
 void _lv_font_clean_up_fmt_txt(void);
 
+/**
+ * Free the cached glyphs and the lookup tables built for a font.
+ * Call it before freeing a font created at run time.
+ * @param font pointer to a font
+ */
+void _lv_font_fmt_txt_release(const lv_font_t * font);
+
+#if LV_FONT_FMT_TXT_CACHE_CNT
+/**
+ * Remove the cached glyphs of a font, e.g. before freeing it.
+ * @param font pointer to a font or NULL to remove all cached glyphs
+ */
+void lv_font_fmt_txt_cache_invalidate(const lv_font_t * font);
+
+/**
+ * Get the usage of the glyph cache
+ * @param info store the result here
+ */
+void lv_font_fmt_txt_cache_get_info(lv_font_fmt_txt_cache_info_t * info);
+#endif
+
 /**********************
  *      MACROS
  **********************/
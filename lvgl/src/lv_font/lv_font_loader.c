@@ -0,0 +1,515 @@
+/**
+ * @file lv_font_loader.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_font_loader.h"
+
+#if LV_USE_FONT_LOADER
+#include "lv_font_fmt_txt.h"
+#include "../lv_core/lv_debug.h"
+#include "../lv_misc/lv_log.h"
+#include "../lv_misc/lv_mem.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TABLE_HEADER_SIZE   8       /*Length and label before the data of every table*/
+#define HEAD_SIZE           36      /*Used part of the `head` table (without the underline fields)*/
+#define CMAP_SUBTABLE_SIZE  16
+
+#define KERN_FORMAT_PAIRS   0
+#define KERN_FORMAT_CLASSES 3
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/*The fields of the `head` table used by the font*/
+typedef struct {
+    int16_t ascent;
+    int16_t descent;
+    uint16_t default_advance_width;
+    uint16_t kerning_scale;
+    uint8_t index_to_loc_format;
+    uint8_t glyph_id_format;
+    uint8_t advance_width_format;
+    uint8_t bits_per_pixel;
+    uint8_t xy_bits;
+    uint8_t wh_bits;
+    uint8_t advance_width_bits;
+    uint8_t compression_id;
+    uint8_t subpixels_mode;
+} font_header_t;
+
+typedef struct {
+    const uint8_t * data;   /*Start of the table, including the length and the label*/
+    uint32_t length;
+} font_table_t;
+
+/*The font and its descriptors in one allocation*/
+typedef struct {
+    lv_font_t font;         /*Must be the first to free the font with its pointer*/
+    lv_font_fmt_txt_dsc_t dsc;
+    union {
+        lv_font_fmt_txt_kern_pair_t pair;
+        lv_font_fmt_txt_kern_classes_t classes;
+    } kern;
+    /*Followed by the cmaps and the glyph descriptors*/
+} font_bin_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool get_table(const uint8_t * data, uint32_t size, uint32_t start, const char * label, font_table_t * table);
+static bool load_header(const font_table_t * head, font_header_t * header);
+static bool load_cmap(const font_table_t * cmap, uint32_t i, uint32_t glyph_cnt, lv_font_fmt_txt_cmap_t * out);
+static bool load_glyphs(const font_table_t * loca, const font_table_t * glyf, const font_header_t * header,
+                        uint32_t glyph_cnt, lv_font_fmt_txt_glyph_dsc_t * out);
+static bool load_kern(const font_table_t * kern, const font_header_t * header, uint32_t glyph_cnt, font_bin_t * bin);
+static inline uint16_t get_u16(const uint8_t * p);
+static inline uint32_t get_u32(const uint8_t * p);
+static uint32_t read_bits(const uint8_t * data, uint32_t * bit_pos, uint8_t len);
+static int32_t read_bits_signed(const uint8_t * data, uint32_t * bit_pos, uint8_t len);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+/*The lists are used in place as `uint16_t` arrays*/
+#define IS_ALIGNED_16(p) ((((lv_uintptr_t)(p)) & 0x1) == 0)
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Create a font from the binary format of lv_font_conv (`--format bin`).
+ * Only the glyph descriptors are decoded to RAM, the bitmaps, character maps and kerning tables
+ * are used from `data` so it can be a memory mapped file.
+ * The header of every glyph is read here so most of the `glyf` table is accessed once,
+ * the compressed bitmaps are checked only when they are drawn.
+ * @param data the content of a binary font file. Must be kept until `lv_font_free_bin()`.
+ * @param size size of `data` in bytes
+ * @return pointer to the new font or NULL if the data is invalid or there is no memory
+ */
+lv_font_t * lv_font_load_bin(const void * data, uint32_t size)
+{
+    /*The 16 bit lists are stored in little endian*/
+    const uint16_t endian_test = 1;
+    if(*((const uint8_t *)&endian_test) != 1) {
+        LV_LOG_WARN("lv_font_load_bin: only little endian CPUs are supported");
+        return NULL;
+    }
+
+    const uint8_t * d = data;
+    font_table_t head;
+    font_header_t header;
+    if(!get_table(d, size, 0, "head", &head) || !load_header(&head, &header)) {
+        LV_LOG_WARN("lv_font_load_bin: invalid or unsupported header");
+        return NULL;
+    }
+
+    font_table_t cmap;
+    font_table_t loca;
+    font_table_t glyf;
+    if(!get_table(d, size, head.length, "cmap", &cmap) ||
+       !get_table(d, size, head.length + cmap.length, "loca", &loca) ||
+       !get_table(d, size, head.length + cmap.length + loca.length, "glyf", &glyf)) {
+        LV_LOG_WARN("lv_font_load_bin: missing or truncated table");
+        return NULL;
+    }
+
+    uint32_t cmap_num = cmap.length >= TABLE_HEADER_SIZE + 4 ? get_u32(&cmap.data[TABLE_HEADER_SIZE]) : 0;
+    if(cmap_num >= (1 << 10) ||
+       cmap_num * CMAP_SUBTABLE_SIZE > cmap.length - TABLE_HEADER_SIZE - 4) {
+        LV_LOG_WARN("lv_font_load_bin: invalid cmap table");
+        return NULL;
+    }
+
+    uint32_t loca_entry_size = header.index_to_loc_format ? 4 : 2;
+    uint32_t glyph_cnt = loca.length >= TABLE_HEADER_SIZE + 4 ? get_u32(&loca.data[TABLE_HEADER_SIZE]) : 0;
+    if(glyph_cnt == 0 || glyph_cnt > (loca.length - TABLE_HEADER_SIZE - 4) / loca_entry_size) {
+        LV_LOG_WARN("lv_font_load_bin: invalid loca table");
+        return NULL;
+    }
+
+    uint32_t alloc_size = sizeof(font_bin_t) + cmap_num * sizeof(lv_font_fmt_txt_cmap_t) +
+                          glyph_cnt * sizeof(lv_font_fmt_txt_glyph_dsc_t);
+    font_bin_t * bin = lv_mem_alloc(alloc_size);
+    LV_ASSERT_MEM(bin);
+    if(bin == NULL) return NULL;
+    _lv_memset_00(bin, alloc_size);
+
+    lv_font_fmt_txt_cmap_t * cmaps = (lv_font_fmt_txt_cmap_t *)(bin + 1);
+    lv_font_fmt_txt_glyph_dsc_t * glyph_dsc = (lv_font_fmt_txt_glyph_dsc_t *)(cmaps + cmap_num);
+
+    uint32_t i;
+    for(i = 0; i < cmap_num; i++) {
+        /*lv_font_conv writes the ranges in increasing order, overlapping ones would hide letters*/
+        if(!load_cmap(&cmap, i, glyph_cnt, &cmaps[i]) ||
+           (i > 0 && cmaps[i].range_start < cmaps[i - 1].range_start + cmaps[i - 1].range_length)) {
+            LV_LOG_WARN("lv_font_load_bin: invalid character map");
+            lv_mem_free(bin);
+            return NULL;
+        }
+    }
+
+    if(!load_glyphs(&loca, &glyf, &header, glyph_cnt, glyph_dsc)) {
+        LV_LOG_WARN("lv_font_load_bin: invalid glyph or too large for the glyph descriptors (see LV_FONT_FMT_TXT_LARGE)");
+        lv_mem_free(bin);
+        return NULL;
+    }
+
+    /*The font is still usable without kerning*/
+    font_table_t kern;
+    uint32_t kern_start = head.length + cmap.length + loca.length + glyf.length;
+    if(get_table(d, size, kern_start, "kern", &kern)) {
+        if(!load_kern(&kern, &header, glyph_cnt, bin)) {
+            LV_LOG_WARN("lv_font_load_bin: invalid or unsupported kerning, ignored");
+        }
+    }
+
+    uint8_t glyph_header_bits = header.advance_width_bits + 2 * header.xy_bits + 2 * header.wh_bits;
+    bin->dsc.glyph_bitmap = glyf.data;
+    bin->dsc.glyph_dsc = glyph_dsc;
+    bin->dsc.cmaps = cmaps;
+    bin->dsc.cmap_num = cmap_num;
+    bin->dsc.bpp = header.bits_per_pixel;
+    bin->dsc.bitmap_format = header.compression_id ? LV_FONT_FMT_TXT_COMPRESSED : LV_FONT_FMT_TXT_PLAIN;
+    bin->dsc.bitmap_bit_ofs = glyph_header_bits & 0x7;
+    bin->dsc.bitmap_size = glyf.length;
+    bin->dsc.glyph_cnt = glyph_cnt;
+
+    bin->font.get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt;
+    bin->font.get_glyph_bitmap = lv_font_get_bitmap_fmt_txt;
+    bin->font.line_height = header.ascent - header.descent;
+    bin->font.base_line = -header.descent;
+    bin->font.subpx = header.subpixels_mode;
+    bin->font.dsc = &bin->dsc;
+
+    return &bin->font;
+}
+
+/**
+ * Free a font created by `lv_font_load_bin()`. The font must not be used by any object anymore.
+ * @param font pointer to a font
+ */
+void lv_font_free_bin(lv_font_t * font)
+{
+    if(font == NULL) return;
+
+    _lv_font_fmt_txt_release(font);
+    lv_mem_free(font);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Find a table of a binary font
+ * @param data the content of a binary font file
+ * @param size size of `data`
+ * @param start offset of the table in `data`
+ * @param label the expected 4 character label of the table
+ * @param table store the table here
+ * @return true: the table is found and fits in `data`
+ */
+static bool get_table(const uint8_t * data, uint32_t size, uint32_t start, const char * label, font_table_t * table)
+{
+    if(start > size || size - start < TABLE_HEADER_SIZE) return false;
+
+    uint32_t length = get_u32(&data[start]);
+    if(length < TABLE_HEADER_SIZE || length > size - start) return false;
+
+    uint32_t i;
+    for(i = 0; i < 4; i++) {
+        if(data[start + 4 + i] != (uint8_t)label[i]) return false;
+    }
+
+    table->data = &data[start];
+    table->length = length;
+    return true;
+}
+
+static bool load_header(const font_table_t * head, font_header_t * header)
+{
+    if(head->length < TABLE_HEADER_SIZE + HEAD_SIZE) return false;
+
+    const uint8_t * p = &head->data[TABLE_HEADER_SIZE];
+    header->ascent = (int16_t)get_u16(&p[8]);
+    header->descent = (int16_t)get_u16(&p[10]);
+    header->default_advance_width = get_u16(&p[22]);
+    header->kerning_scale = get_u16(&p[24]);
+    header->index_to_loc_format = p[26];
+    header->glyph_id_format = p[27];
+    header->advance_width_format = p[28];
+    header->bits_per_pixel = p[29];
+    header->xy_bits = p[30];
+    header->wh_bits = p[31];
+    header->advance_width_bits = p[32];
+    header->compression_id = p[33];
+    header->subpixels_mode = p[34];
+
+    if(header->bits_per_pixel == 0 || (header->bits_per_pixel > 4 && header->bits_per_pixel != 8)) return false;
+    if(header->xy_bits > 16 || header->wh_bits > 16 || header->advance_width_bits > 16) return false;
+    if(header->index_to_loc_format > 1 || header->glyph_id_format > 1) return false;
+    if(header->subpixels_mode > LV_FONT_SUBPX_BOTH) return false;
+
+    /*Compression without the XOR prefilter (id 2) is not supported by the decompression*/
+    if(header->compression_id > 1) return false;
+
+    return true;
+}
+
+/**
+ * Load a character map. The lists are used from the table.
+ * @param cmap the `cmap` table
+ * @param i index of the character map in the table
+ * @param glyph_cnt number of glyphs in the font
+ * @param out store the character map here
+ * @return true: the character map is valid
+ */
+static bool load_cmap(const font_table_t * cmap, uint32_t i, uint32_t glyph_cnt, lv_font_fmt_txt_cmap_t * out)
+{
+    const uint8_t * sub = &cmap->data[TABLE_HEADER_SIZE + 4 + i * CMAP_SUBTABLE_SIZE];
+    uint32_t data_ofs = get_u32(&sub[0]);
+    out->range_start = get_u32(&sub[4]);
+    out->range_length = get_u16(&sub[8]);
+    out->glyph_id_start = get_u16(&sub[10]);
+    out->list_length = get_u16(&sub[12]);
+    out->type = sub[14];
+    if(out->range_start + out->range_length < out->range_start) return false;
+
+    uint32_t list_size;
+    switch(out->type) {
+        case LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY:
+            return (uint32_t)out->glyph_id_start + out->range_length <= glyph_cnt;
+        case LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL:
+            list_size = out->list_length;
+            if(out->list_length < out->range_length) return false;
+            break;
+        case LV_FONT_FMT_TXT_CMAP_SPARSE_TINY:
+            list_size = out->list_length * 2;
+            if((uint32_t)out->glyph_id_start + out->list_length > glyph_cnt) return false;
+            break;
+        case LV_FONT_FMT_TXT_CMAP_SPARSE_FULL:
+            list_size = out->list_length * 4;
+            break;
+        default:
+            return false;
+    }
+
+    if(data_ofs > cmap->length || list_size > cmap->length - data_ofs) return false;
+
+    const uint8_t * list = &cmap->data[data_ofs];
+    uint32_t k;
+    if(out->type == LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL) {
+        for(k = 0; k < out->list_length; k++) {
+            if((uint32_t)out->glyph_id_start + list[k] >= glyph_cnt) return false;
+        }
+        out->glyph_id_ofs_list = list;
+        return true;
+    }
+
+    if(!IS_ALIGNED_16(list)) {
+        LV_LOG_WARN("lv_font_load_bin: the font data should be 4 byte aligned");
+        return false;
+    }
+
+    /*The letters are binary searched*/
+    out->unicode_list = (const uint16_t *)list;
+    for(k = 0; k < out->list_length; k++) {
+        if(out->unicode_list[k] >= out->range_length) return false;
+        if(k > 0 && out->unicode_list[k] <= out->unicode_list[k - 1]) return false;
+    }
+
+    if(out->type == LV_FONT_FMT_TXT_CMAP_SPARSE_FULL) {
+        const uint16_t * ofs_list = out->unicode_list + out->list_length;
+        for(k = 0; k < out->list_length; k++) {
+            if((uint32_t)out->glyph_id_start + ofs_list[k] >= glyph_cnt) return false;
+        }
+        out->glyph_id_ofs_list = ofs_list;
+    }
+
+    return true;
+}
+
+/**
+ * Decode the bit packed glyph headers. The bitmaps are used from the `glyf` table.
+ * @param loca the `loca` table with the offsets of the glyphs
+ * @param glyf the `glyf` table
+ * @param header the font header
+ * @param glyph_cnt number of glyphs
+ * @param out store the `glyph_cnt` descriptors here
+ * @return true: all glyphs are valid and fit in the descriptors
+ */
+static bool load_glyphs(const font_table_t * loca, const font_table_t * glyf, const font_header_t * header,
+                        uint32_t glyph_cnt, lv_font_fmt_txt_glyph_dsc_t * out)
+{
+    const uint8_t * offsets = &loca->data[TABLE_HEADER_SIZE + 4];
+    uint32_t header_bits = header->advance_width_bits + 2 * header->xy_bits + 2 * header->wh_bits;
+
+    /*Glyph 0 is reserved and left empty*/
+    uint32_t i;
+    for(i = 1; i < glyph_cnt; i++) {
+        uint32_t ofs;
+        uint32_t next;
+        if(header->index_to_loc_format) {
+            ofs = get_u32(&offsets[i * 4]);
+            next = i + 1 < glyph_cnt ? get_u32(&offsets[(i + 1) * 4]) : glyf->length;
+        }
+        else {
+            ofs = get_u16(&offsets[i * 2]);
+            next = i + 1 < glyph_cnt ? get_u16(&offsets[(i + 1) * 2]) : glyf->length;
+        }
+        if(ofs < TABLE_HEADER_SIZE || next < ofs || next > glyf->length) return false;
+        if((next - ofs) * 8 < header_bits) return false;
+
+        const uint8_t * g = &glyf->data[ofs];
+        uint32_t bit_pos = 0;
+        uint32_t adv_w = header->advance_width_bits ? read_bits(g, &bit_pos, header->advance_width_bits) :
+                         header->default_advance_width;
+        if(header->advance_width_format == 0) adv_w *= 16;  /*Integer pixels, no fractional part*/
+        int32_t ofs_x = read_bits_signed(g, &bit_pos, header->xy_bits);
+        int32_t ofs_y = read_bits_signed(g, &bit_pos, header->xy_bits);
+        uint32_t box_w = read_bits(g, &bit_pos, header->wh_bits);
+        uint32_t box_h = read_bits(g, &bit_pos, header->wh_bits);
+
+        /*The bitmap has to end before the next glyph.
+         *The compressed bitmaps are bounded while they are decompressed for drawing
+         *so they are not read here, only when the letter is drawn.*/
+        uint32_t bitmap_index = ofs + header_bits / 8;
+        if(header->compression_id == 0) {
+            uint64_t bitmap_bits = (uint64_t)box_w * box_h * header->bits_per_pixel;
+            if(bitmap_bits > (uint64_t)(next - ofs) * 8 - header_bits) return false;
+        }
+
+        lv_font_fmt_txt_glyph_dsc_t * gdsc = &out[i];
+        gdsc->bitmap_index = bitmap_index;
+        gdsc->adv_w = adv_w;
+        gdsc->box_w = box_w;
+        gdsc->box_h = box_h;
+        gdsc->ofs_x = ofs_x;
+        gdsc->ofs_y = ofs_y;
+
+        /*Check that the values fit in the (bit) fields*/
+        if(gdsc->bitmap_index != bitmap_index || gdsc->adv_w != adv_w || gdsc->box_w != box_w ||
+           gdsc->box_h != box_h || gdsc->ofs_x != ofs_x || gdsc->ofs_y != ofs_y) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Load the kerning of the font. The values are used from the `kern` table.
+ * @param kern the `kern` table
+ * @param header the font header
+ * @param glyph_cnt number of glyphs
+ * @param bin set the kerning of this font
+ * @return true: the kerning is loaded; false: the font has no kerning
+ */
+static bool load_kern(const font_table_t * kern, const font_header_t * header, uint32_t glyph_cnt, font_bin_t * bin)
+{
+    const uint8_t * p = &kern->data[TABLE_HEADER_SIZE];
+    uint32_t data_size = kern->length - TABLE_HEADER_SIZE;
+    if(data_size < 8) return false;
+
+    uint8_t format = p[0];
+    if(format == KERN_FORMAT_PAIRS) {
+        uint32_t pair_cnt = get_u32(&p[4]);
+        uint32_t ids_size = header->glyph_id_format ? 4 : 2;
+        if(pair_cnt >= (1 << 24) || pair_cnt > (data_size - 8) / (ids_size + 1)) return false;
+
+        const uint8_t * ids = &p[8];
+        if(header->glyph_id_format && !IS_ALIGNED_16(ids)) return false;
+
+        lv_font_fmt_txt_kern_pair_t * kdsc = &bin->kern.pair;
+        kdsc->glyph_ids = ids;
+        kdsc->values = (const int8_t *)&ids[pair_cnt * ids_size];
+        kdsc->pair_cnt = pair_cnt;
+        kdsc->glyph_ids_size = header->glyph_id_format;
+        bin->dsc.kern_classes = 0;
+    }
+    else if(format == KERN_FORMAT_CLASSES) {
+        uint32_t mapping_length = get_u16(&p[4]);
+        uint8_t rows = p[6];
+        uint8_t cols = p[7];
+        if(mapping_length < glyph_cnt) return false;
+        if(2 * mapping_length + (uint32_t)rows * cols > data_size - 8) return false;
+
+        const uint8_t * left = &p[8];
+        const uint8_t * right = &left[mapping_length];
+        uint32_t i;
+        for(i = 0; i < mapping_length; i++) {
+            if(left[i] > rows || right[i] > cols) return false;
+        }
+
+        lv_font_fmt_txt_kern_classes_t * kdsc = &bin->kern.classes;
+        kdsc->left_class_mapping = left;
+        kdsc->right_class_mapping = right;
+        kdsc->class_pair_values = (const int8_t *)&right[mapping_length];
+        kdsc->left_class_cnt = rows;
+        kdsc->right_class_cnt = cols;
+        bin->dsc.kern_classes = 1;
+    }
+    else {
+        return false;
+    }
+
+    bin->dsc.kern_dsc = &bin->kern;
+    bin->dsc.kern_scale = header->kerning_scale;
+    return true;
+}
+
+static inline uint16_t get_u16(const uint8_t * p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t get_u32(const uint8_t * p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * Read an unsigned value from a bit stream, MSB first
+ * @param data the bit stream
+ * @param bit_pos index of the first bit, incremented by `len`
+ * @param len number of bits (<= 32)
+ * @return the value
+ */
+static uint32_t read_bits(const uint8_t * data, uint32_t * bit_pos, uint8_t len)
+{
+    uint32_t v = 0;
+    uint8_t i;
+    for(i = 0; i < len; i++) {
+        v = (v << 1) | ((data[*bit_pos >> 3] >> (7 - (*bit_pos & 0x7))) & 0x1);
+        (*bit_pos)++;
+    }
+    return v;
+}
+
+/**
+ * Read a two's complement value from a bit stream, MSB first
+ * @param data the bit stream
+ * @param bit_pos index of the first bit, incremented by `len`
+ * @param len number of bits (<= 32)
+ * @return the value
+ */
+static int32_t read_bits_signed(const uint8_t * data, uint32_t * bit_pos, uint8_t len)
+{
+    uint32_t v = read_bits(data, bit_pos, len);
+    if(len > 0 && len < 32 && (v & ((uint32_t)1 << (len - 1)))) v |= ~(((uint32_t)1 << len) - 1);
+    return (int32_t)v;
+}
+
+#endif /*LV_USE_FONT_LOADER*/
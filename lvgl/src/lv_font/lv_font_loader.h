@@ -0,0 +1,60 @@
+/**
+ * @file lv_font_loader.h
+ *
+ */
+
+#ifndef LV_FONT_LOADER_H
+#define LV_FONT_LOADER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_font.h"
+
+#if LV_USE_FONT_LOADER
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Create a font from the binary format of lv_font_conv (`--format bin`).
+ * Only the glyph descriptors are decoded to RAM, the bitmaps, character maps and kerning tables
+ * are used from `data` so it can be a memory mapped file.
+ * The header of every glyph is read here so most of the `glyf` table is accessed once,
+ * the compressed bitmaps are checked only when they are drawn.
+ * @param data the content of a binary font file. Must be kept until `lv_font_free_bin()`.
+ * @param size size of `data` in bytes
+ * @return pointer to the new font or NULL if the data is invalid or there is no memory
+ */
+lv_font_t * lv_font_load_bin(const void * data, uint32_t size);
+
+/**
+ * Free a font created by `lv_font_load_bin()`. The font must not be used by any object anymore.
+ * @param font pointer to a font
+ */
+void lv_font_free_bin(lv_font_t * font);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_FONT_LOADER*/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_FONT_LOADER_H*/
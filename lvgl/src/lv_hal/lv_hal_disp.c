@@ -34,6 +34,9 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+#if LV_INV_TILES
+static void disp_tiles_alloc(lv_disp_t * disp);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -144,6 +147,10 @@ lv_disp_t * lv_disp_drv_register(lv_disp_drv_t * driver)
     disp->inv_p = 0;
     disp->last_activity_time = 0;
 
+#if LV_INV_TILES
+    disp_tiles_alloc(disp);
+#endif
+
     disp->act_scr   = lv_obj_create(NULL, NULL); /*Create a default screen on the display*/
     disp->top_layer = lv_obj_create(NULL, NULL); /*Create top layer on the display*/
     disp->sys_layer = lv_obj_create(NULL, NULL); /*Create sys layer on the display*/
@@ -170,6 +177,11 @@ void lv_disp_drv_update(lv_disp_t * disp, lv_disp_drv_t * new_drv)
 {
     memcpy(&disp->driver, new_drv, sizeof(lv_disp_drv_t));
 
+#if LV_INV_TILES
+    _lv_inv_area(disp, NULL);
+    disp_tiles_alloc(disp);
+#endif
+
     lv_obj_t * scr;
     _LV_LL_READ(disp->scr_ll, scr) {
         lv_obj_set_size(scr, lv_disp_get_hor_res(disp), lv_disp_get_ver_res(disp));
@@ -196,6 +208,9 @@ void lv_disp_remove(lv_disp_t * disp)
     }
 
     _lv_ll_remove(&LV_GC_ROOT(_lv_disp_ll), disp);
+#if LV_INV_TILES
+    if(disp->inv_tiles) lv_mem_free(disp->inv_tiles);
+#endif
     lv_mem_free(disp);
 
     if(was_default) lv_disp_set_default(_lv_ll_get_head(&LV_GC_ROOT(_lv_disp_ll)));
@@ -409,3 +424,42 @@ bool lv_disp_is_true_double_buf(lv_disp_t * disp)
 /**********************
  *   STATIC FUNCTIONS
  **********************/
+
+#if LV_INV_TILES
+/**
+ * Allocate the invalidation tile grid for the current resolution of the display.
+ * The tile bits and the extent of the tiles are one memory block.
+ * If the allocation fails the display falls back to saving the invalidated areas.
+ * @param disp pointer to a display
+ */
+static void disp_tiles_alloc(lv_disp_t * disp)
+{
+    uint16_t cols = (lv_disp_get_hor_res(disp) + LV_INV_TILE_SIZE - 1) / LV_INV_TILE_SIZE;
+    uint16_t rows = (lv_disp_get_ver_res(disp) + LV_INV_TILE_SIZE - 1) / LV_INV_TILE_SIZE;
+    if(disp->inv_tiles && cols == disp->inv_tile_cols && rows == disp->inv_tile_rows) return;
+
+    if(disp->inv_tiles) lv_mem_free(disp->inv_tiles);
+
+    uint16_t words = (cols + 31) / 32;
+    uint32_t bits_size = (uint32_t)rows * words * sizeof(uint32_t);
+    uint8_t * buf = lv_mem_alloc(bits_size + (uint32_t)rows * cols * sizeof(lv_area_t));
+    LV_ASSERT_MEM(buf);
+    if(buf == NULL) {
+        disp->inv_tiles = NULL;
+        disp->inv_tile_areas = NULL;
+        disp->inv_tile_cols = 0;
+        disp->inv_tile_rows = 0;
+        disp->inv_tile_words = 0;
+        disp->inv_tiles_marked = 0;
+        return;
+    }
+
+    _lv_memset_00(buf, bits_size);
+    disp->inv_tiles = (uint32_t *)buf;
+    disp->inv_tile_areas = (lv_area_t *)(buf + bits_size);
+    disp->inv_tile_cols = cols;
+    disp->inv_tile_rows = rows;
+    disp->inv_tile_words = words;
+    disp->inv_tiles_marked = 0;
+}
+#endif
@@ -155,6 +155,18 @@ typedef struct _disp_t {
     uint8_t inv_area_joined[LV_INV_BUF_SIZE];
     uint32_t inv_p : 10;
 
+#if LV_INV_TILES
+    /** Invalidated tiles, one bit per tile, `inv_tile_words` words per tile row. The extent of the
+     * invalidated areas is kept per tile to avoid refreshing whole tiles. The grid is sized from the
+     * resolution of the driver. If it couldn't be allocated the areas are saved in `inv_areas`.*/
+    uint32_t * inv_tiles;
+    lv_area_t * inv_tile_areas;
+    uint16_t inv_tile_cols;
+    uint16_t inv_tile_rows;
+    uint16_t inv_tile_words;
+    uint8_t inv_tiles_marked;
+#endif
+
     /*Miscellaneous data*/
     uint32_t last_activity_time; /**< Last time there was activity on this display */
 } lv_disp_t;
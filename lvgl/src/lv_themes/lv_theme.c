@@ -42,6 +42,11 @@ static lv_theme_t * act_theme;
 void lv_theme_set_act(lv_theme_t * th)
 {
     act_theme = th;
+
+#if LV_STYLE_CACHE_CNT
+    /*The default font of the texts comes from the theme*/
+    lv_obj_style_cache_invalidate(NULL);
+#endif
 }
 
 /**
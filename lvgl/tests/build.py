@@ -249,6 +249,7 @@ all_obj_all_features = {
   "LV_FONT_MONTSERRAT_12_SUBPX":1,
   "LV_FONT_MONTSERRAT_28_COMPRESSED":1,
   "LV_FONT_UNSCII_8":1,
+  "LV_USE_FONT_LOADER":1,
   "LV_USE_ARC":1,
   "LV_USE_BAR":1,
   "LV_USE_BTN":1,
@@ -284,6 +285,27 @@ all_obj_all_features = {
   "LV_USE_WIN":1 
 }
 
+blend_simd = dict(all_obj_all_features)
+blend_simd["LV_COLOR_SCREEN_TRANSP"] = 0
+blend_simd["LV_USE_BLEND_SIMD"] = 1
+
+style_cache = dict(all_obj_all_features)
+style_cache["LV_STYLE_CACHE_CNT"] = 256
+style_cache["LV_SHADOW_CACHE_SIZE"] = 64
+style_cache["LV_SHADOW_CACHE_CNT"] = 4
+style_cache["LV_RADIUS_MASK_CACHE_CNT"] = 64
+style_cache["LV_RADIUS_MASK_CACHE_SIZE"] = 8192
+
+inv_tiles = dict(all_obj_all_features)
+inv_tiles["LV_INV_TILES"] = 1
+
+glyph_cache = dict(all_obj_all_features)
+glyph_cache["LV_FONT_FMT_TXT_CACHE_CNT"] = 64
+glyph_cache["LV_FONT_FMT_TXT_CACHE_SIZE"] = 8 * 1024
+
+fast_index = dict(all_obj_all_features)
+fast_index["LV_FONT_FMT_TXT_FAST_INDEX"] = 1
+
 
 advanced_features = {
   "LV_DPI":100,
@@ -306,6 +328,7 @@ advanced_features = {
   "LV_USER_DATA_FREE_INCLUDE":"\\\"<stdio.h>\\\"",
   "LV_USER_DATA_FREE": "\\\"free\\\"",
   "LV_IMG_CACHE_DEF_SIZE":32,
+  "LV_IMG_CACHE_DEF_MEM_SIZE":32*1024,
   "LV_USE_LOG":1,
   "LV_USE_THEME_MATERIAL":1,  
   "LV_USE_THEME_EMPTY":1,  
@@ -332,6 +355,7 @@ advanced_features = {
   "LV_FONT_MONTSERRAT_12_SUBPX":1,
   "LV_FONT_MONTSERRAT_28_COMPRESSED":1,
   "LV_FONT_UNSCII_8":1,
+  "LV_USE_FONT_LOADER":1,
   "LV_USE_BIDI": 1,
   "LV_USE_REVERSE_ARABIC_PERSIAN_CHARS":1,
   "LV_USE_OBJ_REALIGN": 1,
@@ -379,6 +403,11 @@ advanced_features = {
 build("Minimal monochrome", minimal_monochrome)
 build("All objects, minimal features", all_obj_minimal_features)
 build("All objects, all features", all_obj_all_features)
+build("All objects, all features, SIMD blending", blend_simd)
+build("All objects, all features, style, shadow and radius mask cache", style_cache)
+build("All objects, all features, tiled invalidation", inv_tiles)
+build("All objects, all features, glyph cache", glyph_cache)
+build("All objects, all features, fast glyph index", fast_index)
   
 
 
@@ -24,6 +24,7 @@
  *  STATIC PROTOTYPES
  **********************/
 static void create_delete_change_parent(void);
+static void style_change(void);
 
 /**********************
  *  STATIC VARIABLES
@@ -45,6 +46,7 @@ void lv_test_obj(void)
     lv_test_print("==================");
 
     create_delete_change_parent();
+    style_change();
 }
 
 
@@ -87,4 +89,82 @@ static void create_delete_change_parent(void)
     lv_obj_del(obj_parent);
     lv_test_assert_int_eq(0, lv_obj_count_children(lv_scr_act()), "Screen's children count after delete");
 }
+
+static void style_change(void)
+{
+    lv_test_print("");
+    lv_test_print("Read the style properties of objects after changes:");
+    lv_test_print("---------------------------------------------------");
+
+    lv_style_t style;
+    lv_style_init(&style);
+    lv_style_set_bg_opa(&style, LV_STATE_DEFAULT, LV_OPA_50);
+    lv_style_set_bg_opa(&style, LV_STATE_PRESSED, LV_OPA_70);
+    lv_style_set_text_color(&style, LV_STATE_PRESSED, LV_COLOR_RED);
+    lv_style_set_transition_time(&style, LV_STATE_DEFAULT, 0);
+
+    lv_obj_t * parent = lv_obj_create(lv_scr_act(), NULL);
+    lv_obj_t * child = lv_obj_create(parent, NULL);
+    lv_obj_t * other = lv_obj_create(lv_scr_act(), NULL);
+    lv_obj_reset_style_list(child, LV_OBJ_PART_MAIN);     /*Inherit everything*/
+    lv_obj_add_style(parent, LV_OBJ_PART_MAIN, &style);
+    lv_obj_set_style_local_text_color(parent, LV_OBJ_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_BLUE);
+    lv_obj_set_style_local_text_color(other, LV_OBJ_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_GREEN);
+
+    lv_test_print("Read the same properties twice");
+    lv_test_assert_int_eq(LV_OPA_50, lv_obj_get_style_bg_opa(parent, LV_OBJ_PART_MAIN), "Property of a style");
+    lv_test_assert_int_eq(LV_OPA_50, lv_obj_get_style_bg_opa(parent, LV_OBJ_PART_MAIN), "Property of a style again");
+    lv_test_assert_color_eq(LV_COLOR_BLUE, lv_obj_get_style_text_color(child, LV_OBJ_PART_MAIN), "Inherited property");
+    lv_test_assert_color_eq(LV_COLOR_BLUE, lv_obj_get_style_text_color(child, LV_OBJ_PART_MAIN),
+                            "Inherited property again");
+
+    lv_test_print("Modify the style");
+    lv_style_set_bg_opa(&style, LV_STATE_DEFAULT, LV_OPA_60);
+    lv_obj_report_style_mod(&style);
+    lv_test_assert_int_eq(LV_OPA_60, lv_obj_get_style_bg_opa(parent, LV_OBJ_PART_MAIN), "Property of a modified style");
+
+    lv_test_print("Change the state");
+    lv_obj_add_state(parent, LV_STATE_PRESSED);
+    lv_test_assert_int_eq(LV_OPA_70, lv_obj_get_style_bg_opa(parent, LV_OBJ_PART_MAIN), "Property in the new state");
+    lv_test_assert_color_eq(LV_COLOR_RED, lv_obj_get_style_text_color(child, LV_OBJ_PART_MAIN),
+                            "Inherited property in the new state of the parent");
+    lv_obj_clear_state(parent, LV_STATE_PRESSED);
+    lv_test_assert_int_eq(LV_OPA_60, lv_obj_get_style_bg_opa(parent, LV_OBJ_PART_MAIN), "Property in the old state");
+    lv_test_assert_color_eq(LV_COLOR_BLUE, lv_obj_get_style_text_color(child, LV_OBJ_PART_MAIN),
+                            "Inherited property in the old state of the parent");
+
+    lv_test_print("Change the local style of the parent");
+    lv_obj_set_style_local_text_color(parent, LV_OBJ_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_YELLOW);
+    lv_test_assert_color_eq(LV_COLOR_YELLOW, lv_obj_get_style_text_color(child, LV_OBJ_PART_MAIN),
+                            "Inherited property of a modified local style");
+
+    lv_test_print("Change the parent");
+    lv_obj_set_parent(child, other);
+    lv_test_assert_color_eq(LV_COLOR_GREEN, lv_obj_get_style_text_color(child, LV_OBJ_PART_MAIN),
+                            "Inherited property of the new parent");
+
+    lv_test_print("Remove a local property of the parent");
+    lv_obj_remove_style_local_prop(other, LV_OBJ_PART_MAIN, LV_STYLE_TEXT_COLOR);
+    lv_test_assert_color_eq(lv_obj_get_style_text_color(lv_scr_act(), LV_OBJ_PART_MAIN),
+                            lv_obj_get_style_text_color(child, LV_OBJ_PART_MAIN), "Inherited property of the screen");
+
+    lv_test_print("Reset the style list");
+    lv_obj_reset_style_list(parent, LV_OBJ_PART_MAIN);
+    lv_test_assert_int_eq(LV_OPA_TRANSP, lv_obj_get_style_bg_opa(parent, LV_OBJ_PART_MAIN), "Default value without styles");
+
+#if LV_STYLE_CACHE_CNT
+    lv_test_print("Read from the style cache");
+    lv_obj_style_cache_info_t info_start;
+    lv_obj_style_cache_info_t info_end;
+    lv_obj_get_style_bg_opa(other, LV_OBJ_PART_MAIN);
+    lv_obj_style_cache_get_info(&info_start);
+    lv_obj_get_style_bg_opa(other, LV_OBJ_PART_MAIN);
+    lv_obj_style_cache_get_info(&info_end);
+    lv_test_assert_int_eq(info_start.hit_cnt + 1, info_end.hit_cnt, "Repeated read is found in the cache");
+#endif
+
+    lv_obj_del(parent);
+    lv_obj_del(other);
+    lv_style_reset(&style);
+}
 #endif
@@ -0,0 +1,245 @@
+/**
+ * @file lv_test_blend.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../../lvgl.h"
+#include "../lv_test_assert.h"
+#include "lv_test_blend.h"
+
+#if LV_BUILD_TEST
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../../src/lv_draw/lv_draw_blend_simd.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define BENCH_ROUNDS    20
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    const char * name;
+    bool map;
+    bool masked;
+    lv_opa_t opa;
+} blend_case_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+#if LV_USE_BLEND_SIMD && LV_COLOR_DEPTH == 32 && LV_COLOR_SCREEN_TRANSP == 0
+static void simd_bit_exact(void);
+static void simd_level_bit_exact(lv_blend_simd_level_t level, const char * name);
+static void fill_random(lv_color_t * bg, lv_color_t * map, lv_opa_t * mask, uint32_t px_num);
+static void blend(const blend_case_t * c, const lv_area_t * area, const lv_color_t * map, const lv_opa_t * mask);
+static uint32_t bench(const blend_case_t * c, const lv_area_t * area, const lv_color_t * map, const lv_opa_t * mask);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_blend(void)
+{
+    lv_test_print("");
+    lv_test_print("====================");
+    lv_test_print("Start lv_blend tests");
+    lv_test_print("====================");
+
+#if LV_USE_BLEND_SIMD && LV_COLOR_DEPTH == 32 && LV_COLOR_SCREEN_TRANSP == 0
+    simd_bit_exact();
+#else
+    lv_test_print("Skip the SIMD blending tests: requires LV_USE_BLEND_SIMD and 32 bit colors");
+#endif
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+#if LV_USE_BLEND_SIMD && LV_COLOR_DEPTH == 32 && LV_COLOR_SCREEN_TRANSP == 0
+
+static void simd_bit_exact(void)
+{
+    lv_test_print("");
+    lv_test_print("Compare the SIMD blending with the software rendering:");
+    lv_test_print("------------------------------------------------------");
+
+    const lv_blend_simd_t * simd = _lv_blend_simd_get();
+    lv_test_print("Selected kernels: %s", simd ? simd->name : "none");
+
+    /*Every instruction set the build and the CPU support, not only the selected one*/
+    simd_level_bit_exact(LV_BLEND_SIMD_SSE2, "SSE2");
+    simd_level_bit_exact(LV_BLEND_SIMD_AVX2, "AVX2");
+    simd_level_bit_exact(LV_BLEND_SIMD_NEON, "NEON");
+
+    _lv_blend_simd_force(LV_BLEND_SIMD_AUTO);
+    lv_test_assert_ptr_eq(simd, _lv_blend_simd_get(), "Restore the selected kernels");
+}
+
+static void simd_level_bit_exact(lv_blend_simd_level_t level, const char * name)
+{
+    if(!_lv_blend_simd_force(level)) {
+        lv_test_print("%s: not supported, skip", name);
+        return;
+    }
+    const lv_blend_simd_t * simd = _lv_blend_simd_get();
+    lv_test_assert_int_eq(level, simd->level, "Force the kernels");
+    lv_test_print("%s:", simd->name);
+
+    static const blend_case_t cases[] = {
+        {"Fill with opacity", false, false, LV_OPA_70},
+        {"Fill with mask", false, true, LV_OPA_COVER},
+        {"Fill with mask and opacity", false, true, LV_OPA_60},
+        {"Map with opacity", true, false, LV_OPA_40},
+        {"Map with mask", true, true, LV_OPA_COVER},
+        {"Map with mask and opacity", true, true, LV_OPA_80},
+    };
+
+    lv_disp_t * disp = lv_disp_get_default();
+    lv_disp_buf_t * vdb = lv_disp_get_buf(disp);
+    lv_coord_t hor_res = lv_disp_get_hor_res(disp);
+    lv_coord_t ver_res = lv_disp_get_ver_res(disp);
+    uint32_t px_num = (uint32_t)hor_res * ver_res;
+
+    _lv_refr_set_disp_refreshing(disp);
+    lv_area_set(&vdb->area, 0, 0, hor_res - 1, ver_res - 1);
+
+    lv_color_t * bg = malloc(px_num * sizeof(lv_color_t));
+    lv_color_t * ref = malloc(px_num * sizeof(lv_color_t));
+    lv_color_t * map = malloc(px_num * sizeof(lv_color_t));
+    lv_opa_t * mask = malloc(px_num);
+    fill_random(bg, map, mask, px_num);
+
+    /*Odd coordinates and width to have unaligned starts and scalar tails*/
+    lv_area_t area;
+    lv_area_set(&area, 3, 1, hor_res - 6, ver_res - 2);
+
+    uint32_t i;
+    for(i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        const blend_case_t * c = &cases[i];
+
+        _lv_blend_simd_force(LV_BLEND_SIMD_NONE);
+        _lv_memcpy(vdb->buf_act, bg, px_num * sizeof(lv_color_t));
+        blend(c, &area, map, mask);
+        _lv_memcpy(ref, vdb->buf_act, px_num * sizeof(lv_color_t));
+        lv_test_assert_int_eq(1, memcmp(ref, bg, px_num * sizeof(lv_color_t)) != 0, "Software rendering changed the buffer");
+
+        _lv_blend_simd_force(level);
+        _lv_memcpy(vdb->buf_act, bg, px_num * sizeof(lv_color_t));
+        blend(c, &area, map, mask);
+
+        int32_t diff = -1;
+        uint32_t p;
+        for(p = 0; p < px_num; p++) {
+            if(ref[p].full != ((lv_color_t *)vdb->buf_act)[p].full) {
+                diff = p;
+                break;
+            }
+        }
+        lv_test_assert_int_eq(-1, diff, c->name);
+
+        _lv_blend_simd_force(LV_BLEND_SIMD_NONE);
+        uint32_t sw_us = bench(c, &area, map, mask);
+        _lv_blend_simd_force(level);
+        uint32_t simd_us = bench(c, &area, map, mask);
+        lv_test_print("   %d rounds: %d us software, %d us %s", BENCH_ROUNDS, sw_us, simd_us, simd->name);
+    }
+
+    _lv_refr_set_disp_refreshing(NULL);
+    free(bg);
+    free(ref);
+    free(map);
+    free(mask);
+}
+
+/**
+ * Random pixels with the patterns the blending has fast paths for:
+ * a black start, runs of the same color, transparent and opaque mask runs.
+ */
+static void fill_random(lv_color_t * bg, lv_color_t * map, lv_opa_t * mask, uint32_t px_num)
+{
+    srand(1);
+    uint32_t i;
+    for(i = 0; i < px_num; i++) {
+        if(i < 1000) bg[i] = LV_COLOR_BLACK;
+        else if(rand() % 4 == 0) bg[i] = bg[i - 1];
+        else bg[i].full = ((uint32_t)rand() << 8) ^ (uint32_t)rand();
+
+        map[i].full = ((uint32_t)rand() << 8) ^ (uint32_t)rand();
+    }
+
+    i = 0;
+    while(i < px_num) {
+        uint32_t run = 1 + rand() % 16;
+        int type = rand() % 4;
+        for(; run > 0 && i < px_num; run--, i++) {
+            if(type == 0) mask[i] = LV_OPA_TRANSP;
+            else if(type == 1) mask[i] = LV_OPA_COVER;
+            else mask[i] = rand() & 0xFF;
+        }
+    }
+}
+
+static void blend(const blend_case_t * c, const lv_area_t * area, const lv_color_t * map, const lv_opa_t * mask)
+{
+    /*Without mask fill in one pass to test the black start which is continued in the next rows*/
+    if(!c->masked && !c->map) {
+        _lv_blend_fill(area, area, LV_COLOR_MAKE(0x30, 0xa0, 0xe0), NULL, LV_DRAW_MASK_RES_FULL_COVER, c->opa,
+                       LV_BLEND_MODE_NORMAL);
+        return;
+    }
+
+    /*The mask is a copy because the blending may round it*/
+    static lv_opa_t mask_buf[LV_HOR_RES_MAX];
+    int32_t w = lv_area_get_width(area);
+    lv_area_t row;
+    lv_area_copy(&row, area);
+
+    for(row.y1 = area->y1; row.y1 <= area->y2; row.y1++) {
+        row.y2 = row.y1;
+        lv_opa_t * m = NULL;
+        lv_draw_mask_res_t mask_res = LV_DRAW_MASK_RES_FULL_COVER;
+        if(c->masked) {
+            _lv_memcpy(mask_buf, &mask[row.y1 * w], w);
+            m = mask_buf;
+            mask_res = LV_DRAW_MASK_RES_CHANGED;
+        }
+
+        if(c->map) _lv_blend_map(&row, area, map, m, mask_res, c->opa, LV_BLEND_MODE_NORMAL);
+        else _lv_blend_fill(&row, &row, LV_COLOR_MAKE(0x30, 0xa0, 0xe0), m, mask_res, c->opa, LV_BLEND_MODE_NORMAL);
+    }
+}
+
+/**
+ * Blend `BENCH_ROUNDS` times
+ * @return the elapsed time in microseconds
+ */
+static uint32_t bench(const blend_case_t * c, const lv_area_t * area, const lv_color_t * map, const lv_opa_t * mask)
+{
+    struct timespec start;
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    uint32_t i;
+    for(i = 0; i < BENCH_ROUNDS; i++) blend(c, area, map, mask);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_nsec - start.tv_nsec) / 1000;
+}
+
+#endif
+#endif
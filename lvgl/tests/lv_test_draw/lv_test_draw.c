@@ -0,0 +1,59 @@
+/**
+ * @file lv_test_draw.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../lv_test_assert.h"
+
+#if LV_BUILD_TEST
+#include "lv_test_draw.h"
+#include "lv_test_blend.h"
+#include "lv_test_shadow.h"
+#include "lv_test_radius.h"
+#include "lv_test_img_cache.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_draw(void)
+{
+    lv_test_print("");
+    lv_test_print("*******************");
+    lv_test_print("Start lv_draw tests");
+    lv_test_print("*******************");
+
+    lv_test_blend();
+    lv_test_shadow();
+    lv_test_radius();
+    lv_test_img_cache();
+}
+
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+#endif
@@ -0,0 +1,300 @@
+/**
+ * @file lv_test_img_cache.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../../lvgl.h"
+#include "../lv_test_assert.h"
+#include "lv_test_img_cache.h"
+
+#if LV_BUILD_TEST
+#include <string.h>
+#include <time.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define BENCH_ROUNDS    1000
+#define TEST_IMG_W      16
+#define TEST_IMG_H      16
+#define TEST_USER_DATA_SIZE 16
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void lookup(void);
+static void budget(void);
+static uint32_t bench(uint16_t entry_cnt);
+static lv_res_t test_decoder_info(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header);
+static lv_res_t test_decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc);
+static void test_decoder_close(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const lv_color_t img_data_1[4] = {LV_COLOR_RED, LV_COLOR_GREEN, LV_COLOR_BLUE, LV_COLOR_WHITE};
+static const lv_color_t img_data_2[4] = {LV_COLOR_BLACK, LV_COLOR_GREEN, LV_COLOR_BLUE, LV_COLOR_RED};
+
+static const lv_img_dsc_t img_1 = {
+    .header.always_zero = 0,
+    .header.w = 2,
+    .header.h = 2,
+    .header.cf = LV_IMG_CF_TRUE_COLOR,
+    .data_size = sizeof(img_data_1),
+    .data = (const uint8_t *)img_data_1,
+};
+
+static const lv_img_dsc_t img_2 = {
+    .header.always_zero = 0,
+    .header.w = 2,
+    .header.h = 2,
+    .header.cf = LV_IMG_CF_TRUE_COLOR,
+    .data_size = sizeof(img_data_2),
+    .data = (const uint8_t *)img_data_2,
+};
+
+#if LV_IMG_CF_INDEXED
+/*2 colors palette (ARGB8888) and 2 rows of 1 byte*/
+static const uint8_t img_data_indexed[] = {0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x40, 0x80};
+
+static const lv_img_dsc_t img_indexed = {
+    .header.always_zero = 0,
+    .header.w = 2,
+    .header.h = 2,
+    .header.cf = LV_IMG_CF_INDEXED_1BIT,
+    .data_size = sizeof(img_data_indexed),
+    .data = img_data_indexed,
+};
+#endif
+
+static uint32_t decode_cnt;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_img_cache(void)
+{
+    lv_test_print("");
+    lv_test_print("========================");
+    lv_test_print("Start lv_img_cache tests");
+    lv_test_print("========================");
+
+    lookup();
+    budget();
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void lookup(void)
+{
+    lv_test_print("");
+    lv_test_print("Find the opened images:");
+    lv_test_print("-----------------------");
+
+    lv_img_cache_set_size(8);
+    lv_img_cache_set_mem_size(4096);
+    lv_img_cache_invalidate_src(NULL);
+
+    lv_img_cache_info_t info_start;
+    lv_img_cache_get_info(&info_start);
+
+    lv_img_cache_entry_t * e1 = _lv_img_cache_open(&img_1, LV_COLOR_BLACK);
+    lv_img_cache_entry_t * e2 = _lv_img_cache_open(&img_2, LV_COLOR_BLACK);
+    lv_test_assert_ptr_eq(img_1.data, e1->dec_dsc.img_data, "Image opened");
+
+    uint32_t i;
+    bool same = true;
+    for(i = 0; i < 10; i++) {
+        if(_lv_img_cache_open(&img_1, LV_COLOR_BLACK) != e1) same = false;
+        if(_lv_img_cache_open(&img_2, LV_COLOR_BLACK) != e2) same = false;
+    }
+    lv_test_assert_int_eq(1, same, "Alternating images stay opened");
+
+    lv_img_cache_entry_t * e1_red = _lv_img_cache_open(&img_1, LV_COLOR_RED);
+    lv_test_assert_int_eq(1, e1_red != e1, "Other recolor is a new entry");
+
+    lv_img_cache_info_t info;
+    lv_img_cache_get_info(&info);
+    lv_test_assert_int_eq(20, info.hit_cnt - info_start.hit_cnt, "Hits");
+    lv_test_assert_int_eq(3, info.miss_cnt - info_start.miss_cnt, "Misses");
+    lv_test_assert_int_eq(3, info.entry_cnt, "Entries");
+    lv_test_assert_int_eq(3 * sizeof(lv_img_cache_entry_t), info.mem_size, "Variable images take only an entry");
+
+    lv_img_cache_invalidate_src(&img_1);
+    lv_img_cache_get_info(&info);
+    lv_test_assert_int_eq(1, info.entry_cnt, "Invalidate an image with all its colors");
+
+    _lv_img_cache_open(&img_1, LV_COLOR_BLACK);
+    lv_img_cache_get_info(&info);
+    lv_test_assert_int_eq(4, info.miss_cnt - info_start.miss_cnt, "Open an invalidated image again");
+
+#if LV_IMG_CF_INDEXED
+    /*The palette built by the decoder is counted*/
+    lv_img_cache_invalidate_src(NULL);
+    lv_img_cache_entry_t * e_indexed = _lv_img_cache_open(&img_indexed, LV_COLOR_BLACK);
+    lv_test_assert_int_eq(1, e_indexed != NULL && e_indexed->dec_dsc.user_data_size >= 2 * (sizeof(lv_color_t) + 1),
+                          "Palette counted");
+    lv_img_cache_get_info(&info);
+    lv_test_assert_int_eq(sizeof(lv_img_cache_entry_t) + (e_indexed ? e_indexed->dec_dsc.user_data_size : 0),
+                          info.mem_size, "Indexed image takes an entry and its palette");
+#endif
+
+    lv_img_cache_invalidate_src(NULL);
+    lv_img_cache_set_size(LV_IMG_CACHE_DEF_SIZE);
+    lv_img_cache_set_mem_size(LV_IMG_CACHE_DEF_MEM_SIZE);
+}
+
+static void budget(void)
+{
+    lv_test_print("");
+    lv_test_print("Keep the decoded images in the budget:");
+    lv_test_print("--------------------------------------");
+
+    lv_img_decoder_t * dec = lv_img_decoder_create();
+    lv_img_decoder_set_info_cb(dec, test_decoder_info);
+    lv_img_decoder_set_open_cb(dec, test_decoder_open);
+    lv_img_decoder_set_close_cb(dec, test_decoder_close);
+
+    uint32_t img_size = lv_img_buf_get_img_size(TEST_IMG_W, TEST_IMG_H, LV_IMG_CF_TRUE_COLOR);
+    /*The decoded image, the decoder's data and the copied path are counted*/
+    uint32_t entry_size = sizeof(lv_img_cache_entry_t) + img_size + TEST_USER_DATA_SIZE + strlen("T:a") + 1;
+
+    /*Room for two decoded images*/
+    lv_img_cache_set_size(8);
+    lv_img_cache_set_mem_size(2 * entry_size);
+    lv_img_cache_invalidate_src(NULL);
+    decode_cnt = 0;
+
+    _lv_img_cache_open("T:a", LV_COLOR_BLACK);
+    _lv_img_cache_open("T:b", LV_COLOR_BLACK);
+    _lv_img_cache_open("T:a", LV_COLOR_BLACK);
+    lv_test_assert_int_eq(2, decode_cnt, "Two images fit");
+
+    lv_img_cache_info_t info;
+    lv_img_cache_get_info(&info);
+    lv_test_assert_int_eq(2 * entry_size, info.mem_size, "The decoded images are counted");
+
+    /*"T:b" is the least recently used*/
+    _lv_img_cache_open("T:c", LV_COLOR_BLACK);
+    _lv_img_cache_open("T:a", LV_COLOR_BLACK);
+    lv_test_assert_int_eq(3, decode_cnt, "The least recently used image is closed");
+    _lv_img_cache_open("T:b", LV_COLOR_BLACK);
+    lv_test_assert_int_eq(4, decode_cnt, "The closed image is decoded again");
+
+    /*The last image is kept even if it's larger than the budget*/
+    lv_img_cache_set_mem_size(1);
+    lv_img_cache_get_info(&info);
+    lv_test_assert_int_eq(0, info.entry_cnt, "Smaller budget closes the images");
+    lv_img_cache_entry_t * e = _lv_img_cache_open("T:a", LV_COLOR_BLACK);
+    lv_test_assert_int_eq(1, e != NULL && e->dec_dsc.img_data != NULL, "Image larger than the budget");
+
+    /*Without a memory budget only the number of images is limited*/
+    lv_img_cache_set_mem_size(0);
+    lv_img_cache_set_size(2);
+    decode_cnt = 0;
+    _lv_img_cache_open("T:b", LV_COLOR_BLACK);
+    _lv_img_cache_open("T:c", LV_COLOR_BLACK);
+    _lv_img_cache_open("T:b", LV_COLOR_BLACK);
+    lv_img_cache_get_info(&info);
+    lv_test_assert_int_eq(2, info.entry_cnt, "Number of images limited");
+    lv_test_assert_int_eq(2, decode_cnt, "The least recently used image is closed by the count");
+    lv_img_cache_set_size(1);
+    lv_img_cache_get_info(&info);
+    lv_test_assert_int_eq(1, info.entry_cnt, "Smaller size closes the images");
+
+    uint32_t decode_us = bench(1);
+    uint32_t cache_us = bench(2);
+    lv_test_print("   %d rounds of 2 alternating images: %d us decoded, %d us cached", BENCH_ROUNDS, decode_us,
+                  cache_us);
+
+    lv_img_cache_invalidate_src(NULL);
+    lv_img_cache_set_size(LV_IMG_CACHE_DEF_SIZE);
+    lv_img_cache_set_mem_size(LV_IMG_CACHE_DEF_MEM_SIZE);
+    lv_img_decoder_delete(dec);
+}
+
+/**
+ * Open 2 images alternately `BENCH_ROUNDS` times
+ * @param entry_cnt number of images to keep opened
+ * @return the elapsed time in microseconds
+ */
+static uint32_t bench(uint16_t entry_cnt)
+{
+    lv_img_cache_invalidate_src(NULL);
+    lv_img_cache_set_mem_size(0);
+    lv_img_cache_set_size(entry_cnt);
+
+    struct timespec start;
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    uint32_t i;
+    for(i = 0; i < BENCH_ROUNDS; i++) {
+        _lv_img_cache_open("T:a", LV_COLOR_BLACK);
+        _lv_img_cache_open("T:b", LV_COLOR_BLACK);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_nsec - start.tv_nsec) / 1000;
+}
+
+/**
+ * A decoder of "T:..." paths which decodes a true color image to RAM and allocates some data for itself
+ */
+static lv_res_t test_decoder_info(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header)
+{
+    (void)decoder;
+    if(lv_img_src_get_type(src) != LV_IMG_SRC_FILE || strncmp(src, "T:", 2) != 0) return LV_RES_INV;
+
+    header->always_zero = 0;
+    header->w = TEST_IMG_W;
+    header->h = TEST_IMG_H;
+    header->cf = LV_IMG_CF_TRUE_COLOR;
+    return LV_RES_OK;
+}
+
+static lv_res_t test_decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
+{
+    (void)decoder;
+    uint32_t size = lv_img_buf_get_img_size(TEST_IMG_W, TEST_IMG_H, LV_IMG_CF_TRUE_COLOR);
+    uint8_t * buf = lv_mem_alloc(size);
+    if(buf == NULL) return LV_RES_INV;
+
+    dsc->user_data = lv_mem_alloc(TEST_USER_DATA_SIZE);
+    if(dsc->user_data == NULL) {
+        lv_mem_free(buf);
+        return LV_RES_INV;
+    }
+    dsc->user_data_size = TEST_USER_DATA_SIZE;
+
+    /*Pretend decoding*/
+    uint32_t i;
+    for(i = 0; i < size; i++) buf[i] = ((const char *)dsc->src)[2] + i;
+
+    dsc->img_data = buf;
+    decode_cnt++;
+    return LV_RES_OK;
+}
+
+static void test_decoder_close(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
+{
+    (void)decoder;
+    lv_mem_free(dsc->img_data);
+    dsc->img_data = NULL;
+    lv_mem_free(dsc->user_data);
+    dsc->user_data = NULL;
+}
+
+#endif
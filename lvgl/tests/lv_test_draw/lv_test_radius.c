@@ -0,0 +1,236 @@
+/**
+ * @file lv_test_radius.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../../lvgl.h"
+#include "../lv_test_assert.h"
+#include "lv_test_radius.h"
+
+#if LV_BUILD_TEST
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define BENCH_ROUNDS    200
+#define BUF_LEN         700
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+#if LV_RADIUS_MASK_CACHE_CNT
+static void radius_cache(void);
+static bool compare(lv_coord_t w, lv_coord_t h, lv_coord_t radius, bool inv);
+static uint32_t bench(lv_coord_t radius, bool cache);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_radius(void)
+{
+    lv_test_print("");
+    lv_test_print("===========================");
+    lv_test_print("Start lv_radius mask tests");
+    lv_test_print("===========================");
+
+#if LV_RADIUS_MASK_CACHE_CNT
+    radius_cache();
+#else
+    lv_test_print("Skip the radius mask cache tests: requires LV_RADIUS_MASK_CACHE_CNT");
+#endif
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+#if LV_RADIUS_MASK_CACHE_CNT
+
+static void radius_cache(void)
+{
+    lv_test_print("");
+    lv_test_print("Compare the buffered corners with the calculated ones:");
+    lv_test_print("------------------------------------------------------");
+
+    static const lv_coord_t radii[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 15, 16, 20, 24, 25, 31, 32, 33,
+                                       40, 50, 64, 100, 255, 256, 257, 300
+                                      };
+    uint32_t i;
+    for(i = 0; i < sizeof(radii) / sizeof(radii[0]); i++) {
+        lv_coord_t r = radii[i];
+        char name[64];
+        bool ok = compare(2 * r, 2 * r, r, false) && compare(2 * r, 2 * r, r, true) &&
+                  compare(2 * r + 7, 2 * r + 3, r, false) && compare(2 * r + 7, 2 * r + 3, r, true);
+        snprintf(name, sizeof(name), "Radius %d", r);
+        lv_test_assert_int_eq(1, ok, name);
+    }
+
+    /*The buffered corners stay in the budget*/
+    lv_draw_mask_radius_cache_info_t info;
+    lv_draw_mask_radius_cache_get_info(&info);
+    lv_test_assert_int_eq(1, info.mem_size <= LV_RADIUS_MASK_CACHE_SIZE, "Radius mask cache in the budget");
+    lv_test_assert_int_eq(1, info.entry_cnt <= LV_RADIUS_MASK_CACHE_CNT, "Radius mask cache entries");
+
+    /*The same radius again is served from the buffer*/
+    lv_draw_mask_radius_param_t p;
+    lv_area_t rect;
+    lv_area_set(&rect, 0, 0, 99, 39);
+    lv_draw_mask_radius_init(&p, &rect, 10, false);
+    lv_draw_mask_radius_init(&p, &rect, LV_RADIUS_CIRCLE, false);
+    lv_draw_mask_radius_cache_info_t info_start;
+    lv_draw_mask_radius_cache_get_info(&info_start);
+    lv_draw_mask_radius_init(&p, &rect, 10, false);
+    lv_draw_mask_radius_init(&p, &rect, LV_RADIUS_CIRCLE, false);
+    lv_draw_mask_radius_cache_get_info(&info);
+    lv_test_assert_int_eq(2, info.hit_cnt - info_start.hit_cnt, "Radius masks with a buffered corner");
+    lv_test_assert_int_eq(0, info.miss_cnt - info_start.miss_cnt, "Radius masks calculated");
+    lv_test_print("   %d radii buffered in %d bytes", info.entry_cnt, info.mem_size);
+
+    /*A radius whose table can't fit into the budget is calculated without buffering it*/
+    lv_coord_t r_large = LV_RADIUS_MASK_CACHE_SIZE / 2;
+    lv_area_set(&rect, 0, 0, 2 * r_large - 1, 2 * r_large - 1);
+    lv_draw_mask_radius_cache_get_info(&info_start);
+    lv_draw_mask_radius_init(&p, &rect, r_large, false);
+    lv_draw_mask_radius_cache_get_info(&info);
+    lv_test_assert_ptr_eq(NULL, p.corner, "Radius larger than the budget not buffered");
+    lv_test_assert_int_eq(info_start.mem_size, info.mem_size, "Buffered corners kept");
+
+    /*A mask whose corner was freed by newer radii calculates it*/
+    lv_area_set(&rect, 10, 10, 10 + 2 * 7 + 5, 10 + 2 * 7 - 1);
+    lv_draw_mask_radius_param_t stale;
+    lv_draw_mask_radius_init(&stale, &rect, 7, false);
+    lv_draw_mask_radius_param_t calc;
+    lv_draw_mask_radius_init(&calc, &rect, 7, false);
+    calc.corner = NULL;
+    lv_coord_t r;
+    for(r = 20; r < 20 + LV_RADIUS_MASK_CACHE_CNT + 1; r++) {
+        lv_draw_mask_radius_param_t tmp;
+        lv_area_t tmp_rect;
+        lv_area_set(&tmp_rect, 0, 0, 2 * r - 1, 2 * r - 1);
+        lv_draw_mask_radius_init(&tmp, &tmp_rect, r, false);
+    }
+    bool same = true;
+    lv_coord_t y;
+    for(y = rect.y1; y <= rect.y2; y++) {
+        static lv_opa_t buf_stale[32];
+        static lv_opa_t buf_calc[32];
+        _lv_memset_ff(buf_stale, sizeof(buf_stale));
+        _lv_memset_ff(buf_calc, sizeof(buf_calc));
+        lv_draw_mask_res_t res_stale = stale.dsc.cb(buf_stale, 5, y, sizeof(buf_stale), &stale);
+        lv_draw_mask_res_t res_calc = calc.dsc.cb(buf_calc, 5, y, sizeof(buf_calc), &calc);
+        if(res_stale != res_calc || memcmp(buf_stale, buf_calc, sizeof(buf_calc))) same = false;
+    }
+    lv_test_assert_int_eq(1, same, "Mask with a freed corner");
+
+    lv_draw_mask_radius_cache_get_info(&info_start);
+    lv_draw_mask_radius_init(&stale, &rect, 7, false);
+    lv_draw_mask_radius_cache_get_info(&info);
+    lv_test_assert_int_eq(1, info.miss_cnt - info_start.miss_cnt, "Radius 7 was freed");
+
+    static const lv_coord_t bench_radii[] = {5, 10, 20};
+    for(i = 0; i < sizeof(bench_radii) / sizeof(bench_radii[0]); i++) {
+        uint32_t calc_us = bench(bench_radii[i], false);
+        uint32_t cache_us = bench(bench_radii[i], true);
+        lv_test_print("   Radius %d, %d rounds: %d us calculated, %d us buffered", bench_radii[i], BENCH_ROUNDS,
+                      calc_us, cache_us);
+    }
+}
+
+/**
+ * Apply a radius mask with and without the buffered corner to every row of a rectangle
+ * with several windows of the row and compare the results
+ * @return true if the mask and the result code were the same everywhere
+ */
+static bool compare(lv_coord_t w, lv_coord_t h, lv_coord_t radius, bool inv)
+{
+    lv_area_t rect;
+    lv_area_set(&rect, 10, 10, 10 + w - 1, 10 + h - 1);
+
+    lv_draw_mask_radius_param_t cached;
+    lv_draw_mask_radius_init(&cached, &rect, radius, inv);
+    if(cached.corner == NULL) return false;
+
+    lv_draw_mask_radius_param_t calc;
+    lv_draw_mask_radius_init(&calc, &rect, radius, inv);
+    calc.corner = NULL;
+
+    /*The whole row, only the left and right corners and windows starting or ending inside the corners*/
+    const lv_coord_t win[][2] = {
+        {0, w + 20}, {rect.x1 - 2, radius + 3}, {rect.x2 - radius, radius + 4},
+        {rect.x1 + radius / 2, w - radius}, {rect.x1 + 1, 1}, {rect.x2 + 1, 5}, {0, rect.x1 + 1},
+    };
+
+    static lv_opa_t buf_cached[BUF_LEN];
+    static lv_opa_t buf_calc[BUF_LEN];
+    lv_coord_t y;
+    uint32_t i;
+    for(y = rect.y1 - 1; y <= rect.y2 + 1; y++) {
+        for(i = 0; i < sizeof(win) / sizeof(win[0]); i++) {
+            lv_coord_t len = win[i][1];
+            if(len <= 0 || len > BUF_LEN) continue;
+
+            uint32_t x;
+            for(x = 0; x < (uint32_t)len; x++) buf_cached[x] = (x * 37 + y * 11) & 0xFF;
+            _lv_memcpy(buf_calc, buf_cached, len);
+
+            lv_draw_mask_res_t res_cached = cached.dsc.cb(buf_cached, win[i][0], y, len, &cached);
+            lv_draw_mask_res_t res_calc = calc.dsc.cb(buf_calc, win[i][0], y, len, &calc);
+            if(res_cached != res_calc) return false;
+            if(res_calc != LV_DRAW_MASK_RES_TRANSP && memcmp(buf_cached, buf_calc, len)) return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Apply a radius mask to every row of a 100x60 rectangle `BENCH_ROUNDS` times
+ * @param cache false: calculate the corners
+ * @return the elapsed time in microseconds
+ */
+static uint32_t bench(lv_coord_t radius, bool cache)
+{
+    lv_area_t rect;
+    lv_area_set(&rect, 0, 0, 99, 59);
+    lv_draw_mask_radius_param_t p;
+    lv_draw_mask_radius_init(&p, &rect, radius, false);
+    if(!cache) p.corner = NULL;
+
+    static lv_opa_t buf[100];
+    struct timespec start;
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    uint32_t i;
+    lv_coord_t y;
+    for(i = 0; i < BENCH_ROUNDS; i++) {
+        for(y = rect.y1; y <= rect.y2; y++) {
+            _lv_memset_ff(buf, sizeof(buf));
+            p.dsc.cb(buf, rect.x1, y, sizeof(buf), &p);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_nsec - start.tv_nsec) / 1000;
+}
+
+#endif
+#endif
@@ -0,0 +1,191 @@
+/**
+ * @file lv_test_shadow.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../../lvgl.h"
+#include "../lv_test_assert.h"
+#include "lv_test_shadow.h"
+
+#if LV_BUILD_TEST
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define BENCH_ROUNDS    50
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    const char * name;
+    lv_coord_t w;
+    lv_coord_t h;
+    lv_style_int_t radius;
+    lv_style_int_t shadow_width;
+    lv_style_int_t spread;
+    lv_style_int_t ofs;
+} shadow_case_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+#if LV_USE_SHADOW && LV_SHADOW_CACHE_SIZE
+static void shadow_cache(void);
+static void draw(const shadow_case_t * c);
+static uint32_t bench(const shadow_case_t * c, bool cache);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_shadow(void)
+{
+    lv_test_print("");
+    lv_test_print("=====================");
+    lv_test_print("Start lv_shadow tests");
+    lv_test_print("=====================");
+
+#if LV_USE_SHADOW && LV_SHADOW_CACHE_SIZE
+    shadow_cache();
+#else
+    lv_test_print("Skip the shadow cache tests: requires LV_USE_SHADOW and LV_SHADOW_CACHE_SIZE");
+#endif
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+#if LV_USE_SHADOW && LV_SHADOW_CACHE_SIZE
+
+static void shadow_cache(void)
+{
+    lv_test_print("");
+    lv_test_print("Compare the shadows drawn from the cache:");
+    lv_test_print("-----------------------------------------");
+
+    /*The wide and narrow variants of a shape share the cached corner only while the size doesn't matter*/
+    static const shadow_case_t cases[] = {
+        {"Large", 120, 80, 10, 20, 0, 0},
+        {"Large, other size", 160, 100, 10, 20, 0, 0},
+        {"Narrow", 30, 80, 10, 20, 0, 0},
+        {"Flat", 120, 12, 10, 20, 0, 0},
+        {"Tiny", 8, 8, 10, 20, 0, 0},
+        {"Spread and offset", 100, 60, 5, 15, 4, 3},
+        {"Odd width", 100, 60, 8, 11, 0, 0},
+        {"Thin", 100, 60, 0, 1, 2, 0},
+    };
+    const uint32_t case_cnt = sizeof(cases) / sizeof(cases[0]);
+
+    lv_disp_t * disp = lv_disp_get_default();
+    lv_disp_buf_t * vdb = lv_disp_get_buf(disp);
+    lv_coord_t hor_res = lv_disp_get_hor_res(disp);
+    lv_coord_t ver_res = lv_disp_get_ver_res(disp);
+    uint32_t buf_size = (uint32_t)hor_res * ver_res * sizeof(lv_color_t);
+
+    _lv_refr_set_disp_refreshing(disp);
+    lv_area_set(&vdb->area, 0, 0, hor_res - 1, ver_res - 1);
+
+    /*Draw every shape without the cache*/
+    uint8_t * ref = malloc(buf_size * case_cnt);
+    uint32_t i;
+    for(i = 0; i < case_cnt; i++) {
+        lv_draw_shadow_cache_invalidate();
+        draw(&cases[i]);
+        _lv_memcpy(&ref[buf_size * i], vdb->buf_act, buf_size);
+    }
+
+    /*Draw them again twice: with the corners cached by the other shapes and with their own corners*/
+    lv_draw_shadow_cache_invalidate();
+    lv_draw_shadow_cache_info_t info_start;
+    lv_draw_shadow_cache_get_info(&info_start);
+    uint32_t round;
+    for(i = 0; i < case_cnt; i++) {
+        for(round = 0; round < 2; round++) {
+            draw(&cases[i]);
+            lv_test_assert_int_eq(0, memcmp(&ref[buf_size * i], vdb->buf_act, buf_size) != 0, cases[i].name);
+        }
+    }
+
+    lv_draw_shadow_cache_info_t info;
+    lv_draw_shadow_cache_get_info(&info);
+    lv_test_print("   %d hits, %d misses, %d corners cached in %d bytes", info.hit_cnt - info_start.hit_cnt,
+                  info.miss_cnt - info_start.miss_cnt, info.entry_cnt, info.mem_size);
+    lv_test_assert_int_eq(case_cnt + 1, info.hit_cnt - info_start.hit_cnt, "Shadows drawn from the cache");
+
+    uint32_t blur_us = bench(&cases[0], false);
+    uint32_t cache_us = bench(&cases[0], true);
+    lv_test_print("   %d rounds: %d us blurred, %d us cached", BENCH_ROUNDS, blur_us, cache_us);
+
+    _lv_refr_set_disp_refreshing(NULL);
+    free(ref);
+}
+
+/**
+ * Clear the display buffer and draw a rectangle with shadow in its middle
+ */
+static void draw(const shadow_case_t * c)
+{
+    lv_disp_t * disp = lv_disp_get_default();
+    lv_disp_buf_t * vdb = lv_disp_get_buf(disp);
+    lv_coord_t hor_res = lv_disp_get_hor_res(disp);
+    lv_coord_t ver_res = lv_disp_get_ver_res(disp);
+
+    uint32_t px;
+    lv_color_t * buf = vdb->buf_act;
+    for(px = 0; px < (uint32_t)hor_res * ver_res; px++) buf[px] = LV_COLOR_WHITE;
+
+    lv_draw_rect_dsc_t dsc;
+    lv_draw_rect_dsc_init(&dsc);
+    dsc.radius = c->radius;
+    dsc.shadow_width = c->shadow_width;
+    dsc.shadow_spread = c->spread;
+    dsc.shadow_ofs_x = c->ofs;
+    dsc.shadow_ofs_y = c->ofs;
+    dsc.shadow_color = LV_COLOR_BLUE;
+
+    lv_area_t coords;
+    lv_area_set(&coords, (hor_res - c->w) / 2, (ver_res - c->h) / 2, (hor_res - c->w) / 2 + c->w - 1,
+                (ver_res - c->h) / 2 + c->h - 1);
+    lv_area_t clip;
+    lv_area_set(&clip, 0, 0, hor_res - 1, ver_res - 1);
+    lv_draw_rect(&coords, &clip, &dsc);
+}
+
+/**
+ * Draw a shape `BENCH_ROUNDS` times
+ * @param cache false: drop the cached corner before every round
+ * @return the elapsed time in microseconds
+ */
+static uint32_t bench(const shadow_case_t * c, bool cache)
+{
+    struct timespec start;
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    uint32_t i;
+    for(i = 0; i < BENCH_ROUNDS; i++) {
+        if(!cache) lv_draw_shadow_cache_invalidate();
+        draw(c);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_nsec - start.tv_nsec) / 1000;
+}
+
+#endif
+#endif
@@ -0,0 +1,57 @@
+/**
+ * @file lv_test_font.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../lv_test_assert.h"
+
+#if LV_BUILD_TEST
+#include "lv_test_font.h"
+#include "lv_test_font_fast_index.h"
+#include "lv_test_font_loader.h"
+#include "lv_test_glyph_cache.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_font(void)
+{
+    lv_test_print("");
+    lv_test_print("*******************");
+    lv_test_print("Start lv_font tests");
+    lv_test_print("*******************");
+
+    lv_test_font_loader();
+    lv_test_glyph_cache();
+    lv_test_font_fast_index();
+}
+
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+#endif
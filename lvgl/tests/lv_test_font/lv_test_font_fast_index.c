@@ -0,0 +1,411 @@
+/**
+ * @file lv_test_font_fast_index.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../../lvgl.h"
+#include "../lv_test_assert.h"
+#include "lv_test_font_fast_index.h"
+
+#if LV_BUILD_TEST
+#include <string.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define FAST_DEGREE_SIGN    0xB0
+#define MAX_PAIR_CNT        (LV_FONT_FMT_TXT_FAST_CNT * LV_FONT_FMT_TXT_FAST_CNT)
+#define MEM_BLOCK_MAX       256
+#define TEST_CANVAS_W       120
+#define TEST_CANVAS_H       20
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+#if LV_FONT_FMT_TXT_FAST_INDEX && LV_FONT_MONTSERRAT_16
+static void glyph_ids(void);
+static void fallback(void);
+static void kern_matrix(void);
+static void alloc_fail(void);
+static void font_copy(lv_font_t * font, lv_font_fmt_txt_dsc_t * dsc, const lv_font_t * src, bool search);
+static uint32_t search_glyph_id(const lv_font_fmt_txt_dsc_t * dsc, uint32_t letter);
+static void kern_pairs_init(lv_font_fmt_txt_kern_pair_t * kern, const lv_font_t * src, uint8_t glyph_ids_size);
+static bool same_glyph(const lv_font_t * font_ref, const lv_font_t * font, uint32_t letter, uint32_t letter_next);
+static uint32_t fast_letter(uint32_t slot);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+#if LV_FONT_FMT_TXT_FAST_INDEX && LV_FONT_MONTSERRAT_16
+static uint16_t pair_ids[MAX_PAIR_CNT * 2];
+static int8_t pair_values[MAX_PAIR_CNT];
+#endif
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_font_fast_index(void)
+{
+    lv_test_print("");
+    lv_test_print("==============================");
+    lv_test_print("Start lv_font fast index tests");
+    lv_test_print("==============================");
+
+#if LV_FONT_FMT_TXT_FAST_INDEX && LV_FONT_MONTSERRAT_16
+    glyph_ids();
+    fallback();
+    kern_matrix();
+    alloc_fail();
+#else
+    lv_test_print("Skip the fast index tests: requires LV_FONT_FMT_TXT_FAST_INDEX and LV_FONT_MONTSERRAT_16");
+#endif
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+#if LV_FONT_FMT_TXT_FAST_INDEX && LV_FONT_MONTSERRAT_16
+
+static void glyph_ids(void)
+{
+    lv_test_print("");
+    lv_test_print("Index the same glyphs as the character maps:");
+    lv_test_print("--------------------------------------------");
+
+    lv_font_t font;
+    lv_font_fmt_txt_dsc_t dsc;
+    font_copy(&font, &dsc, &lv_font_montserrat_16, false);
+
+    lv_font_t font_search;
+    lv_font_fmt_txt_dsc_t dsc_search;
+    font_copy(&font_search, &dsc_search, &lv_font_montserrat_16, true);
+
+    lv_font_glyph_dsc_t g;
+    lv_font_get_glyph_dsc(&font, &g, 'A', 0);
+    lv_test_assert_int_eq(1, dsc.fast_index != NULL, "Built on the first lookup");
+    if(dsc.fast_index == NULL) return;
+
+    uint32_t id_diff_cnt = 0;
+    uint32_t dsc_diff_cnt = 0;
+    uint32_t slot;
+    for(slot = 0; slot < LV_FONT_FMT_TXT_FAST_CNT; slot++) {
+        uint32_t letter = fast_letter(slot);
+        if(dsc.fast_index->glyph_id[slot] != search_glyph_id(&dsc, letter)) id_diff_cnt++;
+        if(!same_glyph(&font_search, &font, letter, 0)) dsc_diff_cnt++;
+    }
+    lv_test_assert_int_eq(0, id_diff_cnt, "Glyph ids of U+0020..U+007F and U+00B0");
+    lv_test_assert_int_eq(0, dsc_diff_cnt, "Glyphs of U+0020..U+007F and U+00B0");
+    lv_test_assert_int_eq(0, dsc.fast_index->glyph_id[0x7F - 0x20], "Missing U+007F");
+
+    _lv_font_fmt_txt_release(&font);
+    _lv_font_fmt_txt_release(&font_search);
+}
+
+static void fallback(void)
+{
+    lv_test_print("");
+    lv_test_print("Search the other letters:");
+    lv_test_print("-------------------------");
+
+    lv_font_t font;
+    lv_font_fmt_txt_dsc_t dsc;
+    font_copy(&font, &dsc, &lv_font_montserrat_16, false);
+
+    lv_font_t font_search;
+    lv_font_fmt_txt_dsc_t dsc_search;
+    font_copy(&font_search, &dsc_search, &lv_font_montserrat_16, true);
+
+    /*Around the indexed letters, a symbol and a letter out of Unicode*/
+    static const uint32_t letters[] = {0x1F, 0x80, 0xAF, 0xB1, 0xF00C, 0xF8A2, 0x10FFFF};
+    uint32_t diff_cnt = 0;
+    uint32_t i;
+    for(i = 0; i < sizeof(letters) / sizeof(letters[0]); i++) {
+        if(!same_glyph(&font_search, &font, letters[i], 'A')) diff_cnt++;
+        if(!same_glyph(&font_search, &font, 'A', letters[i])) diff_cnt++;
+    }
+    lv_test_assert_int_eq(0, diff_cnt, "Same glyphs as the search");
+
+    lv_font_glyph_dsc_t g;
+    lv_test_assert_int_eq(1, lv_font_get_glyph_dsc(&font, &g, 0xF00C, 0), "Symbol found");
+    lv_test_assert_int_eq(1, dsc.fast_index != NULL, "Next to the fast index");
+
+    _lv_font_fmt_txt_release(&font);
+    _lv_font_fmt_txt_release(&font_search);
+}
+
+static void kern_matrix(void)
+{
+    lv_test_print("");
+    lv_test_print("Store the kerning pairs in a matrix:");
+    lv_test_print("------------------------------------");
+
+    /*The class kerning is looked up directly*/
+    lv_font_t font_classes;
+    lv_font_fmt_txt_dsc_t dsc_classes;
+    font_copy(&font_classes, &dsc_classes, &lv_font_montserrat_16, false);
+    lv_font_glyph_dsc_t g;
+    lv_font_get_glyph_dsc(&font_classes, &g, 'A', 'V');
+    lv_test_assert_int_eq(1, dsc_classes.fast_index && dsc_classes.fast_index->kern == NULL, "No matrix for classes");
+
+    /*The same kerning with 8 and 16 bit glyph id pairs*/
+    uint8_t glyph_ids_size;
+    for(glyph_ids_size = 0; glyph_ids_size <= 1; glyph_ids_size++) {
+        lv_font_fmt_txt_kern_pair_t kern;
+        kern_pairs_init(&kern, &lv_font_montserrat_16, glyph_ids_size);
+
+        lv_font_t font;
+        lv_font_fmt_txt_dsc_t dsc;
+        font_copy(&font, &dsc, &lv_font_montserrat_16, false);
+        dsc.kern_dsc = &kern;
+        dsc.kern_classes = 0;
+
+        lv_font_t font_search;
+        lv_font_fmt_txt_dsc_t dsc_search;
+        font_copy(&font_search, &dsc_search, &lv_font_montserrat_16, true);
+        dsc_search.kern_dsc = &kern;
+        dsc_search.kern_classes = 0;
+
+        lv_font_get_glyph_dsc(&font, &g, 'A', 'V');
+        lv_test_assert_int_eq(1, dsc.fast_index && dsc.fast_index->kern, "Matrix built for the pairs");
+
+        uint32_t pair_diff_cnt = 0;
+        uint32_t class_diff_cnt = 0;
+        uint32_t kerned_cnt = 0;
+        uint32_t left;
+        uint32_t right;
+        for(left = 0; left < LV_FONT_FMT_TXT_FAST_CNT; left++) {
+            for(right = 0; right < LV_FONT_FMT_TXT_FAST_CNT; right++) {
+                uint32_t l = fast_letter(left);
+                uint32_t r = fast_letter(right);
+                if(!same_glyph(&font_search, &font, l, r)) pair_diff_cnt++;
+                if(!same_glyph(&font_classes, &font, l, r)) class_diff_cnt++;
+                if(dsc.fast_index && dsc.fast_index->kern &&
+                   dsc.fast_index->kern[left * LV_FONT_FMT_TXT_FAST_CNT + right] != 0) kerned_cnt++;
+            }
+        }
+        lv_test_assert_int_gt(0, kerned_cnt, "Kerned pairs in the matrix");
+        lv_test_assert_int_eq(0, pair_diff_cnt, glyph_ids_size ? "Same as the 16 bit pairs" : "Same as the 8 bit pairs");
+        lv_test_assert_int_eq(0, class_diff_cnt, "Same as the classes");
+
+        _lv_font_fmt_txt_release(&font);
+        _lv_font_fmt_txt_release(&font_search);
+    }
+
+    _lv_font_fmt_txt_release(&font_classes);
+}
+
+static void alloc_fail(void)
+{
+    lv_test_print("");
+    lv_test_print("Search the letters without memory for the index:");
+    lv_test_print("------------------------------------------------");
+
+#if LV_MEM_CUSTOM == 0
+    lv_font_t font;
+    lv_font_fmt_txt_dsc_t dsc;
+    font_copy(&font, &dsc, &lv_font_montserrat_16, false);
+
+    lv_font_t font_search;
+    lv_font_fmt_txt_dsc_t dsc_search;
+    font_copy(&font_search, &dsc_search, &lv_font_montserrat_16, true);
+
+    /*Use all the memory*/
+    static void * blocks[MEM_BLOCK_MAX];
+    uint32_t block_cnt = 0;
+    uint32_t block_size = 4096;
+    while(block_size > 0 && block_cnt < MEM_BLOCK_MAX) {
+        void * p = lv_mem_alloc(block_size);
+        if(p) blocks[block_cnt++] = p;
+        else block_size = block_size >> 1;
+    }
+
+    bool same = same_glyph(&font_search, &font, 'A', 'V');
+    bool failed = dsc.fast_index == NULL && dsc.fast_index_failed;
+
+    while(block_cnt > 0) lv_mem_free(blocks[--block_cnt]);
+
+    lv_test_assert_int_eq(1, failed, "Index not allocated");
+    lv_test_assert_int_eq(1, same, "Letter found");
+
+    lv_font_glyph_dsc_t g;
+    lv_font_get_glyph_dsc(&font, &g, 'B', 0);
+    lv_test_assert_ptr_eq(NULL, dsc.fast_index, "Not retried with free memory");
+
+#if LV_USE_CANVAS
+    static lv_color_t buf[LV_CANVAS_BUF_SIZE_TRUE_COLOR(TEST_CANVAS_W, TEST_CANVAS_H)];
+    static lv_color_t buf_ref[LV_CANVAS_BUF_SIZE_TRUE_COLOR(TEST_CANVAS_W, TEST_CANVAS_H)];
+    lv_obj_t * canvas = lv_canvas_create(lv_scr_act(), NULL);
+
+    lv_draw_label_dsc_t label_dsc;
+    lv_draw_label_dsc_init(&label_dsc);
+    label_dsc.color = LV_COLOR_BLACK;
+
+    label_dsc.font = &font;
+    lv_canvas_set_buffer(canvas, buf, TEST_CANVAS_W, TEST_CANVAS_H, LV_IMG_CF_TRUE_COLOR);
+    lv_canvas_fill_bg(canvas, LV_COLOR_WHITE, LV_OPA_COVER);
+    lv_canvas_draw_text(canvas, 0, 0, TEST_CANVAS_W, &label_dsc, "AVAVA 21.5°C", LV_LABEL_ALIGN_LEFT);
+
+    /*The original font with the index*/
+    label_dsc.font = &lv_font_montserrat_16;
+    lv_canvas_set_buffer(canvas, buf_ref, TEST_CANVAS_W, TEST_CANVAS_H, LV_IMG_CF_TRUE_COLOR);
+    lv_canvas_fill_bg(canvas, LV_COLOR_WHITE, LV_OPA_COVER);
+    lv_canvas_draw_text(canvas, 0, 0, TEST_CANVAS_W, &label_dsc, "AVAVA 21.5°C", LV_LABEL_ALIGN_LEFT);
+
+    lv_test_assert_int_eq(0, memcmp(buf_ref, buf, sizeof(buf)), "Text drawn the same");
+    lv_obj_del(canvas);
+#endif
+
+    _lv_font_fmt_txt_release(&font);
+    _lv_font_fmt_txt_release(&font_search);
+#else
+    lv_test_print("Skip: requires LV_MEM_CUSTOM 0");
+#endif
+}
+
+/**
+ * Copy a C font to change its descriptor
+ * @param font initialize this font
+ * @param dsc initialize this descriptor for the font
+ * @param src the font to copy
+ * @param search true: don't build the fast index and search every letter in the character maps
+ */
+static void font_copy(lv_font_t * font, lv_font_fmt_txt_dsc_t * dsc, const lv_font_t * src, bool search)
+{
+    *dsc = *(const lv_font_fmt_txt_dsc_t *)src->dsc;
+    dsc->fast_index = NULL;
+    dsc->fast_index_failed = search ? 1 : 0;
+    dsc->last_letter = 0;
+    dsc->last_glyph_id = 0;
+
+    *font = *src;
+    font->dsc = dsc;
+}
+
+/**
+ * Find the glyph of a letter by walking the character maps
+ * @param dsc pointer to a font descriptor
+ * @param letter an UNICODE letter code
+ * @return the glyph id or 0 if not found
+ */
+static uint32_t search_glyph_id(const lv_font_fmt_txt_dsc_t * dsc, uint32_t letter)
+{
+    uint32_t i;
+    for(i = 0; i < dsc->cmap_num; i++) {
+        const lv_font_fmt_txt_cmap_t * cmap = &dsc->cmaps[i];
+        uint32_t rcp = letter - cmap->range_start;
+        if(letter < cmap->range_start || rcp >= cmap->range_length) continue;
+
+        switch(cmap->type) {
+            case LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY:
+                return cmap->glyph_id_start + rcp;
+            case LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL:
+                return cmap->glyph_id_start + ((const uint8_t *)cmap->glyph_id_ofs_list)[rcp];
+            default: {
+                    uint32_t k;
+                    for(k = 0; k < cmap->list_length; k++) {
+                        if(cmap->unicode_list[k] != rcp) continue;
+                        if(cmap->type == LV_FONT_FMT_TXT_CMAP_SPARSE_TINY) return cmap->glyph_id_start + k;
+                        return cmap->glyph_id_start + ((const uint16_t *)cmap->glyph_id_ofs_list)[k];
+                    }
+                    return 0;
+                }
+        }
+    }
+    return 0;
+}
+
+/**
+ * Convert the class kerning of the indexed letters of a font to pairs
+ * @param kern initialize this kerning with the pairs in `pair_ids` and `pair_values`
+ * @param src a font with kerning classes
+ * @param glyph_ids_size 0: 8 bit glyph ids; 1: 16 bit glyph ids
+ */
+static void kern_pairs_init(lv_font_fmt_txt_kern_pair_t * kern, const lv_font_t * src, uint8_t glyph_ids_size)
+{
+    const lv_font_fmt_txt_dsc_t * dsc = src->dsc;
+    const lv_font_fmt_txt_kern_classes_t * classes = dsc->kern_dsc;
+
+    /*The pairs are binary searched: ordered by the left then by the right glyph id*/
+    uint8_t * ids_8 = (uint8_t *)pair_ids;
+    uint32_t pair_cnt = 0;
+    uint32_t left;
+    uint32_t right;
+    uint32_t glyph_cnt = 0;
+    for(left = 0; left < LV_FONT_FMT_TXT_FAST_CNT; left++) {
+        glyph_cnt = LV_MATH_MAX(glyph_cnt, search_glyph_id(dsc, fast_letter(left)) + 1);
+    }
+
+    for(left = 1; left < glyph_cnt; left++) {
+        for(right = 1; right < glyph_cnt; right++) {
+            uint8_t left_class = classes->left_class_mapping[left];
+            uint8_t right_class = classes->right_class_mapping[right];
+            if(left_class == 0 || right_class == 0) continue;
+            int8_t value = classes->class_pair_values[(left_class - 1) * classes->right_class_cnt + (right_class - 1)];
+            if(value == 0 || pair_cnt == MAX_PAIR_CNT) continue;
+
+            if(glyph_ids_size == 0) {
+                ids_8[pair_cnt * 2] = left;
+                ids_8[pair_cnt * 2 + 1] = right;
+            }
+            else {
+                pair_ids[pair_cnt * 2] = left;
+                pair_ids[pair_cnt * 2 + 1] = right;
+            }
+            pair_values[pair_cnt] = value;
+            pair_cnt++;
+        }
+    }
+
+    kern->glyph_ids = pair_ids;
+    kern->values = pair_values;
+    kern->pair_cnt = pair_cnt;
+    kern->glyph_ids_size = glyph_ids_size;
+}
+
+/**
+ * Compare a letter of two fonts
+ * @return true: both fonts have the glyph with the same descriptor and bitmap or none of them has it
+ */
+static bool same_glyph(const lv_font_t * font_ref, const lv_font_t * font, uint32_t letter, uint32_t letter_next)
+{
+    lv_font_glyph_dsc_t g_ref;
+    lv_font_glyph_dsc_t g;
+    bool found_ref = lv_font_get_glyph_dsc(font_ref, &g_ref, letter, letter_next);
+    bool found = lv_font_get_glyph_dsc(font, &g, letter, letter_next);
+    if(found_ref != found) return false;
+    if(!found) return true;
+
+    if(g_ref.adv_w != g.adv_w || g_ref.box_w != g.box_w || g_ref.box_h != g.box_h || g_ref.ofs_x != g.ofs_x ||
+       g_ref.ofs_y != g.ofs_y || g_ref.bpp != g.bpp) {
+        return false;
+    }
+
+    /*The C fonts' bitmaps are used in place*/
+    return lv_font_get_glyph_bitmap(font_ref, letter) == lv_font_get_glyph_bitmap(font, letter);
+}
+
+/**
+ * Get the letter of a slot of the fast index
+ */
+static uint32_t fast_letter(uint32_t slot)
+{
+    return slot < LV_FONT_FMT_TXT_FAST_CNT - 1 ? 0x20 + slot : FAST_DEGREE_SIGN;
+}
+
+#endif /*LV_FONT_FMT_TXT_FAST_INDEX && LV_FONT_MONTSERRAT_16*/
+
+#endif /*LV_BUILD_TEST*/
@@ -0,0 +1,594 @@
+/**
+ * @file lv_test_font_loader.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../../lvgl.h"
+#include "../lv_test_assert.h"
+#include "lv_test_font_loader.h"
+
+#if LV_BUILD_TEST
+#include <stdlib.h>
+#include <string.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define BIN_BUF_SIZE        (32 * 1024)
+#define HEAD_LENGTH         48
+#define CMAP_SUBTABLE_SIZE  16
+
+/*Size of `gylph_bitmap` in lv_font_montserrat_28_compressed.c.
+ *The end of the last compressed bitmap can't be found from the glyph descriptors.*/
+#define MONTSERRAT_28_COMPRESSED_BITMAP_SIZE    17099
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/*Where the tables of a serialized font start*/
+typedef struct {
+    uint32_t cmap;
+    uint32_t loca;
+    uint32_t glyf;
+    uint32_t kern;
+    uint32_t size;
+    uint32_t glyph_cnt;
+    uint32_t glyph_header_bits;
+} bin_layout_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+#if LV_USE_FONT_LOADER && LV_FONT_MONTSERRAT_16 && LV_FONT_MONTSERRAT_28_COMPRESSED
+static void valid_font(void);
+static void invalid_tables(void);
+static void rle_overrun(void);
+static bool same_glyphs(const lv_font_t * ref, const lv_font_t * font);
+static lv_font_t * load_copy(uint32_t size, uint8_t ** copy);
+static void assert_invalid(uint32_t size, const char * s);
+static void serialize(const lv_font_t * font, uint32_t bitmap_size, bin_layout_t * layout);
+static uint32_t glyph_count(const lv_font_fmt_txt_dsc_t * dsc);
+static void put_u8(uint32_t v);
+static void put_u16(uint32_t v);
+static void put_u32(uint32_t v);
+static void put_label(const char * label);
+static void put_align4(void);
+static void set_u16(uint32_t pos, uint32_t v);
+static void set_u32(uint32_t pos, uint32_t v);
+static uint32_t get_u32(uint32_t pos);
+static void put_bits(uint8_t * out, uint32_t * bit_pos, uint32_t v, uint8_t len);
+static uint8_t unsigned_bits(uint32_t v);
+static uint8_t signed_bits(int32_t v);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+#if LV_USE_FONT_LOADER && LV_FONT_MONTSERRAT_16 && LV_FONT_MONTSERRAT_28_COMPRESSED
+static uint8_t bin_buf[BIN_BUF_SIZE];
+static uint32_t bin_pos;
+#endif
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_font_loader(void)
+{
+    lv_test_print("");
+    lv_test_print("==========================");
+    lv_test_print("Start lv_font_loader tests");
+    lv_test_print("==========================");
+
+#if LV_USE_FONT_LOADER && LV_FONT_MONTSERRAT_16 && LV_FONT_MONTSERRAT_28_COMPRESSED
+    valid_font();
+    invalid_tables();
+    rle_overrun();
+#else
+    lv_test_print("Skip the font loader tests: requires LV_USE_FONT_LOADER, LV_FONT_MONTSERRAT_16 and "
+                  "LV_FONT_MONTSERRAT_28_COMPRESSED");
+#endif
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+#if LV_USE_FONT_LOADER && LV_FONT_MONTSERRAT_16 && LV_FONT_MONTSERRAT_28_COMPRESSED
+
+static void valid_font(void)
+{
+    lv_test_print("");
+    lv_test_print("Load the built-in fonts from the binary format:");
+    lv_test_print("-----------------------------------------------");
+
+    bin_layout_t layout;
+    uint8_t * copy;
+
+    serialize(&lv_font_montserrat_16, 0, &layout);
+    lv_font_t * font = load_copy(layout.size, &copy);
+    lv_test_assert_int_eq(1, font != NULL, "Plain font loaded");
+    if(font) {
+        lv_test_assert_int_eq(lv_font_montserrat_16.line_height, font->line_height, "Line height");
+        lv_test_assert_int_eq(lv_font_montserrat_16.base_line, font->base_line, "Base line");
+        lv_test_assert_int_eq(1, same_glyphs(&lv_font_montserrat_16, font), "Same glyphs and kerning as the C font");
+        lv_font_free_bin(font);
+    }
+    free(copy);
+
+    serialize(&lv_font_montserrat_28_compressed, MONTSERRAT_28_COMPRESSED_BITMAP_SIZE, &layout);
+    font = load_copy(layout.size, &copy);
+    lv_test_assert_int_eq(1, font != NULL, "Compressed font loaded");
+    if(font) {
+        lv_test_assert_int_eq(1, same_glyphs(&lv_font_montserrat_28_compressed, font),
+                              "Same glyphs and kerning as the compressed C font");
+        lv_font_free_bin(font);
+    }
+    free(copy);
+
+    /*An invalid kerning table is ignored*/
+    serialize(&lv_font_montserrat_16, 0, &layout);
+    set_u16(layout.kern + 12, layout.glyph_cnt - 1);
+    font = load_copy(layout.size, &copy);
+    lv_test_assert_int_eq(1, font != NULL, "Loaded without the invalid kerning");
+    if(font) {
+        lv_test_assert_int_eq(1, ((lv_font_fmt_txt_dsc_t *)font->dsc)->kern_dsc == NULL, "No kerning");
+        lv_font_free_bin(font);
+    }
+    free(copy);
+}
+
+static void invalid_tables(void)
+{
+    lv_test_print("");
+    lv_test_print("Reject truncated and corrupt fonts:");
+    lv_test_print("-----------------------------------");
+
+    lv_mem_monitor_t mon_start;
+    lv_mem_defrag();
+    lv_mem_monitor(&mon_start);
+
+    bin_layout_t layout;
+    serialize(&lv_font_montserrat_16, 0, &layout);
+    uint32_t glyf_length = get_u32(layout.glyf);
+
+    /*Cut in every table*/
+    assert_invalid(0, "Empty");
+    assert_invalid(HEAD_LENGTH - 1, "Truncated head");
+    assert_invalid(layout.cmap + 12, "Truncated cmap");
+    assert_invalid(layout.loca + 12, "Truncated loca");
+    assert_invalid(layout.glyf + 8, "Truncated glyf");
+    assert_invalid(layout.kern - 1, "Last glyph truncated");
+
+    /*Counts*/
+    serialize(&lv_font_montserrat_16, 0, &layout);
+    set_u32(layout.cmap + 8, 1000);
+    assert_invalid(layout.size, "Too many character maps");
+
+    serialize(&lv_font_montserrat_16, 0, &layout);
+    set_u32(layout.loca + 8, 0);
+    assert_invalid(layout.size, "No glyphs");
+
+    serialize(&lv_font_montserrat_16, 0, &layout);
+    set_u32(layout.loca + 8, layout.glyph_cnt + 1);
+    assert_invalid(layout.size, "More glyphs than offsets");
+
+    serialize(&lv_font_montserrat_16, 0, &layout);
+    bin_buf[8 + 29] = 5;
+    assert_invalid(layout.size, "Invalid bpp");
+
+    /*Offsets and lengths past the data*/
+    serialize(&lv_font_montserrat_16, 0, &layout);
+    set_u32(layout.cmap, layout.size);
+    assert_invalid(layout.size, "cmap longer than the data");
+
+    serialize(&lv_font_montserrat_16, 0, &layout);
+    set_u32(layout.glyf, layout.size - layout.glyf + 1);
+    assert_invalid(layout.size, "glyf longer than the data");
+
+    serialize(&lv_font_montserrat_16, 0, &layout);
+    set_u32(layout.loca + 12 + 5 * 4, glyf_length + 100);
+    assert_invalid(layout.size, "Glyph offset past glyf");
+
+    serialize(&lv_font_montserrat_16, 0, &layout);
+    uint32_t ofs_5 = get_u32(layout.loca + 12 + 5 * 4);
+    set_u32(layout.loca + 12 + 5 * 4, get_u32(layout.loca + 12 + 6 * 4));
+    set_u32(layout.loca + 12 + 6 * 4, ofs_5);
+    assert_invalid(layout.size, "Glyph offsets out of order");
+
+    serialize(&lv_font_montserrat_16, 0, &layout);
+    set_u32(layout.cmap + 12 + CMAP_SUBTABLE_SIZE, 0xFFFFFF00);
+    assert_invalid(layout.size, "Letter list past cmap");
+
+    serialize(&lv_font_montserrat_16, 0, &layout);
+    set_u16(layout.cmap + 12 + 10, layout.glyph_cnt);
+    assert_invalid(layout.size, "Glyph ids past the glyphs");
+
+    /*Character maps the search can't use*/
+    serialize(&lv_font_montserrat_16, 0, &layout);
+    uint8_t sub[CMAP_SUBTABLE_SIZE];
+    memcpy(sub, &bin_buf[layout.cmap + 12], CMAP_SUBTABLE_SIZE);
+    memcpy(&bin_buf[layout.cmap + 12], &bin_buf[layout.cmap + 12 + CMAP_SUBTABLE_SIZE], CMAP_SUBTABLE_SIZE);
+    memcpy(&bin_buf[layout.cmap + 12 + CMAP_SUBTABLE_SIZE], sub, CMAP_SUBTABLE_SIZE);
+    assert_invalid(layout.size, "Ranges out of order");
+
+    serialize(&lv_font_montserrat_16, 0, &layout);
+    set_u32(layout.cmap + 12 + CMAP_SUBTABLE_SIZE + 4, 0x20 + 10);
+    assert_invalid(layout.size, "Overlapping ranges");
+
+    serialize(&lv_font_montserrat_16, 0, &layout);
+    uint32_t list = layout.cmap + get_u32(layout.cmap + 12 + CMAP_SUBTABLE_SIZE);
+    uint8_t tmp[2];
+    memcpy(tmp, &bin_buf[list], 2);
+    memcpy(&bin_buf[list], &bin_buf[list + 2], 2);
+    memcpy(&bin_buf[list + 2], tmp, 2);
+    assert_invalid(layout.size, "Letter list out of order");
+
+    lv_mem_monitor_t mon_end;
+    lv_mem_defrag();
+    lv_mem_monitor(&mon_end);
+    lv_test_assert_int_eq(mon_start.free_size, mon_end.free_size, "The rejected fonts are freed");
+}
+
+static void rle_overrun(void)
+{
+    lv_test_print("");
+    lv_test_print("Stop at the end of a compressed glyph:");
+    lv_test_print("--------------------------------------");
+
+    bin_layout_t layout;
+    serialize(&lv_font_montserrat_28_compressed, MONTSERRAT_28_COMPRESSED_BITMAP_SIZE, &layout);
+
+    /*The glyphs are ordered by the letters so the last glyph is the highest letter*/
+    uint32_t last_letter = 0xFFFF;
+    lv_font_glyph_dsc_t g;
+    while(!lv_font_get_glyph_dsc(&lv_font_montserrat_28_compressed, &g, last_letter, 0)) last_letter--;
+
+    /*Leave only 1 byte for the bitmap of the last glyph and drop the kerning after it*/
+    uint32_t last_ofs = get_u32(layout.loca + 12 + (layout.glyph_cnt - 1) * 4);
+    uint32_t glyf_length = last_ofs + (layout.glyph_header_bits + 7) / 8 + 1;
+    set_u32(layout.glyf, glyf_length);
+
+    uint8_t * copy;
+    lv_font_t * font = load_copy(layout.glyf + glyf_length, &copy);
+    lv_test_assert_int_eq(1, font != NULL, "Loaded, the bitmaps are checked when drawn");
+    if(font) {
+        lv_test_assert_int_eq(1, lv_font_get_glyph_dsc(font, &g, last_letter, 0), "Glyph found");
+        lv_test_assert_ptr_eq(NULL, lv_font_get_glyph_bitmap(font, last_letter), "Overrunning bitmap not drawn");
+        lv_test_assert_int_eq(1, lv_font_get_glyph_bitmap(font, 'A') != NULL, "Other glyphs drawn");
+        lv_font_free_bin(font);
+    }
+    free(copy);
+}
+
+/**
+ * Compare the glyphs of two fonts
+ * @param ref the C font
+ * @param font the loaded font
+ * @return true: the glyphs, bitmaps and kerning values are the same
+ */
+static bool same_glyphs(const lv_font_t * ref, const lv_font_t * font)
+{
+    static uint8_t ref_bitmap[64 * 64];
+    uint32_t letter;
+    for(letter = 0x20; letter < 0x10000; letter++) {
+        lv_font_glyph_dsc_t g_ref;
+        lv_font_glyph_dsc_t g;
+        bool found_ref = lv_font_get_glyph_dsc(ref, &g_ref, letter, 0);
+        bool found = lv_font_get_glyph_dsc(font, &g, letter, 0);
+        if(found_ref != found) return false;
+        if(!found) continue;
+        if(g_ref.adv_w != g.adv_w || g_ref.box_w != g.box_w || g_ref.box_h != g.box_h || g_ref.ofs_x != g.ofs_x ||
+           g_ref.ofs_y != g.ofs_y || g_ref.bpp != g.bpp) {
+            return false;
+        }
+
+        /*The bitmaps of the compressed glyphs are decompressed to a shared buffer*/
+        uint32_t bitmap_size = (g.box_w * g.box_h * (g.bpp == 3 ? 4 : g.bpp) + 7) / 8;
+        if(bitmap_size == 0) continue;
+        if(bitmap_size > sizeof(ref_bitmap)) return false;
+        const uint8_t * bitmap_ref = lv_font_get_glyph_bitmap(ref, letter);
+        if(bitmap_ref) memcpy(ref_bitmap, bitmap_ref, bitmap_size);
+        const uint8_t * bitmap = lv_font_get_glyph_bitmap(font, letter);
+        if((bitmap_ref == NULL) != (bitmap == NULL)) return false;
+        if(bitmap && memcmp(ref_bitmap, bitmap, bitmap_size) != 0) return false;
+    }
+
+    /*Kerning of the ASCII letters*/
+    uint32_t next;
+    for(letter = 0x20; letter < 0x7F; letter++) {
+        for(next = 0x20; next < 0x7F; next++) {
+            lv_font_glyph_dsc_t g_ref;
+            lv_font_glyph_dsc_t g;
+            lv_font_get_glyph_dsc(ref, &g_ref, letter, next);
+            lv_font_get_glyph_dsc(font, &g, letter, next);
+            if(g_ref.adv_w != g.adv_w) return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Load the first bytes of the serialized font from an allocation of exactly that size
+ * @param size number of bytes to load
+ * @param copy store the allocation here, free it after the font
+ * @return the loaded font or NULL
+ */
+static lv_font_t * load_copy(uint32_t size, uint8_t ** copy)
+{
+    *copy = malloc(size ? size : 1);
+    memcpy(*copy, bin_buf, size);
+    return lv_font_load_bin(*copy, size);
+}
+
+static void assert_invalid(uint32_t size, const char * s)
+{
+    uint8_t * copy;
+    lv_font_t * font = load_copy(size, &copy);
+    lv_test_assert_ptr_eq(NULL, font, s);
+    if(font) lv_font_free_bin(font);
+    free(copy);
+}
+
+/**
+ * Write a C font in the binary format of lv_font_conv to `bin_buf`.
+ * The glyph headers are bit packed with the bitmaps after them, the kerning is stored with classes.
+ * @param font a font in the `fmt_txt` format with class kerning
+ * @param bitmap_size size of the bitmaps of a compressed font, the end of the last one isn't known.
+ * 0 for a plain font.
+ * @param layout store the positions of the tables here
+ */
+static void serialize(const lv_font_t * font, uint32_t bitmap_size, bin_layout_t * layout)
+{
+    const lv_font_fmt_txt_dsc_t * dsc = font->dsc;
+    uint32_t glyph_cnt = glyph_count(dsc);
+
+    uint8_t xy_bits = 1;
+    uint8_t wh_bits = 1;
+    uint8_t adv_bits = 1;
+    uint32_t i;
+    for(i = 1; i < glyph_cnt; i++) {
+        const lv_font_fmt_txt_glyph_dsc_t * g = &dsc->glyph_dsc[i];
+        xy_bits = LV_MATH_MAX(xy_bits, LV_MATH_MAX(signed_bits(g->ofs_x), signed_bits(g->ofs_y)));
+        wh_bits = LV_MATH_MAX(wh_bits, LV_MATH_MAX(unsigned_bits(g->box_w), unsigned_bits(g->box_h)));
+        adv_bits = LV_MATH_MAX(adv_bits, unsigned_bits(g->adv_w));
+    }
+
+    memset(bin_buf, 0, sizeof(bin_buf));
+    bin_pos = 0;
+
+    /*head: version, table count, font size, ascent, descent, typo values, underline*/
+    put_u32(HEAD_LENGTH);
+    put_label("head");
+    put_u32(1);
+    put_u16(4);
+    put_u16(font->line_height);
+    put_u16(font->line_height - font->base_line);
+    put_u16(-font->base_line);
+    for(i = 0; i < 6; i++) put_u16(0);
+    put_u16(dsc->kern_scale);
+    put_u8(1);      /*32 bit glyph offsets*/
+    put_u8(1);      /*16 bit glyph ids*/
+    put_u8(1);      /*Advance width with 4 bits fraction*/
+    put_u8(dsc->bpp);
+    put_u8(xy_bits);
+    put_u8(wh_bits);
+    put_u8(adv_bits);
+    put_u8(dsc->bitmap_format);
+    put_u8(font->subpx);
+    put_u8(0);
+    put_u16(0);
+    put_u16(0);
+
+    /*cmap: the subtables then their lists*/
+    layout->cmap = bin_pos;
+    put_u32(0);
+    put_label("cmap");
+    put_u32(dsc->cmap_num);
+    uint32_t sub_pos = bin_pos;
+    bin_pos += CMAP_SUBTABLE_SIZE * dsc->cmap_num;
+    for(i = 0; i < dsc->cmap_num; i++) {
+        const lv_font_fmt_txt_cmap_t * cmap = &dsc->cmaps[i];
+        put_align4();
+        uint32_t data_ofs = cmap->type == LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY ? 0 : bin_pos - layout->cmap;
+        uint32_t k;
+        if(cmap->type == LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL) {
+            const uint8_t * ofs_list = cmap->glyph_id_ofs_list;
+            for(k = 0; k < cmap->list_length; k++) put_u8(ofs_list[k]);
+        }
+        if(cmap->unicode_list) {
+            for(k = 0; k < cmap->list_length; k++) put_u16(cmap->unicode_list[k]);
+        }
+        if(cmap->type == LV_FONT_FMT_TXT_CMAP_SPARSE_FULL) {
+            const uint16_t * ofs_list = cmap->glyph_id_ofs_list;
+            for(k = 0; k < cmap->list_length; k++) put_u16(ofs_list[k]);
+        }
+
+        uint32_t list_end = bin_pos;
+        bin_pos = sub_pos + CMAP_SUBTABLE_SIZE * i;
+        put_u32(data_ofs);
+        put_u32(cmap->range_start);
+        put_u16(cmap->range_length);
+        put_u16(cmap->glyph_id_start);
+        put_u16(cmap->list_length);
+        put_u8(cmap->type);
+        put_u8(0);
+        bin_pos = list_end;
+    }
+    put_align4();
+    set_u32(layout->cmap, bin_pos - layout->cmap);
+
+    /*loca: the offsets are written with the glyphs*/
+    layout->loca = bin_pos;
+    put_u32(0);
+    put_label("loca");
+    put_u32(glyph_cnt);
+    uint32_t offsets_pos = bin_pos;
+    bin_pos += 4 * glyph_cnt;
+    set_u32(layout->loca, bin_pos - layout->loca);
+
+    /*glyf: bit packed header and bitmap of every glyph, glyph 0 is empty*/
+    layout->glyf = bin_pos;
+    put_u32(0);
+    put_label("glyf");
+    uint8_t header_bits = adv_bits + 2 * xy_bits + 2 * wh_bits;
+    for(i = 0; i < glyph_cnt; i++) {
+        set_u32(offsets_pos + 4 * i, bin_pos - layout->glyf);
+        if(i == 0) continue;
+
+        const lv_font_fmt_txt_glyph_dsc_t * g = &dsc->glyph_dsc[i];
+        uint32_t bitmap_bits;
+        if(dsc->bitmap_format == LV_FONT_FMT_TXT_PLAIN) {
+            bitmap_bits = g->box_w * g->box_h * dsc->bpp;
+        }
+        else {
+            uint32_t next = i + 1 < glyph_cnt ? dsc->glyph_dsc[i + 1].bitmap_index : bitmap_size;
+            bitmap_bits = (next - g->bitmap_index) * 8;
+        }
+
+        uint8_t * out = &bin_buf[bin_pos];
+        uint32_t bit_pos = 0;
+        put_bits(out, &bit_pos, g->adv_w, adv_bits);
+        put_bits(out, &bit_pos, (uint32_t)g->ofs_x, xy_bits);
+        put_bits(out, &bit_pos, (uint32_t)g->ofs_y, xy_bits);
+        put_bits(out, &bit_pos, g->box_w, wh_bits);
+        put_bits(out, &bit_pos, g->box_h, wh_bits);
+        const uint8_t * bitmap = &dsc->glyph_bitmap[g->bitmap_index];
+        uint32_t b;
+        for(b = 0; b < bitmap_bits; b++) put_bits(out, &bit_pos, bitmap[b >> 3] >> (7 - (b & 0x7)), 1);
+        bin_pos += (bit_pos + 7) / 8;
+    }
+    put_align4();
+    set_u32(layout->glyf, bin_pos - layout->glyf);
+
+    /*kern: format 3, classes*/
+    layout->kern = bin_pos;
+    if(dsc->kern_dsc && dsc->kern_classes) {
+        const lv_font_fmt_txt_kern_classes_t * kern = dsc->kern_dsc;
+        put_u32(0);
+        put_label("kern");
+        put_u8(3);
+        put_u8(0);
+        put_u16(0);
+        put_u16(glyph_cnt);
+        put_u8(kern->left_class_cnt);
+        put_u8(kern->right_class_cnt);
+        for(i = 0; i < glyph_cnt; i++) put_u8(kern->left_class_mapping[i]);
+        for(i = 0; i < glyph_cnt; i++) put_u8(kern->right_class_mapping[i]);
+        for(i = 0; i < (uint32_t)kern->left_class_cnt * kern->right_class_cnt; i++) put_u8(kern->class_pair_values[i]);
+        put_align4();
+        set_u32(layout->kern, bin_pos - layout->kern);
+    }
+
+    layout->size = bin_pos;
+    layout->glyph_cnt = glyph_cnt;
+    layout->glyph_header_bits = header_bits;
+}
+
+/**
+ * Get the number of glyphs of a C font from its character maps
+ * @param dsc pointer to the font's descriptor
+ * @return the highest glyph id + 1
+ */
+static uint32_t glyph_count(const lv_font_fmt_txt_dsc_t * dsc)
+{
+    uint32_t max = 0;
+    uint32_t i;
+    for(i = 0; i < dsc->cmap_num; i++) {
+        const lv_font_fmt_txt_cmap_t * cmap = &dsc->cmaps[i];
+        uint32_t n = cmap->list_length ? cmap->list_length : cmap->range_length;
+        uint32_t last = cmap->glyph_id_start + n - 1;
+        uint32_t k;
+        for(k = 0; cmap->glyph_id_ofs_list && k < n; k++) {
+            uint32_t ofs = cmap->type == LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL ?
+                           ((const uint8_t *)cmap->glyph_id_ofs_list)[k] : ((const uint16_t *)cmap->glyph_id_ofs_list)[k];
+            last = LV_MATH_MAX(last, cmap->glyph_id_start + ofs);
+        }
+        max = LV_MATH_MAX(max, last);
+    }
+    return max + 1;
+}
+
+static void put_u8(uint32_t v)
+{
+    bin_buf[bin_pos++] = (uint8_t)v;
+}
+
+static void put_u16(uint32_t v)
+{
+    put_u8(v & 0xFF);
+    put_u8((v >> 8) & 0xFF);
+}
+
+static void put_u32(uint32_t v)
+{
+    put_u16(v & 0xFFFF);
+    put_u16(v >> 16);
+}
+
+static void put_label(const char * label)
+{
+    memcpy(&bin_buf[bin_pos], label, 4);
+    bin_pos += 4;
+}
+
+static void put_align4(void)
+{
+    while(bin_pos & 0x3) put_u8(0);
+}
+
+static void set_u16(uint32_t pos, uint32_t v)
+{
+    bin_buf[pos] = v & 0xFF;
+    bin_buf[pos + 1] = (v >> 8) & 0xFF;
+}
+
+static void set_u32(uint32_t pos, uint32_t v)
+{
+    set_u16(pos, v & 0xFFFF);
+    set_u16(pos + 2, v >> 16);
+}
+
+static uint32_t get_u32(uint32_t pos)
+{
+    return (uint32_t)bin_buf[pos] | ((uint32_t)bin_buf[pos + 1] << 8) | ((uint32_t)bin_buf[pos + 2] << 16) |
+           ((uint32_t)bin_buf[pos + 3] << 24);
+}
+
+/**
+ * Write the lower `len` bits of a value to a bit stream, MSB first
+ */
+static void put_bits(uint8_t * out, uint32_t * bit_pos, uint32_t v, uint8_t len)
+{
+    int32_t i;
+    for(i = len - 1; i >= 0; i--) {
+        if((v >> i) & 0x1) out[*bit_pos >> 3] |= 0x80 >> (*bit_pos & 0x7);
+        (*bit_pos)++;
+    }
+}
+
+static uint8_t unsigned_bits(uint32_t v)
+{
+    uint8_t n = 0;
+    while(v >> n) n++;
+    return n;
+}
+
+static uint8_t signed_bits(int32_t v)
+{
+    uint8_t n = 1;
+    while(v < -(1 << (n - 1)) || v >= (1 << (n - 1))) n++;
+    return n;
+}
+
+#endif /*LV_USE_FONT_LOADER && LV_FONT_MONTSERRAT_16 && LV_FONT_MONTSERRAT_28_COMPRESSED*/
+
+#endif /*LV_BUILD_TEST*/
@@ -0,0 +1,396 @@
+/**
+ * @file lv_test_glyph_cache.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../../lvgl.h"
+#include "../lv_test_assert.h"
+#include "lv_test_glyph_cache.h"
+
+#if LV_BUILD_TEST
+#include <string.h>
+#include <time.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define BENCH_ROUNDS    1000
+#define BENCH_REPEAT    5
+#define BENCH_W         320
+#define BENCH_H         40
+
+/*The glyphs of the test fonts with random pixels*/
+#define TEST_GLYPH_W    7
+#define TEST_GLYPH_H    9
+#define TEST_GLYPH_CNT  8
+#define TEST_CANVAS_W   ((TEST_GLYPH_W + 1) * TEST_GLYPH_CNT)
+#define TEST_CANVAS_H   (TEST_GLYPH_H + 2)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+#if LV_FONT_FMT_TXT_CACHE_CNT && LV_FONT_MONTSERRAT_16 && LV_FONT_MONTSERRAT_28
+static void lru(void);
+static void budget(void);
+static void invalidate(void);
+static void a8(void);
+static void test_font_init(lv_font_t * font, lv_font_fmt_txt_dsc_t * dsc, uint8_t bpp);
+static bool raw_glyph_dsc(const lv_font_t * font, lv_font_glyph_dsc_t * dsc_out, uint32_t letter, uint32_t letter_next);
+static const uint8_t * raw_glyph_bitmap(const lv_font_t * font, uint32_t letter);
+static void draw_text(lv_obj_t * canvas, const lv_font_t * font, const char * txt);
+#endif
+#if LV_USE_CANVAS && LV_FONT_MONTSERRAT_16 && LV_FONT_MONTSERRAT_28_COMPRESSED
+static uint32_t bench(const lv_font_t * font);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+#if LV_FONT_FMT_TXT_CACHE_CNT && LV_FONT_MONTSERRAT_16 && LV_FONT_MONTSERRAT_28
+static uint8_t test_bitmap[TEST_GLYPH_CNT * TEST_GLYPH_W * TEST_GLYPH_H];
+static lv_font_fmt_txt_glyph_dsc_t test_glyph_dsc[TEST_GLYPH_CNT + 1];
+static lv_font_fmt_txt_cmap_t test_cmap;
+#endif
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_test_glyph_cache(void)
+{
+    lv_test_print("");
+    lv_test_print("===============================");
+    lv_test_print("Start lv_font glyph cache tests");
+    lv_test_print("===============================");
+
+#if LV_FONT_FMT_TXT_CACHE_CNT && LV_FONT_MONTSERRAT_16 && LV_FONT_MONTSERRAT_28
+    lru();
+    budget();
+    invalidate();
+    a8();
+#else
+    lv_test_print("Skip the glyph cache tests: requires LV_FONT_FMT_TXT_CACHE_CNT, LV_FONT_MONTSERRAT_16 and "
+                  "LV_FONT_MONTSERRAT_28");
+#endif
+
+#if LV_USE_CANVAS && LV_FONT_MONTSERRAT_16 && LV_FONT_MONTSERRAT_28_COMPRESSED
+    /*Run in the configurations with and without the cache to compare them*/
+    uint32_t plain_us = bench(&lv_font_montserrat_16);
+    uint32_t compressed_us = bench(&lv_font_montserrat_28_compressed);
+    lv_test_print("   %d rounds of a label with the glyph cache %s: %d us montserrat 16, %d us montserrat 28 compressed",
+                  BENCH_ROUNDS, LV_FONT_FMT_TXT_CACHE_CNT ? "enabled" : "disabled", plain_us, compressed_us);
+#endif
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+#if LV_FONT_FMT_TXT_CACHE_CNT && LV_FONT_MONTSERRAT_16 && LV_FONT_MONTSERRAT_28
+
+static void lru(void)
+{
+    lv_test_print("");
+    lv_test_print("Drop the least recently used glyph:");
+    lv_test_print("-----------------------------------");
+
+    lv_font_fmt_txt_cache_invalidate(NULL);
+
+    /*Letters without a glyph don't take the place of the cached ones*/
+    const lv_font_t * font = &lv_font_montserrat_16;
+    lv_font_glyph_dsc_t g;
+    lv_font_get_glyph_dsc(font, &g, 0x10FFFF, 0);
+    lv_font_fmt_txt_cache_info_t info_start;
+    lv_font_fmt_txt_cache_get_info(&info_start);
+    lv_test_assert_int_eq(0, info_start.glyph_cnt, "Missing letter not cached");
+
+    uint32_t i;
+    for(i = 0; i < LV_FONT_FMT_TXT_CACHE_CNT; i++) lv_font_get_glyph_dsc(font, &g, 0x21 + i, 0);
+
+    lv_font_fmt_txt_cache_info_t info;
+    lv_font_fmt_txt_cache_get_info(&info);
+    lv_test_assert_int_eq(LV_FONT_FMT_TXT_CACHE_CNT, info.glyph_cnt, "Cache filled");
+
+    /*The first letter becomes the most recently used so the second is dropped for a new letter*/
+    lv_font_get_glyph_dsc(font, &g, 0x21, 0);
+    lv_font_get_glyph_dsc(font, &g, 0x21 + LV_FONT_FMT_TXT_CACHE_CNT, 0);
+    lv_font_fmt_txt_cache_get_info(&info);
+    lv_test_assert_int_eq(1, info.hit_cnt - info_start.hit_cnt, "Used letter found");
+    lv_test_assert_int_eq(LV_FONT_FMT_TXT_CACHE_CNT + 1, info.miss_cnt - info_start.miss_cnt, "New letter added");
+    lv_test_assert_int_eq(LV_FONT_FMT_TXT_CACHE_CNT, info.glyph_cnt, "Number of glyphs limited");
+
+    lv_font_get_glyph_dsc(font, &g, 0x21, 0);
+    lv_font_get_glyph_dsc(font, &g, 0x23, 0);
+    lv_font_fmt_txt_cache_get_info(&info);
+    lv_test_assert_int_eq(3, info.hit_cnt - info_start.hit_cnt, "Recently used letters kept");
+
+    lv_font_get_glyph_dsc(font, &g, 0x22, 0);
+    lv_font_fmt_txt_cache_get_info(&info);
+    lv_test_assert_int_eq(LV_FONT_FMT_TXT_CACHE_CNT + 2, info.miss_cnt - info_start.miss_cnt,
+                          "Least recently used letter dropped");
+
+    lv_font_fmt_txt_cache_invalidate(NULL);
+}
+
+static void budget(void)
+{
+    lv_test_print("");
+    lv_test_print("Keep the bitmaps in the budget:");
+    lv_test_print("-------------------------------");
+
+    lv_font_fmt_txt_cache_invalidate(NULL);
+
+    const lv_font_t * font = &lv_font_montserrat_28;
+    static const char letters[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+    uint32_t letter_cnt = sizeof(letters) - 1;
+    uint32_t px_num[sizeof(letters) - 1];
+    bool in_budget = true;
+    uint32_t i;
+    for(i = 0; i < letter_cnt; i++) {
+        lv_font_glyph_dsc_t g;
+        lv_font_get_glyph_dsc(font, &g, letters[i], 0);
+        lv_font_get_glyph_bitmap(font, letters[i]);
+        px_num[i] = g.box_w * g.box_h;
+
+        lv_font_fmt_txt_cache_info_t info;
+        lv_font_fmt_txt_cache_get_info(&info);
+        if(info.mem_size > LV_FONT_FMT_TXT_CACHE_SIZE) in_budget = false;
+    }
+    lv_test_assert_int_eq(1, in_budget, "Bitmaps in LV_FONT_FMT_TXT_CACHE_SIZE");
+
+    /*The most recent letters are kept which fit in both limits*/
+    uint32_t mem_size = 0;
+    uint32_t glyph_cnt = 0;
+    for(i = letter_cnt; i > 0 && glyph_cnt < LV_FONT_FMT_TXT_CACHE_CNT; i--) {
+        if(mem_size + px_num[i - 1] > LV_FONT_FMT_TXT_CACHE_SIZE) break;
+        mem_size += px_num[i - 1];
+        glyph_cnt++;
+    }
+
+    lv_font_fmt_txt_cache_info_t info;
+    lv_font_fmt_txt_cache_get_info(&info);
+    lv_test_assert_int_eq(mem_size, info.mem_size, "Size of the cached bitmaps");
+    lv_test_assert_int_eq(glyph_cnt, info.glyph_cnt, "Most recent letters kept");
+
+    lv_font_fmt_txt_cache_invalidate(NULL);
+}
+
+static void invalidate(void)
+{
+    lv_test_print("");
+    lv_test_print("Invalidate the glyphs of a font:");
+    lv_test_print("--------------------------------");
+
+    lv_font_fmt_txt_cache_invalidate(NULL);
+    lv_font_fmt_txt_cache_info_t info_start;
+    lv_font_fmt_txt_cache_get_info(&info_start);
+
+    lv_font_glyph_dsc_t g;
+    lv_font_get_glyph_dsc(&lv_font_montserrat_16, &g, 'A', 0);
+    lv_font_get_glyph_bitmap(&lv_font_montserrat_16, 'A');
+    lv_font_get_glyph_dsc(&lv_font_montserrat_28, &g, 'B', 0);
+    lv_font_get_glyph_bitmap(&lv_font_montserrat_28, 'B');
+    uint32_t b_size = g.box_w * g.box_h;
+
+    lv_font_fmt_txt_cache_info_t info;
+    lv_font_fmt_txt_cache_get_info(&info);
+    lv_test_assert_int_eq(2, info.miss_cnt - info_start.miss_cnt, "Misses");
+    lv_test_assert_int_eq(2, info.hit_cnt - info_start.hit_cnt, "Bitmaps of the found letters are hits");
+    lv_test_assert_int_eq(2, info.glyph_cnt, "Glyphs");
+
+    lv_font_fmt_txt_cache_invalidate(&lv_font_montserrat_16);
+    lv_font_fmt_txt_cache_get_info(&info);
+    lv_test_assert_int_eq(1, info.glyph_cnt, "Glyphs of the other fonts kept");
+    lv_test_assert_int_eq(b_size, info.mem_size, "Bitmap of the invalidated glyph freed");
+
+    lv_font_get_glyph_dsc(&lv_font_montserrat_16, &g, 'A', 0);
+    lv_font_fmt_txt_cache_get_info(&info);
+    lv_test_assert_int_eq(3, info.miss_cnt - info_start.miss_cnt, "Invalidated letter added again");
+
+    lv_font_fmt_txt_cache_invalidate(NULL);
+    lv_font_fmt_txt_cache_get_info(&info);
+    lv_test_assert_int_eq(0, info.glyph_cnt, "All glyphs invalidated");
+    lv_test_assert_int_eq(0, info.mem_size, "All bitmaps freed");
+}
+
+static void a8(void)
+{
+    lv_test_print("");
+    lv_test_print("Draw the cached A8 bitmaps the same as the font's bpp:");
+    lv_test_print("------------------------------------------------------");
+
+    uint32_t seed = 0x1234;
+    uint32_t i;
+    for(i = 0; i < sizeof(test_bitmap); i++) {
+        seed = seed * 1103515245 + 12345;
+        test_bitmap[i] = seed >> 16;
+    }
+
+    static lv_color_t buf_cached[LV_CANVAS_BUF_SIZE_TRUE_COLOR(TEST_CANVAS_W, TEST_CANVAS_H)];
+    static lv_color_t buf_raw[LV_CANVAS_BUF_SIZE_TRUE_COLOR(TEST_CANVAS_W, TEST_CANVAS_H)];
+    lv_obj_t * canvas = lv_canvas_create(lv_scr_act(), NULL);
+
+    static const uint8_t bpps[] = {1, 2, 4};
+    for(i = 0; i < sizeof(bpps); i++) {
+        lv_font_fmt_txt_dsc_t dsc;
+        lv_font_t font_cached;
+        test_font_init(&font_cached, &dsc, bpps[i]);
+
+        /*The same glyphs drawn from the font's bitmap*/
+        lv_font_t font_raw = font_cached;
+        font_raw.get_glyph_dsc = raw_glyph_dsc;
+        font_raw.get_glyph_bitmap = raw_glyph_bitmap;
+
+        lv_canvas_set_buffer(canvas, buf_cached, TEST_CANVAS_W, TEST_CANVAS_H, LV_IMG_CF_TRUE_COLOR);
+        draw_text(canvas, &font_cached, "ABCDEFGH");
+        lv_canvas_set_buffer(canvas, buf_raw, TEST_CANVAS_W, TEST_CANVAS_H, LV_IMG_CF_TRUE_COLOR);
+        draw_text(canvas, &font_raw, "ABCDEFGH");
+
+        lv_font_glyph_dsc_t g;
+        lv_font_get_glyph_dsc(&font_cached, &g, 'A', 0);
+        lv_test_assert_int_eq(8, g.bpp, "Cached as A8");
+
+        uint32_t px;
+        uint32_t drawn_cnt = 0;
+        for(px = 0; px < TEST_CANVAS_W * TEST_CANVAS_H; px++) {
+            if(buf_raw[px].full != LV_COLOR_WHITE.full) drawn_cnt++;
+        }
+        lv_test_assert_int_gt(TEST_CANVAS_W * TEST_CANVAS_H / 4, drawn_cnt, "Text drawn");
+
+        char s[64];
+        lv_snprintf(s, sizeof(s), "Same pixels as with %d bpp", bpps[i]);
+        lv_test_assert_int_eq(0, memcmp(buf_cached, buf_raw, sizeof(buf_cached)), s);
+
+        _lv_font_fmt_txt_release(&font_cached);
+        _lv_font_fmt_txt_release(&font_raw);
+    }
+
+    lv_obj_del(canvas);
+}
+
+/**
+ * Create a font with `TEST_GLYPH_CNT` glyphs for the letters from 'A' with the random pixels of `test_bitmap`
+ * @param font initialize this font
+ * @param dsc initialize this descriptor for the font
+ * @param bpp bit per pixel of the glyphs
+ */
+static void test_font_init(lv_font_t * font, lv_font_fmt_txt_dsc_t * dsc, uint8_t bpp)
+{
+    uint32_t glyph_size = (TEST_GLYPH_W * TEST_GLYPH_H * bpp + 7) / 8;
+    uint32_t i;
+    for(i = 1; i <= TEST_GLYPH_CNT; i++) {
+        lv_font_fmt_txt_glyph_dsc_t * g = &test_glyph_dsc[i];
+        g->bitmap_index = (i - 1) * glyph_size;
+        g->adv_w = (TEST_GLYPH_W + 1) * 16;
+        g->box_w = TEST_GLYPH_W;
+        g->box_h = TEST_GLYPH_H;
+        g->ofs_x = 0;
+        g->ofs_y = 0;
+    }
+
+    memset(&test_cmap, 0, sizeof(test_cmap));
+    test_cmap.range_start = 'A';
+    test_cmap.range_length = TEST_GLYPH_CNT;
+    test_cmap.glyph_id_start = 1;
+    test_cmap.type = LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY;
+
+    memset(dsc, 0, sizeof(lv_font_fmt_txt_dsc_t));
+    dsc->glyph_bitmap = test_bitmap;
+    dsc->glyph_dsc = test_glyph_dsc;
+    dsc->cmaps = &test_cmap;
+    dsc->cmap_num = 1;
+    dsc->bpp = bpp;
+    dsc->bitmap_format = LV_FONT_FMT_TXT_PLAIN;
+
+    memset(font, 0, sizeof(lv_font_t));
+    font->get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt;
+    font->get_glyph_bitmap = lv_font_get_bitmap_fmt_txt;
+    font->line_height = TEST_GLYPH_H;
+    font->base_line = 0;
+    font->dsc = dsc;
+}
+
+/**
+ * Get the glyph descriptor with the bpp of the font, like without the cache
+ */
+static bool raw_glyph_dsc(const lv_font_t * font, lv_font_glyph_dsc_t * dsc_out, uint32_t letter, uint32_t letter_next)
+{
+    if(!lv_font_get_glyph_dsc_fmt_txt(font, dsc_out, letter, letter_next)) return false;
+    dsc_out->bpp = ((const lv_font_fmt_txt_dsc_t *)font->dsc)->bpp;
+    return true;
+}
+
+/**
+ * Get the bitmap of a glyph of a test font from the font's data
+ */
+static const uint8_t * raw_glyph_bitmap(const lv_font_t * font, uint32_t letter)
+{
+    const lv_font_fmt_txt_dsc_t * dsc = font->dsc;
+    if(letter < 'A' || letter >= 'A' + TEST_GLYPH_CNT) return NULL;
+    return &dsc->glyph_bitmap[dsc->glyph_dsc[letter - 'A' + 1].bitmap_index];
+}
+
+static void draw_text(lv_obj_t * canvas, const lv_font_t * font, const char * txt)
+{
+    lv_canvas_fill_bg(canvas, LV_COLOR_WHITE, LV_OPA_COVER);
+
+    lv_draw_label_dsc_t label_dsc;
+    lv_draw_label_dsc_init(&label_dsc);
+    label_dsc.font = font;
+    label_dsc.color = LV_COLOR_BLACK;
+    lv_canvas_draw_text(canvas, 0, 1, TEST_CANVAS_W, &label_dsc, txt, LV_LABEL_ALIGN_LEFT);
+}
+
+#endif /*LV_FONT_FMT_TXT_CACHE_CNT && LV_FONT_MONTSERRAT_16 && LV_FONT_MONTSERRAT_28*/
+
+#if LV_USE_CANVAS && LV_FONT_MONTSERRAT_16 && LV_FONT_MONTSERRAT_28_COMPRESSED
+/**
+ * Draw a label `BENCH_ROUNDS` times, `BENCH_REPEAT` times over
+ * @param font the font of the label
+ * @return the elapsed time of the fastest repeat in microseconds
+ */
+static uint32_t bench(const lv_font_t * font)
+{
+    static lv_color_t buf[LV_CANVAS_BUF_SIZE_TRUE_COLOR(BENCH_W, BENCH_H)];
+    lv_obj_t * canvas = lv_canvas_create(lv_scr_act(), NULL);
+    lv_canvas_set_buffer(canvas, buf, BENCH_W, BENCH_H, LV_IMG_CF_TRUE_COLOR);
+    lv_canvas_fill_bg(canvas, LV_COLOR_WHITE, LV_OPA_COVER);
+
+    lv_draw_label_dsc_t label_dsc;
+    lv_draw_label_dsc_init(&label_dsc);
+    label_dsc.font = font;
+    label_dsc.color = LV_COLOR_BLACK;
+
+    /*The fastest of some runs to filter out the other processes*/
+    uint32_t min_us = UINT32_MAX;
+    uint32_t r;
+    for(r = 0; r < BENCH_REPEAT; r++) {
+        struct timespec start;
+        struct timespec end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        uint32_t i;
+        for(i = 0; i < BENCH_ROUNDS; i++) {
+            lv_canvas_draw_text(canvas, 0, 0, BENCH_W, &label_dsc, "Living room 21.5°C", LV_LABEL_ALIGN_LEFT);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        uint32_t us = (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_nsec - start.tv_nsec) / 1000;
+        if(us < min_us) min_us = us;
+    }
+
+    lv_obj_del(canvas);
+    return min_us;
+}
+#endif
+
+#endif /*LV_BUILD_TEST*/
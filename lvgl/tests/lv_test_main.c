@@ -3,6 +3,8 @@
 #include <stdlib.h>
 #include <sys/time.h>
 #include "lv_test_core/lv_test_core.h"
+#include "lv_test_draw/lv_test_draw.h"
+#include "lv_test_font/lv_test_font.h"
 
 #if LV_BUILD_TEST
 
@@ -17,6 +19,8 @@ int main(void)
     hal_init();
 
     lv_test_core();
+    lv_test_draw();
+    lv_test_font();
 
     printf("Exit with success!\n");
     return 0;
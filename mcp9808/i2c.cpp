@@ -0,0 +1,168 @@
+/**
+ * @file i2c.cpp
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <linux/i2c-dev.h>
+#include <sys/ioctl.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <syslog.h>
+#include <errno.h>
+#include <string.h>
+
+#include "i2c.h"
+
+//
+// Class I2cLinux
+//
+
+I2cLinux::I2cLinux(const char *bus) {
+	_bus = bus;
+	_fd = -1;
+	_open_failed = false;
+}
+
+I2cLinux::~I2cLinux() {
+	close();
+}
+
+bool I2cLinux::open(unsigned char address) {
+	if (_fd >= 0) return true;
+	_fd = ::open(_bus.c_str(), O_RDWR | O_CLOEXEC);
+	if (_fd < 0) {
+		// retried by the caller, report only the first failure
+		if (!_open_failed) {
+			syslog(LOG_ERR, "Failed to open I2C bus [%s]", _bus.c_str());
+			fprintf(stderr, "%s: Failed to open I2C bus [%s] \n", __func__, _bus.c_str());
+		}
+		_open_failed = true;
+		return false;
+	}
+	if (ioctl(_fd, I2C_SLAVE, address) < 0) {
+		if (!_open_failed) {
+			syslog(LOG_ERR, "Failed to select I2C address 0x%02x: %s", address, strerror(errno));
+		}
+		_open_failed = true;
+		close();
+		return false;
+	}
+	_open_failed = false;
+	return true;
+}
+
+void I2cLinux::close(void) {
+	if (_fd >= 0) {
+		::close(_fd);
+		_fd = -1;
+	}
+}
+
+bool I2cLinux::isOpen(void) {
+	return _fd >= 0;
+}
+
+int I2cLinux::write(const uint8_t *data, int length) {
+	return ::write(_fd, data, length);
+}
+
+int I2cLinux::read(uint8_t *data, int length) {
+	return ::read(_fd, data, length);
+}
+
+//
+// Class I2cFake
+//
+
+I2cFake::I2cFake(unsigned char address) {
+	_address = address;
+	_open = false;
+	_pointer = 0;
+	memset(_registers, 0, sizeof(_registers));
+	_file_reg = -1;
+	_file_scale = 1.0;
+}
+
+I2cFake::~I2cFake() {
+}
+
+bool I2cFake::open(unsigned char address) {
+	// no device at this address
+	if (address != _address) return false;
+	_open = true;
+	return true;
+}
+
+void I2cFake::close(void) {
+	_open = false;
+}
+
+bool I2cFake::isOpen(void) {
+	return _open;
+}
+
+/**
+ * The first byte selects the register, following bytes are written
+ * to the register MSB first (16 bit) or as the LSB only (8 bit)
+ */
+int I2cFake::write(const uint8_t *data, int length) {
+	if (!_open || (length < 1)) {
+		errno = EIO;
+		return -1;
+	}
+	_pointer = data[0] % I2C_FAKE_REGISTERS;
+	if (length == 2) {
+		_registers[_pointer] = data[1];
+	} else if (length >= 3) {
+		_registers[_pointer] = (data[1] << 8) | data[2];
+	}
+	return length;
+}
+
+/**
+ * Reads the register selected by the last write, MSB first
+ */
+int I2cFake::read(uint8_t *data, int length) {
+	if (!_open) {
+		errno = EIO;
+		return -1;
+	}
+	if (_pointer == _file_reg) {
+		loadRegisterFile();
+	}
+	uint16_t value = _registers[_pointer];
+	if (length == 1) {
+		data[0] = value & 0xFF;
+	} else if (length >= 2) {
+		data[0] = value >> 8;
+		data[1] = value & 0xFF;
+		length = 2;
+	}
+	return length;
+}
+
+void I2cFake::setRegister(uint8_t reg, uint16_t value) {
+	_registers[reg % I2C_FAKE_REGISTERS] = value;
+}
+
+uint16_t I2cFake::getRegister(uint8_t reg) {
+	return _registers[reg % I2C_FAKE_REGISTERS];
+}
+
+void I2cFake::setRegisterFile(uint8_t reg, const char *path, float scale) {
+	_file_reg = reg % I2C_FAKE_REGISTERS;
+	_file_path = path;
+	_file_scale = scale;
+}
+
+void I2cFake::loadRegisterFile(void) {
+	char buffer[32];
+	int fd = ::open(_file_path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) return;
+	int length = ::read(fd, buffer, sizeof(buffer) - 1);
+	::close(fd);
+	if (length <= 0) return;
+	buffer[length] = 0;
+	int value = (int) (strtof(buffer, NULL) * _file_scale);
+	_registers[_file_reg] = (uint16_t) value;
+}
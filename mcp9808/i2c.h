@@ -0,0 +1,125 @@
+/**
+ * @file i2c.h
+-----------------------------------------------------------------------------
+ I2C transport used by device classes (e.g. Mcp9808)
+
+ Class "I2cTransport" is the interface used by the device classes
+ Class "I2cLinux" accesses a Linux I2C bus device (/dev/i2c-N)
+ Class "I2cFake" simulates a register based device in memory, optionally
+ a register value can be loaded from a file on every read. It is used to
+ test and benchmark device classes without hardware.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef _I2C_H_
+#define _I2C_H_
+
+#include <stdint.h>
+
+#include <string>
+
+#define I2C_FAKE_REGISTERS 16       // number of 16 bit registers in the fake device
+
+class I2cTransport {
+public:
+    virtual ~I2cTransport() {}
+
+    /**
+     * Open the bus and select the slave device
+     * @param address: I2C address of the slave device
+     * @returns true on success
+     */
+    virtual bool open(unsigned char address) = 0;
+
+    /**
+     * Close the bus
+     */
+    virtual void close(void) = 0;
+
+    /**
+     * Check if the bus is open
+     */
+    virtual bool isOpen(void) = 0;
+
+    /**
+     * Write bytes to the device
+     * @returns number of bytes written or -1 on failure
+     */
+    virtual int write(const uint8_t *data, int length) = 0;
+
+    /**
+     * Read bytes from the device
+     * @returns number of bytes read or -1 on failure
+     */
+    virtual int read(uint8_t *data, int length) = 0;
+};
+
+class I2cLinux : public I2cTransport {
+public:
+    /**
+     * Constructor
+     * @param bus: I2C bus device path (e.g. /dev/i2c-1)
+     */
+    I2cLinux(const char *bus);
+    ~I2cLinux();
+
+    bool open(unsigned char address);
+    void close(void);
+    bool isOpen(void);
+    int write(const uint8_t *data, int length);
+    int read(uint8_t *data, int length);
+
+private:
+    std::string _bus;
+    int _fd;
+    bool _open_failed;          // the last open failed, reported once
+};
+
+class I2cFake : public I2cTransport {
+public:
+    /**
+     * Constructor
+     * @param address: I2C address the fake device responds to
+     */
+    I2cFake(unsigned char address);
+    ~I2cFake();
+
+    bool open(unsigned char address);
+    void close(void);
+    bool isOpen(void);
+    int write(const uint8_t *data, int length);
+    int read(uint8_t *data, int length);
+
+    /**
+     * Set a register value
+     */
+    void setRegister(uint8_t reg, uint16_t value);
+
+    /**
+     * Get a register value
+     */
+    uint16_t getRegister(uint8_t reg);
+
+    /**
+     * Load a register from a file on every read of this register
+     * The file contains a decimal value which is multiplied by scale,
+     * e.g. a temperature in DegC and a scale of 16 for the MCP9808
+     * @param reg: register number
+     * @param path: file path
+     * @param scale: multiplier applied to the file value
+     */
+    void setRegisterFile(uint8_t reg, const char *path, float scale);
+
+private:
+    void loadRegisterFile(void);
+
+    unsigned char _address;
+    bool _open;
+    uint8_t _pointer;               // register pointer
+    uint16_t _registers[I2C_FAKE_REGISTERS];
+    int _file_reg;                  // register backed by file, -1 = none
+    std::string _file_path;
+    float _file_scale;
+};
+
+#endif /* _I2C_H_ */
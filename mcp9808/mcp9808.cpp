@@ -11,10 +11,12 @@
 #include <syslog.h>
 #include <errno.h>
 #include <string.h>
+#include <time.h>
+
+#include <string>
 
 #include "mcp9808.h"
 
-#define MCP9808_DEFAULT_ADDRESS 0x18
 #define I2C_BUS "/dev/i2c-1"		// Raspberry Pi is /dev/i2c-1
 
 // uncomment below to enable debug output
@@ -23,79 +25,91 @@
 
 Mcp9808::Mcp9808() {
 	//fprintf(stderr, "%s: Base Constructor called\n", __func__);
-	init( MCP9808_DEFAULT_ADDRESS );
+	init(MCP9808_DEFAULT_ADDRESS, NULL);
 }
 
-Mcp9808::Mcp9808(const unsigned char address) {
+Mcp9808::Mcp9808(const unsigned char address, I2cTransport *transport) {
 	//fprintf(stderr, "%s: Para Constructor called\n", __func__);
-	init(address);
+	init(address, transport);
 }
 
 Mcp9808::~Mcp9808() {
     //fprintf(stderr, "%s: Destructor called\n", __func__);
-  	if (_i2c_bus_file >= 0) {
-		close(_i2c_bus_file);
-		_i2c_bus_file = -1;
+	stop();
+	_i2c->close();
+	delete _i2c;
 #ifdef MCP9808_DEBUG
-		printf("%s: I2C bus closed\n", __func__);
+	printf("%s: I2C bus closed\n", __func__);
 #endif
-	}
 	if (_read_failure_count > 0) {
 		syslog(LOG_NOTICE, "MCP9808 read failures: %ld", _read_failure_count);
 	}
+	if (_samples > 0) {
+		syslog(LOG_INFO, "MCP9808 samples: %ld, max read time %.3fms", _samples, _read_time_max_us / 1000.0);
+	}
 }
 
-void Mcp9808::init(const unsigned char address) {
+void Mcp9808::init(const unsigned char address, I2cTransport *transport) {
 	_read_failure_count = 0;
+	_error_reported = false;
 	_i2c_address = address;
 	_config_done = false;
-	_i2c_bus_file = -1;
-
+	if (transport == NULL) {
+		transport = new I2cLinux(I2C_BUS);
+	}
+	_i2c = transport;
+	_median_count = 0;
+	_median_index = 0;
+	_ema = 0.0;
+	_ema_valid = false;
+	_stop = false;
+	_sample_valid = false;
+	_sample = 0.0;
+	_interval_ms = 0;
+	_samples = 0;
+	_read_time_max_us = 0;
 }
 
-float Mcp9808::tempHist(float newTemp) {
-	if (_tempHist[0] < -100.0) {
-		_tempHist[0] = newTemp;
-		return newTemp;
-	}
-	float diff = fabs(_tempHist[0] - newTemp);
-	// if differential is too big ignore the new reading and return the old one
-	if (diff > 10) {
-		return _tempHist[0];
+/**
+ * Running median of the last 3 samples followed by an exponential
+ * moving average. A single spike is removed by the median.
+ */
+float Mcp9808::filter(float newTemp) {
+	_median_buf[_median_index] = newTemp;
+	_median_index = (_median_index + 1) % 3;
+	if (_median_count < 3) _median_count++;
+
+	float median = newTemp;
+	if (_median_count == 3) {
+		float a = _median_buf[0], b = _median_buf[1], c = _median_buf[2];
+		median = fmaxf(fminf(a, b), fminf(fmaxf(a, b), c));
 	}
-	// shift old temperatures in FIFO
-	for (int i=5; i<0; i--){
-		_tempHist[i] = _tempHist[i-1];
+	if (!_ema_valid) {
+		_ema = median;
+		_ema_valid = true;
+	} else {
+		_ema += MCP9808_EMA_ALPHA * (median - _ema);
 	}
-	// add new temp
-	_tempHist[0] = newTemp;
-	return newTemp;
+	return _ema;
 }
 
 bool Mcp9808::config(void) {
 
-	for (int i=0; i<4; i++) {
-		_tempHist[i] = -500.0;
-	}
-
-    if (_i2c_bus_file < 0) {
+    if (!_i2c->isOpen()) {
 		return false;
 	}
 
-	// Get I2C device, MCP9808 I2C address is 0x18(24)
-	ioctl(_i2c_bus_file, I2C_SLAVE, _i2c_address);
-
 	// Select configuration register(0x01)
 	// Continuous conversion mode, Power-up default(0x00, 0x00)
-	char config[3] = {0};
+	uint8_t config[3] = {0};
 	config[0] = 0x01;
 	config[1] = 0x00;
 	config[2] = 0x00;
-	write(_i2c_bus_file, config, 3);
+	_i2c->write(config, 3);
 
 	config[0] = 0x08;		// Select resolution register(0x08)
 	config[1] = 0x03;		// Resolution = +0.0625 / C(0x03)
-	write(_i2c_bus_file, config, 2);
+	_i2c->write(config, 2);
 
   _config_done = true;
 	return true;
@@ -105,8 +119,9 @@ bool Mcp9808::readTempC(float *tempValue) {
 	float cTemp;
   ssize_t bytes_written;
 
-	if (_i2c_bus_file < 0) {
-		if (!openI2Cbus()) {
+	// Get I2C device, MCP9808 I2C address is 0x18(24)
+	if (!_i2c->isOpen()) {
+		if (!_i2c->open(_i2c_address)) {
 			_read_failure_count++;
 			return false;
 		}
@@ -114,41 +129,38 @@ bool Mcp9808::readTempC(float *tempValue) {
 
 	if (!_config_done) {
 		if (!config()) {
-			fprintf(stderr, "%s: config() failed \n", __func__);
-			_read_failure_count++;
+			readError("config() failed");
 			return false;
 		}
 	}
 	// Read 2 bytes of data from register(0x05)
 	// temp msb, temp lsb
-	char reg[1] = {0x05};
-	bytes_written = write(_i2c_bus_file, reg, 1);
+	uint8_t reg[1] = {0x05};
+	bytes_written = _i2c->write(reg, 1);
 	if (bytes_written < 0) {
-		  syslog(LOG_ERR, "I2C write data error: %s", strerror(errno));
-			fprintf(stderr, "%s: I2C write data error: %s\n", __func__, strerror(errno));
-			_read_failure_count++;
-			return false;
+		readError((std::string("I2C write data error: ") + strerror(errno)).c_str());
+		return false;
 	}
 	if (bytes_written != 1) {
-		  syslog(LOG_ERR, "I2C write data error ");
-			fprintf(stderr, "%s: I2C write data error\n", __func__);
-			_read_failure_count++;
-			return false;
+		readError("I2C write data error");
+		return false;
 	}
-	char data[2] = {0};
-	if(read(_i2c_bus_file, data, 2) != 2) {
-		syslog(LOG_ERR, "I2C read data error");
-		fprintf(stderr, "%s: Input/Output error \n", __func__);
-		_read_failure_count++;
+	uint8_t data[2] = {0};
+	if(_i2c->read(data, 2) != 2) {
+		readError("I2C read data error");
 		return false;
 	}
+	if (_error_reported) {
+		syslog(LOG_NOTICE, "MCP9808 read recovered after %ld failures", _read_failure_count);
+		_error_reported = false;
+	}
 
 	// Convert the data to 13-bits
 	int temp = ((data[0] & 0x1F) * 256 + data[1]);
 	if(temp > 4095) {
 			temp -= 8192;
 	}
-	cTemp = tempHist(temp * 0.0625);
+	cTemp = temp * 0.0625;
 
   /*
     //Sanity check
@@ -166,6 +178,18 @@ bool Mcp9808::readTempC(float *tempValue) {
 	return true;
 }
 
+/**
+ * Count a failed read, only the first error of a series is logged
+ */
+void Mcp9808::readError(const char *msg) {
+	_read_failure_count++;
+	if (!_error_reported) {
+		syslog(LOG_ERR, "MCP9808 read error: %s", msg);
+		fprintf(stderr, "%s: MCP9808 read error: %s\n", __func__, msg);
+		_error_reported = true;
+	}
+}
+
 bool Mcp9808::readTempF(float *tempValue) {
 	float cTemp;
 	if (!readTempC(&cTemp)) {
@@ -179,17 +203,65 @@ bool Mcp9808::readTempF(float *tempValue) {
 	return true;
 }
 
-bool Mcp9808::openI2Cbus(void) {
-	const char *bus = I2C_BUS;
-	if ((_i2c_bus_file = open(bus, O_RDWR)) < 0)
-	{
-		syslog(LOG_ERR, "Failed to open I2C bus [%s]", bus);
-		fprintf(stderr, "%s: Failed to open I2C bus [%s] \n", __func__, bus);
+bool Mcp9808::start(unsigned int interval_ms) {
+	if (_thread.joinable()) return false;
+	_interval_ms = interval_ms;
+	_stop = false;
+	try {
+		_thread = std::thread(&Mcp9808::sampleThread, this);
+	} catch (const std::system_error &e) {
+		syslog(LOG_ERR, "MCP9808: failed to start sample thread: %s", e.what());
 		return false;
-	} else {
-#ifdef MCP9808_DEBUG
-		printf("%s: I2C bus open success\n", __func__);
-#endif
-		return true;
+	}
+	return true;
+}
+
+void Mcp9808::stop(void) {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_cv.notify_all();
+	if (_thread.joinable()) {
+		_thread.join();
+	}
+}
+
+bool Mcp9808::getTempC(float *tempValue) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!_sample_valid) return false;
+	*tempValue = _sample;
+	return true;
+}
+
+/**
+ * Background thread, reads and filters the temperature at the sample interval
+ * the interval is doubled after every failed read up to MCP9808_BACKOFF_MAX
+ */
+void Mcp9808::sampleThread(void) {
+	float cTemp;
+	struct timespec start, end;
+	unsigned int wait_ms = _interval_ms;
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (!_stop) {
+		lock.unlock();
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		bool valid = readTempC(&cTemp);
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		uint64_t read_time = (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_nsec - start.tv_nsec) / 1000;
+		if (valid) {
+			cTemp = filter(cTemp);
+		}
+		lock.lock();
+		_sample_valid = valid;
+		if (valid) {
+			_sample = cTemp;
+			_samples++;
+			if (read_time > _read_time_max_us) _read_time_max_us = read_time;
+			wait_ms = _interval_ms;
+		} else if (wait_ms < MCP9808_BACKOFF_MAX) {
+			wait_ms = (wait_ms * 2 < MCP9808_BACKOFF_MAX) ? wait_ms * 2 : MCP9808_BACKOFF_MAX;
+		}
+		_cv.wait_for(lock, std::chrono::milliseconds(wait_ms), [this] { return _stop; });
 	}
 }
@@ -2,6 +2,14 @@
  * @file mcp9808.h
 -----------------------------------------------------------------------------
  Read MCP9808 temperature sensor via I2C bus
+
+ The sensor can be sampled on a background thread (start/stop). Samples are
+ filtered by a running median of 3 (rejects single spikes) followed by an
+ exponential moving average, both O(1) per sample. The main loop collects
+ the filtered value with getTempC() without blocking on the I2C bus.
+
+ The I2C bus is accessed through an I2cTransport, an I2cFake transport can
+ be used to run without hardware.
 -----------------------------------------------------------------------------
 */
 
@@ -10,6 +18,16 @@
 
 #include <stdint.h>
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "i2c.h"
+
+#define MCP9808_DEFAULT_ADDRESS 0x18
+#define MCP9808_EMA_ALPHA 0.25      // weight of a new sample in the moving average
+#define MCP9808_BACKOFF_MAX 60000   // ms, longest sample interval while the reads fail
+
 class Mcp9808 {
 public:
     /**
@@ -20,8 +38,10 @@ public:
     /**
      * Constructor
      * @param address: I2C address of MCP9808
+     * @param transport: I2C transport, NULL for the Raspberry Pi I2C bus
+     *                   the object takes ownership of the transport
      */
-    Mcp9808(const unsigned char address);
+    Mcp9808(const unsigned char address, I2cTransport *transport = NULL);
 
     /**
      * Destructor
@@ -29,26 +49,64 @@ public:
     ~Mcp9808();
 
     /**
-     * Read temperature
+     * Read temperature (blocking)
      * @return the actual temperature
      */
     bool readTempC(float *tempValue);
     bool readTempF(float *tempValue);
 
+    /**
+     * Start sampling on a background thread
+     * @param interval_ms: sample interval in ms
+     * @returns true on success
+     */
+    bool start(unsigned int interval_ms);
+
+    /**
+     * Stop sampling
+     */
+    void stop(void);
+
+    /**
+     * Get the filtered temperature (non blocking)
+     * @param tempValue: storage for the temperature in DegC
+     * @returns false if no valid sample is available
+     */
+    bool getTempC(float *tempValue);
+
 private:
     // All properties of this class are private
     // Use setters & getters to access these values
 
-    int _i2c_bus_file;          // file used to access I2C bus
+    I2cTransport *_i2c;         // used to access I2C bus
     unsigned char _i2c_address;       // address of mcp9808
     bool _config_done;
     unsigned long _read_failure_count;
-    float _tempHist[5];
+    bool _error_reported;       // an error was logged, the next ones are not until a read succeeds
+
+    // filter state, O(1) per sample
+    float _median_buf[3];       // last 3 raw samples
+    int _median_count;
+    int _median_index;
+    float _ema;                 // exponential moving average of median
+    bool _ema_valid;
+
+    // background sampling
+    std::thread _thread;
+    std::mutex _mutex;          // protects the members below
+    std::condition_variable _cv;
+    bool _stop;
+    bool _sample_valid;         // the last sample attempt succeeded
+    float _sample;              // filtered temperature
+    unsigned int _interval_ms;
+    unsigned long _samples;     // statistics
+    uint64_t _read_time_max_us;
 
-    bool openI2Cbus(void);
     bool config(void);
-    void init(const unsigned char address);
-    float tempHist(float newTemp);
+    void readError(const char *msg);
+    void init(const unsigned char address, I2cTransport *transport);
+    float filter(float newTemp);
+    void sampleThread(void);
 
 };
 
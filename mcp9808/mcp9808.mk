@@ -1,4 +1,5 @@
 CPPSRCS += mcp9808.cpp
+CPPSRCS += i2c.cpp
 
 DEPPATH += --dep-path mcp9808
 VPATH += :mcp9808
@@ -0,0 +1,149 @@
+/**
+ * @file scheduler.cpp
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <syslog.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "scheduler.h"
+
+/*********************
+ * MEMBER FUNCTIONS
+ *********************/
+
+Scheduler::Scheduler() {
+    for (int i = 0; i < SCHEDULER_MAX_JOBS; i++) {
+        _jobs[i].slot = -1;
+    }
+    for (int i = 0; i < SCHEDULER_SLOTS; i++) {
+        _wheel[i] = -1;
+    }
+    _current = 0;
+    _tick_time = now_ms();
+    _seed = (unsigned int) (_tick_time ^ getpid());
+}
+
+Scheduler::~Scheduler() {
+}
+
+int Scheduler::addJob(const char *name, void (*callback) (void*), void *arg, uint32_t period_ms, bool jitter) {
+    if (callback == NULL) return -1;
+    int id;
+    for (id = 0; id < SCHEDULER_MAX_JOBS; id++) {
+        if (_jobs[id].slot < 0) break;
+    }
+    if (id >= SCHEDULER_MAX_JOBS) {
+        syslog(LOG_ERR, "Scheduler: no space for job %s", name);
+        fprintf(stderr, "%s: no space for job %s\n", __func__, name);
+        return -1;
+    }
+    uint32_t period = (period_ms + SCHEDULER_TICK_MS - 1) / SCHEDULER_TICK_MS;
+    if (period < 1) period = 1;
+    _jobs[id].name = name;
+    _jobs[id].callback = callback;
+    _jobs[id].arg = arg;
+    _jobs[id].period = period;
+    // the first expiry is randomly spread over one period
+    if (jitter) {
+        link(id, 1 + rand_r(&_seed) % period);
+    } else {
+        link(id, period);
+    }
+    return id;
+}
+
+void Scheduler::removeJob(int id) {
+    if ((id < 0) || (id >= SCHEDULER_MAX_JOBS)) return;
+    if (_jobs[id].slot < 0) return;
+    unlink(id);
+}
+
+int Scheduler::process(void) {
+    int count = 0;
+    uint64_t now = now_ms();
+    while (now >= _tick_time + SCHEDULER_TICK_MS) {
+        _tick_time += SCHEDULER_TICK_MS;
+        _current = (_current + 1) % SCHEDULER_SLOTS;
+        // Note: job callbacks must not remove other jobs
+        int id = _wheel[_current];
+        while (id >= 0) {
+            int next = _jobs[id].next;
+            if (_jobs[id].rounds > 0) {
+                _jobs[id].rounds--;
+            } else {
+                // reschedule first, the callback may remove its own job
+                unlink(id);
+                link(id, _jobs[id].period);
+                (*_jobs[id].callback) (_jobs[id].arg);
+                count++;
+            }
+            id = next;
+        }
+    }
+    return count;
+}
+
+uint32_t Scheduler::msToNext(uint32_t max_ms) {
+    uint64_t now = now_ms();
+    uint32_t ticks = max_ms / SCHEDULER_TICK_MS + 1;
+    if (ticks > SCHEDULER_SLOTS) ticks = SCHEDULER_SLOTS;
+    for (uint32_t t = 1; t <= ticks; t++) {
+        int id = _wheel[(_current + t) % SCHEDULER_SLOTS];
+        while (id >= 0) {
+            if (_jobs[id].rounds == 0) {
+                uint64_t due = _tick_time + t * SCHEDULER_TICK_MS;
+                if (due <= now) return 0;
+                return (due - now < max_ms) ? due - now : max_ms;
+            }
+            id = _jobs[id].next;
+        }
+    }
+    return max_ms;
+}
+
+/*********************
+ * PRIVATE FUNCTIONS
+ *********************/
+
+/**
+ * Insert a job into the wheel to expire in "ticks" ticks from now
+ */
+void Scheduler::link(int id, uint32_t ticks) {
+    int slot = (_current + ticks) % SCHEDULER_SLOTS;
+    _jobs[id].rounds = (ticks - 1) / SCHEDULER_SLOTS;
+    _jobs[id].slot = slot;
+    _jobs[id].prev = -1;
+    _jobs[id].next = _wheel[slot];
+    if (_wheel[slot] >= 0) {
+        _jobs[_wheel[slot]].prev = id;
+    }
+    _wheel[slot] = id;
+}
+
+/**
+ * Remove a job from the wheel
+ */
+void Scheduler::unlink(int id) {
+    if (_jobs[id].prev >= 0) {
+        _jobs[_jobs[id].prev].next = _jobs[id].next;
+    } else {
+        _wheel[_jobs[id].slot] = _jobs[id].next;
+    }
+    if (_jobs[id].next >= 0) {
+        _jobs[_jobs[id].next].prev = _jobs[id].prev;
+    }
+    _jobs[id].slot = -1;
+}
+
+uint64_t Scheduler::now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file scheduler.h
+ *
+ -----------------------------------------------------------------------------
+ The Scheduler class executes periodic jobs from the main loop.
+
+ Jobs are stored in a hashed timer wheel: each job is linked into the slot
+ of the wheel tick it expires in. Advancing the wheel by one tick only
+ touches the jobs in a single slot, regardless of the number of jobs.
+ Periods longer than one revolution of the wheel are handled by counting
+ the remaining rounds.
+
+ Each job starts with a random phase offset (jitter) so jobs with the same
+ period do not all fire in the same main loop iteration.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+
+#define SCHEDULER_TICK_MS 50        // resolution of the timer wheel
+#define SCHEDULER_SLOTS 256         // slots in the timer wheel (12.8s per revolution)
+#define SCHEDULER_MAX_JOBS 32       // the maximum number of jobs
+
+class Scheduler {
+public:
+    // Constructor
+    Scheduler();
+
+    // Destructor
+    ~Scheduler();
+
+    /**
+     * Add a periodic job
+     * @param name: job name (used for logging)
+     * @param callback: function called when the job is due
+     * @param arg: argument passed to callback
+     * @param period_ms: job period in ms (rounded up to SCHEDULER_TICK_MS)
+     * @param jitter: true to start with a random phase within the period
+     * @returns job ID or -1 on failure
+     */
+    int addJob(const char *name, void (*callback) (void*), void *arg, uint32_t period_ms, bool jitter = true);
+
+    /**
+     * Remove a job
+     * @param id: job ID returned by addJob
+     */
+    void removeJob(int id);
+
+    /**
+     * Advance the timer wheel to the current time and execute due jobs
+     * Must be called from the main loop
+     * @returns the number of jobs executed
+     */
+    int process(void);
+
+    /**
+     * Get time until the next job is due
+     * @param max_ms: the maximum time of interest
+     * @returns time in ms, max_ms if no job is due within max_ms
+     */
+    uint32_t msToNext(uint32_t max_ms);
+
+private:
+    typedef struct {
+        const char *name;
+        void (*callback) (void*);
+        void *arg;
+        uint32_t period;            // in ticks
+        uint32_t rounds;            // remaining wheel revolutions
+        int next;                   // next job in slot list, -1 = end
+        int prev;                   // previous job in slot list, -1 = head
+        int slot;                   // -1 = job not in use
+    } job_t;
+
+    void link(int id, uint32_t ticks);
+    void unlink(int id);
+    uint64_t now_ms(void);
+
+    job_t _jobs[SCHEDULER_MAX_JOBS];
+    int _wheel[SCHEDULER_SLOTS];    // head of job list for each slot
+    uint32_t _current;              // current slot
+    uint64_t _tick_time;            // time of the current tick in ms
+    unsigned int _seed;             // random seed for jitter
+};
+
+#endif /* SCHEDULER_H */
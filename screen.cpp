@@ -16,16 +16,24 @@
 
 #include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <syslog.h>
+#include <time.h>
+#include <sys/resource.h>
 
 #include "lvgl.h"
 #include "fbdev.h"
-#include "evdev.h"
 
 #include "screen.h"
 #include "datatag.h"
 #include "topics.h"
+#include "touch.h"
+#include "headless.h"
+#include "fonts.h"
 
 extern TagStore ts;
+extern TouchInput touch;
+extern HeadlessDisplay *headless;
 
 using namespace std;
 
@@ -34,20 +42,41 @@ using namespace std;
  *   PRIVATE VARIABLES
  **********************/
 
-// display buffer size - not sure if this size is really needed
-#define LV_BUF_SIZE 384000      // 800x480
 // A static variable to store the display buffers
 static lv_disp_buf_t disp_buf;
-// Static buffer(s). The second buffer is optional
-static lv_color_t lvbuf1[LV_BUF_SIZE];
-static lv_color_t lvbuf2[LV_BUF_SIZE];
+// stripe height of the partial draw buffers, 0 = render into the frame buffer pages
+static int stripe_lines = 0;
+// render statistics, reported by screen_close()
+static bool frame_rendered;
+static unsigned long frame_count;
+static double frame_time_sum, frame_time_max;      // in s
+static double frame_cpu_sum;                        // thread CPU time in s
+static uint64_t frame_px_sum;
+#if LV_STYLE_CACHE_CNT
+static uint64_t frame_style_lookups;                // style properties looked up while rendering
+static uint64_t frame_style_misses;                 // of them resolved from the style lists
+#endif
+// vblank aligned refresh, see vsync_align()
+static bool vsync_enabled = true;
+static bool vsync = false;                          // vblank timing available
+static uint32_t refr_vblank;                        // vblank the last refresh was started after
+static uint64_t refr_start_us;
+static bool refr_deferred;
+static uint32_t render_est_us;                      // estimated render time of a frame
+static unsigned long vsync_frames, vsync_on_time, vsync_dropped, vsync_deferred;
+static struct timespec screen_start;
+// fonts loaded from binary font files, see fonts.h
+static FontSet fonts;
+static const char *font_config = NULL;
 // touch screen driver
 lv_indev_drv_t indev_drv;
 
 // graphic content 
-char *info_label_text;
+static lv_obj_t *info_label;
+static string info_label_text;
 int16_t brightness_value = 10;
 scr_cmd_t scr_cmd = SCR_CMD_NONE;
+static bool render_suspended = false;
 
 lv_obj_t *tv;
 lv_obj_t *tab1;
@@ -87,6 +116,28 @@ lv_obj_t *lv_roomTemp[ROOM_TEMPS_MAX];
 
 const char* roomTempFormat[ROOM_TEMPS_MAX] = { "Local %s°C", "Shack %s°C", "Bed1 %s°C", "Balcony %s°C", "Balcony %s%%" };
 
+// built-in fonts, used if no font file is loaded for a size (see screen_set_fonts())
+#if LV_FONT_MONTSERRAT_20
+#define BUILTIN_FONT20 &lv_font_montserrat_20
+#else
+#define BUILTIN_FONT20 LV_THEME_DEFAULT_FONT_NORMAL
+#endif
+#if LV_FONT_MONTSERRAT_24
+#define BUILTIN_FONT24 &lv_font_montserrat_24
+#else
+#define BUILTIN_FONT24 LV_THEME_DEFAULT_FONT_NORMAL
+#endif
+#if LV_FONT_MONTSERRAT_28
+#define BUILTIN_FONT28 &lv_font_montserrat_28
+#else
+#define BUILTIN_FONT28 LV_THEME_DEFAULT_FONT_NORMAL
+#endif
+#if LV_FONT_MONTSERRAT_32
+#define BUILTIN_FONT32 &lv_font_montserrat_32
+#else
+#define BUILTIN_FONT32 LV_THEME_DEFAULT_FONT_NORMAL
+#endif
+
 #define SWITCH_SIZE_X 80
 #define SWITCH_SIZE_Y 40
 
@@ -111,31 +162,215 @@ void shack_radio12pwr_switch_action(lv_obj_t *obj, lv_event_t event);
 /**********************
  *   GLOBAL FUNCTIONS
  **********************/
+
+/**
+ * LVGL input driver read function
+ * the touch input device is read by TouchInput::process in the main loop
+ */
+static bool touch_read(lv_indev_drv_t *drv, lv_indev_data_t *data) {
+    return touch.read(drv, data);
+}
  
+/**
+ * LVGL monitor callback, called after each refresh
+ */
+static void render_monitor(lv_disp_drv_t *drv, uint32_t time, uint32_t px) {
+    frame_rendered = true;
+    frame_px_sum += px;
+}
+
+static uint64_t monotonic_us(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+/**
+ * Get the timing of the last vblank from the display driver
+ * @returns false if not available
+ */
+static bool vsync_get(uint32_t *count, uint64_t *vblank_us, uint32_t *period_us) {
+    return fbdev_vsync_get(count, vblank_us, period_us);
+}
+
+/**
+ * Get the timing of the last vblank before a point in time
+ * The counter of the driver may lag if its vblank thread has not run yet, the vblanks missed are
+ * extrapolated from the period
+ * @returns false if not available
+ */
+static bool vsync_get_at(uint64_t now, uint32_t *count, uint64_t *vblank_us, uint32_t *period_us) {
+    if (!vsync_get(count, vblank_us, period_us)) return false;
+    if (now > *vblank_us + *period_us) {
+        uint32_t missed = (now - *vblank_us) / *period_us;
+        *count += missed;
+        *vblank_us += (uint64_t) missed * *period_us;
+    }
+    return true;
+}
+
+/**
+ * Start the refresh task right after a vblank if the frame can be rendered before the next one,
+ * otherwise the refresh is deferred to the next vblank
+ * @returns the vblank the frame has to be done by, a later one counts as dropped
+ */
+static uint32_t vsync_align(void) {
+    lv_task_t *refr_task = lv_disp_get_default()->refr_task;
+    if (refr_task->prio == LV_TASK_PRIO_OFF) return 0;     // nothing invalidated
+    uint32_t count, period_us;
+    uint64_t vblank_us;
+    uint64_t now = monotonic_us();
+    if (!vsync_get_at(now, &count, &vblank_us, &period_us)) {
+        // free running while the driver has no vblank timing, e.g. the display is off
+        if (now - refr_start_us >= LV_DISP_DEF_REFR_PERIOD * 1000) {
+            refr_start_us = now;
+            lv_task_ready(refr_task);
+        }
+        return 0;
+    }
+    // one refresh per vblank, at most one per LVGL refresh period
+    if (count == refr_vblank) return 0;
+    if (now - refr_start_us + period_us / 2 < LV_DISP_DEF_REFR_PERIOD * 1000) return 0;
+    // frames longer than a period can never make it, they are not deferred
+    uint64_t done_us = now + render_est_us + SCREEN_VSYNC_MARGIN;
+    if ((render_est_us + SCREEN_VSYNC_MARGIN < period_us) && (done_us > vblank_us + period_us)) {
+        if (!refr_deferred) vsync_deferred++;
+        refr_deferred = true;
+        return 0;
+    }
+    refr_deferred = false;
+    refr_vblank = count;
+    refr_start_us = now;
+    lv_task_ready(refr_task);
+    // a flip is shown at the next vblank, stripes have to be copied before it
+    return stripe_lines ? count : count + 1;
+}
+
+/**
+ * Count the vblanks missed by a frame after it has been rendered
+ */
+static void vsync_frame_done(uint32_t target, uint32_t render_us) {
+    uint32_t count, period_us;
+    uint64_t vblank_us;
+    vsync_frames++;
+    if ((target != 0) && vsync_get_at(monotonic_us(), &count, &vblank_us, &period_us)) {
+        if ((int32_t) (count - target) > 0) vsync_dropped += count - target;
+        else vsync_on_time++;                       // done by the vblank it was started for
+    }
+    // decaying maximum, overestimating defers a frame, underestimating drops one
+    render_est_us = (render_us > render_est_us) ? render_us : (render_est_us * 15 + render_us) / 16;
+}
+
+/**
+ * Use partial draw buffers instead of page flipping
+ * must be called before screen_init()
+ * @param lines: stripe height, 0 = page flipping if supported
+ */
+void screen_set_stripes(int lines) {
+    if (lines < 0) lines = 0;
+    if (lines > LV_VER_RES_MAX) lines = LV_VER_RES_MAX;
+    stripe_lines = lines;
+}
+
+/**
+ * Align the refreshes to the vblanks of the display if supported (default)
+ * must be called before screen_init()
+ * @param enable: false = refresh whenever the LVGL refresh task is due
+ */
+void screen_set_vsync(bool enable) {
+    vsync_enabled = enable;
+}
+
+/**
+ * Load the fonts of a configuration file instead of the built-in fonts
+ * must be called before screen_init()
+ * @param configFile: font configuration, see fonts.h
+ */
+void screen_set_fonts(const char *configFile) {
+    font_config = configFile;
+}
+
 /**
  * Init screen subsystem
  */
 void screen_init() {
     lv_init();		// LittlecGL init
-    fbdev_init();	// Frame Buffer device init (screen)
-    evdev_init();	// Touch pointer device init
-
-    // Initialize `disp_buf` with the display buffer(s)
-    lv_disp_buf_init(&disp_buf, lvbuf1, lvbuf2, LV_BUF_SIZE);
-
+    if (font_config != NULL) fonts.load(font_config);
     //Initialize and register  display driver
     lv_disp_drv_t disp_drv;
     lv_disp_drv_init(&disp_drv);
-    disp_drv.flush_cb = fbdev_flush;	// lvgl buffer to frame buffer
+
+    if (headless != NULL) {
+        // render in stripes into a frame in memory, no display device
+        if (stripe_lines == 0) stripe_lines = SCREEN_STRIPE_LINES;
+    } else {
+        fbdev_init();	// Frame Buffer device init (screen)
+        if (vsync_enabled) fbdev_vsync_start();     // vblank thread, pans at vblank
+    }
+
+    // Render directly into the two frame buffer pages if possible
+    void *buf1, *buf2;
+    uint32_t size = 0;
+    if (stripe_lines == 0) {
+        size = fbdev_page_flip_init(&buf1, &buf2);
+        if (size == 0) stripe_lines = SCREEN_STRIPE_LINES;
+    }
+    if (size > 0) {
+        uint32_t width, height;
+        fbdev_get_sizes(&width, &height);
+        disp_drv.hor_res = width;       // the pages must match the screen size
+        disp_drv.ver_res = height;
+        disp_drv.flush_cb = fbdev_flip;     // pan to the page rendered last
+        disp_drv.wait_cb = fbdev_flip_wait; // wait for the pan on vblank
+    } else {
+        // LVGL renders the next stripe while the flush thread copies the last one
+        size = LV_HOR_RES_MAX * stripe_lines;
+        buf1 = malloc(size * sizeof(lv_color_t));
+        buf2 = malloc(size * sizeof(lv_color_t));
+        if ((buf1 == NULL) || (buf2 == NULL)) {
+            fprintf(stderr, "%s: failed to allocate display buffers\n", __func__);
+            exit(EXIT_FAILURE);
+        }
+        if (headless != NULL) {
+            if (!headless->init(&disp_drv)) exit(EXIT_FAILURE);
+        } else
+        if (fbdev_flush_thread_start()) {
+            disp_drv.flush_cb = fbdev_flush_async;
+            disp_drv.wait_cb = fbdev_flush_wait;
+        } else {
+            disp_drv.flush_cb = fbdev_flush;	// lvgl buffer to frame buffer
+        }
+        printf("Rendering in %d line stripes\n", stripe_lines);
+    }
+    disp_drv.monitor_cb = render_monitor;
+    // Initialize `disp_buf` with the display buffer(s)
+    lv_disp_buf_init(&disp_buf, buf1, buf2, size);
     disp_drv.buffer = &disp_buf;        // set display buffer reference
-    lv_disp_drv_register(&disp_drv);
+    lv_disp_t *disp = lv_disp_drv_register(&disp_drv);
+
+    // screen_process() starts the refreshes after a vblank, the task period is a fallback only
+    uint32_t count, period_us;
+    uint64_t vblank_us;
+    vsync = (headless == NULL) && vsync_enabled && vsync_get(&count, &vblank_us, &period_us);
+    if (vsync) {
+        lv_task_set_period(disp->refr_task, SCREEN_VSYNC_FALLBACK);
+        printf("Refresh aligned to the vblank, %.2fHz\n", 1e6 / period_us);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &screen_start);
 
     /* Initialize and register touch pointer driver */
     lv_indev_drv_init(&indev_drv);
     indev_drv.type = LV_INDEV_TYPE_POINTER;
-    indev_drv.read_cb = evdev_read;
+    indev_drv.read_cb = touch_read;	// shared touch input reader
     lv_indev_drv_register(&indev_drv);
 
+    /* Theme font, the theme was initialised by lv_init() with the built-in font */
+    const lv_font_t *font16 = fonts.get(16, LV_THEME_DEFAULT_FONT_NORMAL);
+    if (font16 != LV_THEME_DEFAULT_FONT_NORMAL) {
+        lv_theme_set_act(LV_THEME_DEFAULT_INIT(LV_THEME_DEFAULT_COLOR_PRIMARY, LV_THEME_DEFAULT_COLOR_SECONDARY,
+            LV_THEME_DEFAULT_FLAG, font16, font16, font16, font16));
+    }
+
     /* Set common styles for screen objects*/
     /* Green LED */
     lv_style_init(&style_led_green);
@@ -150,19 +385,19 @@ void screen_init() {
     
     /* Font size 20 */
     lv_style_init(&style_font20);
-    lv_style_set_text_font(&style_font20, LV_STATE_DEFAULT, &lv_font_montserrat_20);
+    lv_style_set_text_font(&style_font20, LV_STATE_DEFAULT, fonts.get(20, BUILTIN_FONT20));
     
     /* Font size 24 */
     lv_style_init(&style_font24);
-    lv_style_set_text_font(&style_font24, LV_STATE_DEFAULT, &lv_font_montserrat_24);
+    lv_style_set_text_font(&style_font24, LV_STATE_DEFAULT, fonts.get(24, BUILTIN_FONT24));
 
     /* Font size 28 */
     lv_style_init(&style_font28);
-    lv_style_set_text_font(&style_font28, LV_STATE_DEFAULT, &lv_font_montserrat_28);
+    lv_style_set_text_font(&style_font28, LV_STATE_DEFAULT, fonts.get(28, BUILTIN_FONT28));
 
     /* Font size 32 */
     lv_style_init(&style_font32);
-    lv_style_set_text_font(&style_font32, LV_STATE_DEFAULT, &lv_font_montserrat_32);
+    lv_style_set_text_font(&style_font32, LV_STATE_DEFAULT, fonts.get(32, BUILTIN_FONT32));
 
     /* for container box */
     lv_style_init(&style_box);
@@ -254,6 +489,40 @@ void screen_set_brightness(int16_t value) {
     brightness_value = value;
 }
 
+void screen_set_info(const char *text) {
+    info_label_text = text;
+    if (info_label == NULL) return;     // label not created yet
+    lv_label_set_text(info_label, text);
+    lv_obj_align(info_label, NULL, LV_ALIGN_IN_BOTTOM_LEFT, 10, -10);
+}
+
+/**
+ * Suspend rendering (e.g. while the backlight is off)
+ * objects can still be updated, they are redrawn by screen_resume()
+ */
+void screen_suspend(void) {
+    render_suspended = true;
+}
+
+/**
+ * Resume rendering
+ * the whole screen is invalidated once and rendered in a single frame
+ */
+void screen_resume(void) {
+    if (!render_suspended) return;
+    render_suspended = false;
+    lv_obj_invalidate(lv_scr_act());
+    lv_disp_trig_activity(NULL);
+    lv_refr_now(NULL);
+}
+
+/**
+ * While suspended lv_task_handler must not be called
+ */
+bool screen_is_suspended(void) {
+    return render_suspended;
+}
+
 // exit screen
 void screen_exit(void) {
     lv_obj_del(tab1);
@@ -267,6 +536,124 @@ void screen_exit(void) {
     lv_obj_align(label, NULL, LV_ALIGN_CENTER, 0, 0);
 }
 
+/**
+ * Run the LVGL tasks and measure the time of frames rendered
+ */
+void screen_process(void) {
+    struct timespec start, end, cpu_start, cpu_end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_start);
+    frame_rendered = false;
+    uint32_t target_vblank = vsync ? vsync_align() : 0;
+#if LV_STYLE_CACHE_CNT
+    lv_obj_style_cache_info_t styles_start;
+    lv_obj_style_cache_get_info(&styles_start);
+#endif
+    lv_task_handler();
+    if (frame_rendered) {
+#if LV_STYLE_CACHE_CNT
+        lv_obj_style_cache_info_t styles_end;
+        lv_obj_style_cache_get_info(&styles_end);
+        frame_style_lookups += (styles_end.hit_cnt - styles_start.hit_cnt) + (styles_end.miss_cnt - styles_start.miss_cnt);
+        frame_style_misses += styles_end.miss_cnt - styles_start.miss_cnt;
+#endif
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_end);
+        double frame_time = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+        // excludes the time waiting for the flush or flip
+        double frame_cpu = (cpu_end.tv_sec - cpu_start.tv_sec) + (cpu_end.tv_nsec - cpu_start.tv_nsec) / 1e9;
+        frame_cpu_sum += frame_cpu;
+        // stripes are done when copied, flipped pages when rendered (the wall time includes the flip)
+        if (vsync) vsync_frame_done(target_vblank, (stripe_lines ? frame_time : frame_cpu) * 1e6);
+        frame_time_sum += frame_time;
+        if (frame_time > frame_time_max) frame_time_max = frame_time;
+        frame_count++;
+    }
+}
+
+// release the display device
+void screen_close(void) {
+    if (headless == NULL) fbdev_exit();
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    if (frame_count > 0) {
+        printf("Render %s: %lu frames, avg %.3fms max %.3fms, cpu %.3fms/frame, %llu px/frame, max RSS %ldkB\n",
+            stripe_lines ? "stripes" : "page flip", frame_count,
+            frame_time_sum * 1000 / frame_count, frame_time_max * 1000, frame_cpu_sum * 1000 / frame_count,
+            (unsigned long long) (frame_px_sum / frame_count), usage.ru_maxrss);
+        syslog(LOG_INFO, "Render %s: %lu frames, avg %.3fms max %.3fms, max RSS %ldkB",
+            stripe_lines ? "stripes" : "page flip", frame_count,
+            frame_time_sum * 1000 / frame_count, frame_time_max * 1000, usage.ru_maxrss);
+    }
+#if LV_FONT_FMT_TXT_CACHE_CNT
+    lv_font_fmt_txt_cache_info_t glyphs;
+    lv_font_fmt_txt_cache_get_info(&glyphs);
+    uint32_t lookups = glyphs.hit_cnt + glyphs.miss_cnt;
+    if (lookups > 0) {
+        printf("Glyph cache: %u lookups, %.1f%% hits, %u glyphs, %u bytes\n", lookups,
+            100.0 * glyphs.hit_cnt / lookups, glyphs.glyph_cnt, glyphs.mem_size);
+        syslog(LOG_INFO, "Glyph cache: %.1f%% hits, %u glyphs, %u bytes",
+            100.0 * glyphs.hit_cnt / lookups, glyphs.glyph_cnt, glyphs.mem_size);
+    }
+#endif
+#if LV_USE_SHADOW && LV_SHADOW_CACHE_SIZE
+    lv_draw_shadow_cache_info_t shadows;
+    lv_draw_shadow_cache_get_info(&shadows);
+    uint32_t shadow_count = shadows.hit_cnt + shadows.miss_cnt;
+    if (shadow_count > 0) {
+        printf("Shadow cache: %u shadows, %.1f%% hits, %u of %u corners, %u bytes\n", shadow_count,
+            100.0 * shadows.hit_cnt / shadow_count, shadows.entry_cnt, LV_SHADOW_CACHE_CNT, shadows.mem_size);
+        syslog(LOG_INFO, "Shadow cache: %.1f%% hits, %u corners, %u bytes",
+            100.0 * shadows.hit_cnt / shadow_count, shadows.entry_cnt, shadows.mem_size);
+    }
+#endif
+    lv_img_cache_info_t images;
+    lv_img_cache_get_info(&images);
+    uint32_t image_opens = images.hit_cnt + images.miss_cnt;
+    if (image_opens > 0) {
+        printf("Image cache: %u opens, %.1f%% hits, %ums decoding, %u of %u images, %u of %u bytes\n", image_opens,
+            100.0 * images.hit_cnt / image_opens, images.decode_time, images.entry_cnt, images.entry_max,
+            images.mem_size, images.mem_max);
+        syslog(LOG_INFO, "Image cache: %.1f%% hits, %ums decoding, %u images, %u bytes",
+            100.0 * images.hit_cnt / image_opens, images.decode_time, images.entry_cnt, images.mem_size);
+    }
+#if LV_RADIUS_MASK_CACHE_CNT
+    lv_draw_mask_radius_cache_info_t corners;
+    lv_draw_mask_radius_cache_get_info(&corners);
+    uint32_t radius_masks = corners.hit_cnt + corners.miss_cnt;
+    if (radius_masks > 0) {
+        printf("Radius mask cache: %u masks, %.1f%% hits, %u of %u radii, %u of %u bytes\n", radius_masks,
+            100.0 * corners.hit_cnt / radius_masks, corners.entry_cnt, LV_RADIUS_MASK_CACHE_CNT, corners.mem_size,
+            LV_RADIUS_MASK_CACHE_SIZE);
+        syslog(LOG_INFO, "Radius mask cache: %.1f%% hits, %u radii, %u bytes",
+            100.0 * corners.hit_cnt / radius_masks, corners.entry_cnt, corners.mem_size);
+    }
+#endif
+#if LV_STYLE_CACHE_CNT
+    if ((frame_count > 0) && (frame_style_lookups > 0)) {
+        lv_obj_style_cache_info_t styles;
+        lv_obj_style_cache_get_info(&styles);
+        printf("Style cache: %llu lookups/frame, %.1f%% hits, %u of %u entries used\n",
+            (unsigned long long) (frame_style_lookups / frame_count),
+            100.0 * (frame_style_lookups - frame_style_misses) / frame_style_lookups, styles.entry_cnt, LV_STYLE_CACHE_CNT);
+        syslog(LOG_INFO, "Style cache: %llu lookups/frame, %.1f%% hits",
+            (unsigned long long) (frame_style_lookups / frame_count),
+            100.0 * (frame_style_lookups - frame_style_misses) / frame_style_lookups);
+    }
+#endif
+    if (vsync && (vsync_frames > 0)) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        double minutes = ((now.tv_sec - screen_start.tv_sec) + (now.tv_nsec - screen_start.tv_nsec) / 1e9) / 60;
+        printf("Vsync: %lu frames, %lu on time, %lu dropped, %lu deferred, per minute %.1f on time %.1f dropped\n",
+            vsync_frames, vsync_on_time, vsync_dropped, vsync_deferred,
+            vsync_on_time / minutes, vsync_dropped / minutes);
+        syslog(LOG_INFO, "Vsync: %.1f on-time frames/min, %.1f dropped frames/min",
+            vsync_on_time / minutes, vsync_dropped / minutes);
+    }
+    fonts.close();
+}
+
 /**********************
  *   PRIVATE FUNCTIONS
  **********************/
@@ -640,9 +1027,9 @@ void settings_create(lv_obj_t *parent) {
     lv_label_set_text(lv_cpuTemp, "CPU ##.#°C");
     lv_obj_align(lv_cpuTemp, NULL, LV_ALIGN_CENTER, 0, 0);
 
-    // Info Label
-    lv_obj_t *info_label = lv_label_create(parent, NULL);
-    lv_label_set_text(info_label, info_label_text);
+    // Info Label, text is set by screen_set_info() once the hardware info is available
+    info_label = lv_label_create(parent, NULL);
+    lv_label_set_text(info_label, info_label_text.c_str());
     lv_obj_align(info_label, NULL, LV_ALIGN_IN_BOTTOM_LEFT, 10, -10);
 
     /*
@@ -18,6 +18,10 @@ extern "C" {
  *      DEFINES
  *********************/
 #define SCREEN_UPDATE    5
+#define SCREEN_SUSPEND_POLL    1000    // max sleep time in ms while rendering is suspended
+#define SCREEN_STRIPE_LINES    40      // default stripe height (2 x 800 x 40 x 4 bytes = 250kB)
+#define SCREEN_VSYNC_MARGIN    1000    // in us, kept free before the vblank a frame is aligned to
+#define SCREEN_VSYNC_FALLBACK  1000    // in ms, refresh task period while screen_process() starts the refreshes
 
 /**********************
  *      TYPEDEFS
@@ -34,13 +38,22 @@ extern "C" {
  *   GLOBAL PROTOTYPES
  **********************/
 
+    void screen_set_stripes(int lines);
+    void screen_set_vsync(bool enable);
+    void screen_set_fonts(const char *configFile);
     void screen_init();
+    void screen_process(void);
     void screen_create(void);
     void screen_exit(void);
+    void screen_close(void);
     scr_cmd_t screen_getCmd(void);
     void screen_clearCmd();
     int16_t screen_brightness(void);
     void screen_set_brightness(int16_t value);
+    void screen_set_info(const char *text);
+    void screen_suspend(void);
+    void screen_resume(void);
+    bool screen_is_suspended(void);
     
 #ifdef __cplusplus
 }
@@ -0,0 +1,252 @@
+/**
+ * @file sensors.cpp
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <syslog.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "sensors.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define THERMAL_PATH "/sys/class/thermal"
+#define HWMON_PATH "/sys/class/hwmon"
+#define CPU_PATH "/sys/devices/system/cpu"
+#define LOADAVG_PATH "/proc/loadavg"
+#define MEMINFO_PATH "/proc/meminfo"
+
+using namespace std;
+
+/*********************
+ * GLOBAL FUNCTIONS
+ *********************/
+
+/**
+ * List the directory entries starting with prefix, sorted by name
+ */
+static vector<string> list_dir(const string &path, const char *prefix)
+{
+    vector<string> names;
+    DIR *dir = opendir(path.c_str());
+    if (dir == NULL) return names;
+    struct dirent *entry;
+    size_t prefix_len = strlen(prefix);
+    while ((entry = readdir(dir)) != NULL) {
+        if (strncmp(entry->d_name, prefix, prefix_len) == 0) {
+            names.push_back(entry->d_name);
+        }
+    }
+    closedir(dir);
+    sort(names.begin(), names.end());
+    return names;
+}
+
+/**
+ * Replace characters which are not valid in a topic, '/' separates the levels
+ */
+static string topic_name(const string &name)
+{
+    string result = name;
+    for (size_t i = 0; i < result.length(); i++) {
+        char c = result[i];
+        if ((c == ' ') || (c == '+') || (c == '#') || (c == '\n')) {
+            result[i] = '_';
+        }
+    }
+    return result;
+}
+
+/*********************
+ * MEMBER FUNCTIONS
+ *********************/
+
+SensorSet::SensorSet(const char *root) {
+    _root = root;
+    _count = 0;
+    _cycles = 0;
+    _read_time_sum_us = 0;
+    _read_time_max_us = 0;
+}
+
+SensorSet::~SensorSet() {
+    for (int i = 0; i < _count; i++) {
+        if (_sensors[i].fd >= 0) close(_sensors[i].fd);
+    }
+    if (_cycles > 0) {
+        syslog(LOG_INFO, "sensors: %d sensors, read time avg %.3fms max %.3fms per cycle",
+            _count, _read_time_sum_us / 1000.0 / _cycles, _read_time_max_us / 1000.0);
+    }
+}
+
+int SensorSet::discover(TagStore *ts, const char *topicBase, void (*publishCallback) (int,Tag*)) {
+    scan_thermal();
+    scan_hwmon();
+    scan_cpufreq();
+    add("load1", LOADAVG_PATH, SENSOR_LOADAVG, 1.0, "%.2f");
+    add("mem_available", MEMINFO_PATH, SENSOR_MEMINFO, 1.0 / 1024, "%.0f");     // kB to MB
+
+    for (int i = 0; i < _count; i++) {
+        string topic = topicBase + _sensors[i].name;
+        Tag *tp = ts->addTag(topic.c_str());
+        if (tp == NULL) {
+            syslog(LOG_ERR, "sensors: no space for tag %s", topic.c_str());
+            continue;
+        }
+        tp->setPublish();
+        tp->setFormat(_sensors[i].format);
+        tp->registerPublishCallback(publishCallback, i);
+        _sensors[i].tag = tp;
+    }
+    syslog(LOG_INFO, "sensors: %d sensors found", _count);
+    return _count;
+}
+
+void SensorSet::read(void) {
+    char buffer[2048];
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < _count; i++) {
+        sensor_t *s = &_sensors[i];
+        int length = pread(s->fd, buffer, (s->type == SENSOR_MEMINFO) ? sizeof(buffer) - 1 : 63, 0);
+        s->valid = false;
+        if (length <= 0) continue;
+        buffer[length] = 0;
+        char *end_ptr = buffer;
+        switch (s->type) {
+            case SENSOR_INT:
+                s->value = strtol(buffer, &end_ptr, 10) * s->scale;
+                break;
+            case SENSOR_LOADAVG:
+                s->value = strtof(buffer, &end_ptr);
+                break;
+            case SENSOR_MEMINFO: {
+                const char *p = strstr(buffer, "MemAvailable:");
+                if (p == NULL) continue;
+                p += strlen("MemAvailable:");
+                s->value = strtol(p, &end_ptr, 10) * s->scale;
+                if (end_ptr == p) continue;
+                break;
+            }
+        }
+        if (end_ptr == buffer) continue;     // not a number
+        s->valid = true;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    uint64_t read_time = (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_nsec - start.tv_nsec) / 1000;
+    _read_time_sum_us += read_time;
+    if (read_time > _read_time_max_us) _read_time_max_us = read_time;
+    _cycles++;
+}
+
+void SensorSet::update(void) {
+    for (int i = 0; i < _count; i++) {
+        sensor_t *s = &_sensors[i];
+        if (s->tag == NULL) continue;
+        if (s->valid) {
+            s->tag->setValue(s->value, true);
+        } else {
+            s->tag->setNoreadStatus(true);
+        }
+    }
+}
+
+int SensorSet::count(void) {
+    return _count;
+}
+
+/*********************
+ * PRIVATE FUNCTIONS
+ *********************/
+
+/**
+ * Open a sensor file and add it to the set
+ */
+bool SensorSet::add(const string &name, const string &path, sensor_type_t type, float scale, const char *format) {
+    if (_count >= SENSOR_MAX) return false;
+    int fd = open((_root + path).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    sensor_t *s = &_sensors[_count++];
+    s->name = topic_name(name);
+    s->fd = fd;
+    s->type = type;
+    s->scale = scale;
+    s->format = format;
+    s->tag = NULL;
+    s->value = 0.0;
+    s->valid = false;
+    return true;
+}
+
+void SensorSet::scan_thermal(void) {
+    vector<string> zones = list_dir(_root + THERMAL_PATH, "thermal_zone");
+    for (size_t i = 0; i < zones.size(); i++) {
+        add("thermal/" + zones[i], string(THERMAL_PATH "/") + zones[i] + "/temp", SENSOR_INT, 0.001, "%.1f");
+    }
+}
+
+void SensorSet::scan_hwmon(void) {
+    vector<string> devices = list_dir(_root + HWMON_PATH, "hwmon");
+    for (size_t i = 0; i < devices.size(); i++) {
+        string dir = string(HWMON_PATH "/") + devices[i];
+        string name;
+        if (!read_text(dir + "/name", name)) name = devices[i];
+        vector<string> attrs = list_dir(_root + dir, "");
+        for (size_t a = 0; a < attrs.size(); a++) {
+            const string &attr = attrs[a];
+            size_t pos = attr.find("_input");
+            if ((pos == string::npos) || (pos + 6 != attr.length())) continue;
+            string sensor = attr.substr(0, pos);
+            // use the label if the driver provides one
+            string label;
+            if (!read_text(dir + "/" + sensor + "_label", label)) label = sensor;
+            string sensor_name = "hwmon/" + devices[i] + "_" + name + "/" + label;
+            if (attr.compare(0, 4, "temp") == 0) {
+                add(sensor_name, dir + "/" + attr, SENSOR_INT, 0.001, "%.1f");         // mDegC
+            } else if (attr.compare(0, 2, "in") == 0) {
+                add(sensor_name, dir + "/" + attr, SENSOR_INT, 0.001, "%.3f");         // mV
+            } else if (attr.compare(0, 3, "fan") == 0) {
+                add(sensor_name, dir + "/" + attr, SENSOR_INT, 1.0, "%.0f");           // rpm
+            }
+        }
+    }
+}
+
+void SensorSet::scan_cpufreq(void) {
+    vector<string> cpus = list_dir(_root + CPU_PATH, "cpu");
+    for (size_t i = 0; i < cpus.size(); i++) {
+        // only cpu0, cpu1 ... (not cpufreq, cpuidle)
+        if ((cpus[i].length() < 4) || (cpus[i][3] < '0') || (cpus[i][3] > '9')) continue;
+        add("cpu/" + cpus[i] + "/freq", string(CPU_PATH "/") + cpus[i] + "/cpufreq/scaling_cur_freq",
+            SENSOR_INT, 0.001, "%.0f");     // kHz to MHz
+    }
+}
+
+/**
+ * Read a short text file (e.g. hwmon name), trailing new line removed
+ */
+bool SensorSet::read_text(const string &path, string &text) {
+    char buffer[64];
+    int fd = open((_root + path).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    int length = ::read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (length <= 0) return false;
+    while ((length > 0) && (buffer[length - 1] == '\n')) length--;
+    buffer[length] = 0;
+    text = buffer;
+    return true;
+}
@@ -0,0 +1,98 @@
+/**
+ * @file sensors.h
+ *
+ -----------------------------------------------------------------------------
+ The SensorSet class discovers the system sensors at startup and publishes
+ each one as a data tag:
+ - thermal zones          /sys/class/thermal/thermal_zone* (DegC)
+ - hwmon inputs           /sys/class/hwmon/hwmon* temp (DegC), in (V), fan (rpm)
+ - CPU frequency          /sys/devices/system/cpu/cpu* (MHz)
+ - load average           /proc/loadavg (1 minute)
+ - available memory       /proc/meminfo (MB)
+
+ All sensor files are kept open. read() reads every sensor in a single pass
+ with pread and may be executed on a worker thread, update() then transfers
+ the values to the tags and must be executed on the main loop thread.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef SENSORS_H
+#define SENSORS_H
+
+#include <stdint.h>
+
+#include <string>
+
+#include "datatag.h"
+
+#define SENSOR_MAX 64               // the maximum number of sensors
+
+class SensorSet {
+public:
+    /**
+     * Constructor
+     * @param root: prepended to all sysfs and proc paths (for testing)
+     */
+    SensorSet(const char *root = "");
+
+    // Destructor
+    ~SensorSet();
+
+    /**
+     * Find the sensors and create a publish tag for each
+     * @param ts: tag store for the new tags
+     * @param topicBase: the tag topic is topicBase + sensor name
+     * @param publishCallback: publish callback for the new tags
+     * @returns the number of sensors found
+     */
+    int discover(TagStore *ts, const char *topicBase, void (*publishCallback) (int,Tag*));
+
+    /**
+     * Read all sensors in a single pass (can be executed on a worker thread)
+     */
+    void read(void);
+
+    /**
+     * Publish the values of the last read() to the tags (main loop thread)
+     */
+    void update(void);
+
+    /**
+     * Get the number of sensors
+     */
+    int count(void);
+
+private:
+    typedef enum {
+        SENSOR_INT = 0,             // sysfs attribute, single integer
+        SENSOR_LOADAVG,             // /proc/loadavg
+        SENSOR_MEMINFO,             // /proc/meminfo
+    } sensor_type_t;
+
+    typedef struct {
+        std::string name;
+        int fd;
+        sensor_type_t type;
+        float scale;                // applied to the integer value
+        const char *format;         // tag format
+        Tag *tag;
+        float value;                // last value read
+        bool valid;                 // last read succeeded
+    } sensor_t;
+
+    bool add(const std::string &name, const std::string &path, sensor_type_t type, float scale, const char *format);
+    void scan_thermal(void);
+    void scan_hwmon(void);
+    void scan_cpufreq(void);
+    bool read_text(const std::string &path, std::string &text);
+
+    std::string _root;
+    sensor_t _sensors[SENSOR_MAX];
+    int _count;
+    // statistics
+    unsigned long _cycles;
+    uint64_t _read_time_sum_us;
+    uint64_t _read_time_max_us;
+};
+
+#endif /* SENSORS_H */
@@ -0,0 +1,263 @@
+/**
+ * @file touch.cpp
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <syslog.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/input.h>
+
+#include "lv_drv_conf.h"
+#include "touch.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#ifndef EVDEV_NAME
+#define EVDEV_NAME "/dev/input/event0"
+#endif
+
+#define BIT_IS_SET(array, bit) ((array)[(bit) / 8] & (1 << ((bit) % 8)))
+
+/*********************
+ * MEMBER FUNCTIONS
+ *********************/
+
+TouchInput::TouchInput() {
+    _fd = -1;
+    _x = 0;
+    _y = 0;
+    _pressed = false;
+    _changed = false;
+    _dropping = false;
+    _activity = false;
+    _head = 0;
+    _count = 0;
+    memset(&_last, 0, sizeof(_last));
+    _samples = 0;
+    _kernel_dropped = 0;
+    _queue_dropped = 0;
+    _latency_sum_us = 0;
+    _latency_max_us = 0;
+}
+
+TouchInput::~TouchInput() {
+    if (_fd >= 0) {
+        close(_fd);
+        _fd = -1;
+    }
+    if (_samples > 0) {
+        syslog(LOG_INFO, "touch: %lu samples, latency avg %.1fms max %.1fms, dropped %lu (kernel) %lu (queue)",
+            _samples, _latency_sum_us / 1000.0 / _samples, _latency_max_us / 1000.0,
+            _kernel_dropped, _queue_dropped);
+    }
+}
+
+bool TouchInput::open_device(const char *path) {
+    if (path == NULL) path = EVDEV_NAME;
+    _fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (_fd < 0) {
+        syslog(LOG_ERR, "Failed to open touch input [%s]", path);
+        fprintf(stderr, "%s: Failed to open touch input [%s]\n", __func__, path);
+        return false;
+    }
+    // event timestamps on the same clock as now_us()
+    int clk = CLOCK_MONOTONIC;
+    if (ioctl(_fd, EVIOCSCLOCKID, &clk) != 0) {
+        syslog(LOG_NOTICE, "touch input: monotonic timestamps not supported");
+    }
+    return true;
+}
+
+int TouchInput::process(void) {
+    struct input_event ev[TOUCH_BATCH_SIZE];
+    int new_samples = 0;
+    if (_fd < 0) return 0;
+
+    while (true) {
+        ssize_t length = ::read(_fd, ev, sizeof(ev));
+        if (length < (ssize_t) sizeof(struct input_event)) break;
+        int n = length / sizeof(struct input_event);
+        for (int i = 0; i < n; i++) {
+            if (ev[i].type == EV_SYN) {
+                if (ev[i].code == SYN_DROPPED) {
+                    // kernel buffer overrun, events up to the next SYN_REPORT are invalid
+                    _kernel_dropped++;
+                    _dropping = true;
+                } else if (ev[i].code == SYN_REPORT) {
+                    uint64_t time_us = (uint64_t) ev[i].input_event_sec * 1000000 + ev[i].input_event_usec;
+                    if (_dropping) {
+                        // resynchronise with the device state
+                        uint8_t keys[KEY_MAX / 8 + 1];
+                        struct input_absinfo abs;
+                        memset(keys, 0, sizeof(keys));
+                        if (ioctl(_fd, EVIOCGKEY(sizeof(keys)), keys) >= 0) {
+                            _pressed = BIT_IS_SET(keys, BTN_TOUCH) || BIT_IS_SET(keys, BTN_MOUSE);
+                        }
+#if EVDEV_SWAP_AXES
+                        if (ioctl(_fd, EVIOCGABS(ABS_X), &abs) >= 0) _y = abs.value;
+                        if (ioctl(_fd, EVIOCGABS(ABS_Y), &abs) >= 0) _x = abs.value;
+#else
+                        if (ioctl(_fd, EVIOCGABS(ABS_X), &abs) >= 0) _x = abs.value;
+                        if (ioctl(_fd, EVIOCGABS(ABS_Y), &abs) >= 0) _y = abs.value;
+#endif
+                        _dropping = false;
+                        _changed = true;
+                    }
+                    if (_changed) {
+                        push_sample(time_us);
+                        new_samples++;
+                        _changed = false;
+                    }
+                }
+                continue;
+            }
+            if (_dropping) continue;
+            _activity = true;
+            _changed = true;
+            if (ev[i].type == EV_ABS) {
+                switch (ev[i].code) {
+                    case ABS_X:
+                    case ABS_MT_POSITION_X:
+#if EVDEV_SWAP_AXES
+                        _y = ev[i].value;
+#else
+                        _x = ev[i].value;
+#endif
+                        break;
+                    case ABS_Y:
+                    case ABS_MT_POSITION_Y:
+#if EVDEV_SWAP_AXES
+                        _x = ev[i].value;
+#else
+                        _y = ev[i].value;
+#endif
+                        break;
+                    default:
+                        break;
+                }
+            } else if (ev[i].type == EV_REL) {
+                if (ev[i].code == REL_X) {
+#if EVDEV_SWAP_AXES
+                    _y += ev[i].value;
+#else
+                    _x += ev[i].value;
+#endif
+                } else if (ev[i].code == REL_Y) {
+#if EVDEV_SWAP_AXES
+                    _x += ev[i].value;
+#else
+                    _y += ev[i].value;
+#endif
+                }
+            } else if (ev[i].type == EV_KEY) {
+                if ((ev[i].code == BTN_TOUCH) || (ev[i].code == BTN_MOUSE)) {
+                    if (ev[i].value == 0) {
+                        _pressed = false;
+                    } else if (ev[i].value == 1) {
+                        _pressed = true;
+                    }
+                }
+            }
+        }
+    }
+    return new_samples;
+}
+
+bool TouchInput::wait(int timeout_ms) {
+    if (_fd < 0) {
+        usleep(timeout_ms * 1000);
+        return false;
+    }
+    struct pollfd pfd;
+    pfd.fd = _fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    return (poll(&pfd, 1, timeout_ms) > 0) && (pfd.revents & POLLIN);
+}
+
+bool TouchInput::activity(void) {
+    bool retval = _activity;
+    _activity = false;
+    return retval;
+}
+
+bool TouchInput::read(lv_indev_drv_t *drv, lv_indev_data_t *data) {
+    if (_count > 0) {
+        _last = _queue[_head];
+        _head = (_head + 1) % TOUCH_QUEUE_SIZE;
+        _count--;
+        uint64_t latency = now_us() - _last.time_us;
+        _latency_sum_us += latency;
+        if (latency > _latency_max_us) {
+            _latency_max_us = latency;
+        }
+        _samples++;
+    }
+
+    lv_coord_t hor_res = lv_disp_get_hor_res(drv->disp);
+    lv_coord_t ver_res = lv_disp_get_ver_res(drv->disp);
+#if EVDEV_CALIBRATE
+    data->point.x = (_last.x - EVDEV_HOR_MIN) * hor_res / (EVDEV_HOR_MAX - EVDEV_HOR_MIN);
+    data->point.y = (_last.y - EVDEV_VER_MIN) * ver_res / (EVDEV_VER_MAX - EVDEV_VER_MIN);
+#else
+    data->point.x = _last.x;
+    data->point.y = _last.y;
+#endif
+    if (data->point.x < 0) data->point.x = 0;
+    if (data->point.y < 0) data->point.y = 0;
+    if (data->point.x >= hor_res) data->point.x = hor_res - 1;
+    if (data->point.y >= ver_res) data->point.y = ver_res - 1;
+    data->state = _last.pressed ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+
+    // LVGL calls again immediately if more samples are buffered
+    return _count > 0;
+}
+
+void TouchInput::inject(int16_t x, int16_t y, bool pressed) {
+#if EVDEV_CALIBRATE
+    // device coordinates, read() scales them back to the screen
+    lv_disp_t *disp = lv_disp_get_default();
+    x = x * (EVDEV_HOR_MAX - EVDEV_HOR_MIN) / lv_disp_get_hor_res(disp) + EVDEV_HOR_MIN;
+    y = y * (EVDEV_VER_MAX - EVDEV_VER_MIN) / lv_disp_get_ver_res(disp) + EVDEV_VER_MIN;
+#endif
+    _x = x;
+    _y = y;
+    _pressed = pressed;
+    _activity = true;
+    push_sample(now_us());
+}
+
+/*********************
+ * PRIVATE FUNCTIONS
+ *********************/
+
+void TouchInput::push_sample(uint64_t time_us) {
+    if (_count >= TOUCH_QUEUE_SIZE) {
+        // drop the oldest sample
+        _head = (_head + 1) % TOUCH_QUEUE_SIZE;
+        _count--;
+        _queue_dropped++;
+    }
+    sample_t *s = &_queue[(_head + _count) % TOUCH_QUEUE_SIZE];
+    s->x = _x;
+    s->y = _y;
+    s->pressed = _pressed;
+    s->time_us = time_us;
+    _count++;
+}
+
+uint64_t TouchInput::now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
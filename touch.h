@@ -0,0 +1,111 @@
+/**
+ * @file touch.h
+ *
+ -----------------------------------------------------------------------------
+ The TouchInput class is the only reader of the touch screen input device.
+
+ Input events are read in batches and assembled into timestamped touch
+ samples. The samples are fanned out to two consumers:
+ - the LVGL pointer input driver (read_cb) which receives every sample
+ - the activity tracker (screen saver) which only needs to know that the
+   screen was touched
+
+ Statistics (touch latency, dropped events) are logged on exit.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef TOUCH_H
+#define TOUCH_H
+
+#include <stdint.h>
+
+#include "lvgl.h"
+
+#define TOUCH_BATCH_SIZE 64         // input events read per system call
+#define TOUCH_QUEUE_SIZE 32         // samples waiting for LVGL
+
+class TouchInput {
+public:
+    // Constructor
+    TouchInput();
+
+    // Destructor
+    ~TouchInput();
+
+    /**
+     * Open the touch input device
+     * @param path: input device path, NULL for EVDEV_NAME
+     * @returns true on success
+     */
+    bool open_device(const char *path = NULL);
+
+    /**
+     * Read and decode all pending input events
+     * Must be called from the main loop before lv_task_handler
+     * @returns the number of new touch samples
+     */
+    int process(void);
+
+    /**
+     * Wait for touch input
+     * @param timeout_ms: maximum time to wait in ms
+     * @returns true if input is available
+     */
+    bool wait(int timeout_ms);
+
+    /**
+     * Check for touch activity
+     * The activity flag is cleared by this call
+     * @returns true if the screen has been touched since the last call
+     */
+    bool activity(void);
+
+    /**
+     * LVGL input driver read function
+     * @param drv: LVGL input driver
+     * @param data: storage for the pointer state
+     * @returns true if more samples are waiting
+     */
+    bool read(lv_indev_drv_t *drv, lv_indev_data_t *data);
+
+    /**
+     * Add a synthetic touch sample (scripted input)
+     * @param x: horizontal position in screen pixels
+     * @param y: vertical position in screen pixels
+     * @param pressed: true if the screen is touched
+     */
+    void inject(int16_t x, int16_t y, bool pressed);
+
+private:
+    typedef struct {
+        int16_t x;
+        int16_t y;
+        bool pressed;
+        uint64_t time_us;           // kernel timestamp (CLOCK_MONOTONIC)
+    } sample_t;
+
+    void push_sample(uint64_t time_us);
+    uint64_t now_us(void);
+
+    int _fd;
+    // current device state, updated by events until SYN_REPORT
+    int _x;
+    int _y;
+    bool _pressed;
+    bool _changed;                  // state changed since the last SYN_REPORT
+    bool _dropping;                 // discard events until next SYN_REPORT
+    bool _activity;                 // touched since last call to activity()
+    // samples waiting for LVGL
+    sample_t _queue[TOUCH_QUEUE_SIZE];
+    int _head;
+    int _count;
+    sample_t _last;                 // last sample delivered to LVGL
+    // statistics
+    unsigned long _samples;         // samples delivered to LVGL
+    unsigned long _kernel_dropped;  // SYN_DROPPED reports (kernel buffer overrun)
+    unsigned long _queue_dropped;   // samples lost to queue overflow
+    uint64_t _latency_sum_us;       // kernel timestamp to LVGL read
+    uint64_t _latency_max_us;
+};
+
+#endif /* TOUCH_H */
@@ -0,0 +1,115 @@
+/**
+ * @file worker.cpp
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <syslog.h>
+
+#include "worker.h"
+
+using namespace std;
+
+/*********************
+ * MEMBER FUNCTIONS
+ *********************/
+
+WorkerPool::WorkerPool() {
+    _pending = 0;
+    _stop = false;
+}
+
+WorkerPool::~WorkerPool() {
+    stop();
+}
+
+bool WorkerPool::start(int threads) {
+    if (!_threads.empty()) return false;
+    _stop = false;
+    try {
+        for (int i = 0; i < threads; i++) {
+            _threads.push_back(thread(&WorkerPool::worker_thread, this));
+        }
+    } catch (const system_error &e) {
+        syslog(LOG_ERR, "Failed to start worker thread: %s", e.what());
+        fprintf(stderr, "%s: Failed to start worker thread: %s\n", __func__, e.what());
+        stop();
+        return false;
+    }
+    return true;
+}
+
+void WorkerPool::stop(void) {
+    {
+        lock_guard<mutex> lock(_jobs_mutex);
+        _stop = true;
+    }
+    _jobs_cv.notify_all();
+    for (size_t i = 0; i < _threads.size(); i++) {
+        if (_threads[i].joinable()) {
+            _threads[i].join();
+        }
+    }
+    _threads.clear();
+}
+
+bool WorkerPool::post(void (*work) (void*), void (*done) (void*), void *arg) {
+    if (work == NULL) return false;
+    {
+        lock_guard<mutex> lock(_jobs_mutex);
+        if (_stop || _threads.empty()) return false;
+        _jobs.push_back({ work, done, arg });
+        _pending++;
+    }
+    _jobs_cv.notify_one();
+    return true;
+}
+
+int WorkerPool::process_completions(void) {
+    deque<job_t> completed;
+    {
+        lock_guard<mutex> lock(_completed_mutex);
+        if (_completed.empty()) return 0;
+        completed.swap(_completed);
+    }
+    // run the callbacks without holding the lock, they may post new jobs
+    int count = 0;
+    for (size_t i = 0; i < completed.size(); i++) {
+        (*completed[i].done) (completed[i].arg);
+        count++;
+    }
+    return count;
+}
+
+int WorkerPool::pending(void) {
+    lock_guard<mutex> lock(_jobs_mutex);
+    return _pending;
+}
+
+/*********************
+ * PRIVATE FUNCTIONS
+ *********************/
+
+void WorkerPool::worker_thread(void) {
+    job_t job;
+    while (true) {
+        {
+            unique_lock<mutex> lock(_jobs_mutex);
+            _jobs_cv.wait(lock, [this] { return _stop || !_jobs.empty(); });
+            // drain the queue before exiting
+            if (_jobs.empty()) return;
+            job = _jobs.front();
+            _jobs.pop_front();
+        }
+        (*job.work) (job.arg);
+        if (job.done != NULL) {
+            lock_guard<mutex> lock(_completed_mutex);
+            _completed.push_back(job);
+        }
+        lock_guard<mutex> lock(_jobs_mutex);
+        _pending--;
+    }
+}
@@ -0,0 +1,87 @@
+/**
+ * @file worker.h
+ *
+ -----------------------------------------------------------------------------
+ The WorkerPool class runs blocking jobs (system calls, process spawning,
+ sysfs access) on background threads so they can not stall the UI thread.
+
+ A job consists of a "work" function which is executed on a worker thread
+ and an optional "done" function which is executed on the main loop thread
+ when process_completions() is called. Only the "done" function may touch
+ LVGL objects or data tags.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef WORKER_H
+#define WORKER_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define WORKER_THREADS 2            // default number of worker threads
+
+class WorkerPool {
+public:
+    // Constructor
+    WorkerPool();
+
+    // Destructor
+    ~WorkerPool();
+
+    /**
+     * Start the worker threads
+     * @param threads: number of worker threads
+     * @returns true on success
+     */
+    bool start(int threads = WORKER_THREADS);
+
+    /**
+     * Stop the worker threads
+     * Jobs which are already queued are completed before the threads exit
+     */
+    void stop(void);
+
+    /**
+     * Queue a job for execution on a worker thread
+     * @param work: function executed on the worker thread
+     * @param done: function executed on the main loop thread (can be NULL)
+     * @param arg: argument passed to both functions
+     * @returns true if the job was queued
+     */
+    bool post(void (*work) (void*), void (*done) (void*), void *arg);
+
+    /**
+     * Execute the "done" functions of all completed jobs
+     * Must be called from the main loop thread
+     * @returns the number of completions processed
+     */
+    int process_completions(void);
+
+    /**
+     * Get the number of jobs which have been queued but not completed
+     */
+    int pending(void);
+
+private:
+    typedef struct {
+        void (*work) (void*);
+        void (*done) (void*);
+        void *arg;
+    } job_t;
+
+    void worker_thread(void);
+
+    std::vector<std::thread> _threads;
+    std::deque<job_t> _jobs;            // waiting for a worker thread
+    std::deque<job_t> _completed;       // waiting for the main loop
+    std::mutex _jobs_mutex;
+    std::mutex _completed_mutex;
+    std::condition_variable _jobs_cv;
+    int _pending;                       // queued + running, protected by _jobs_mutex
+    bool _stop;
+};
+
+#endif /* WORKER_H */